@@ -0,0 +1,295 @@
+#ifndef FP16_ADDER_H
+#define FP16_ADDER_H
+
+#include "fp16_common.h"
+#include "fp16_path_cov.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Bit-True Function: Hardware Logic Emulation (Truncation based)
+// ----------------------------------------------------------------------------
+// This mimics the Verilog behavior (Truncation / Round towards Zero)
+//
+// DENORM selects the denormal policy (FP16_DENORM_*). FP16_DENORM_IEEE is the
+// full model; DAZ and FTZ compile out the denormal decode and pack branches
+// of the cheaper MAC variant.
+template <unsigned DENORM>
+inline BitTrueResult fp16_add_bittrue_policy(fp16_t n1, fp16_t n2) {
+    BitTrueResult ret = {0, false, false, false, false, false};
+    FP16_PATH_HIT(FP16_PATH_ADD_CALLS);
+
+    // 1. Decode inputs
+    uint16_t s1 = (n1 >> 15) & 1;
+    uint16_t e1 = (n1 >> 10) & 0x1F;
+    uint16_t f1 = n1 & 0x3FF;
+
+    uint16_t s2 = (n2 >> 15) & 1;
+    uint16_t e2 = (n2 >> 10) & 0x1F;
+    uint16_t f2 = n2 & 0x3FF;
+
+    if constexpr ((DENORM & FP16_DENORM_DAZ) != 0) {
+        if (e1 == 0) f1 = 0;
+        if (e2 == 0) f2 = 0;
+    }
+
+    // 2. Check Special Values
+    bool n1_is_inf = (e1 == 31) && (f1 == 0);
+    bool n2_is_inf = (e2 == 31) && (f2 == 0);
+    bool n1_is_nan = (e1 == 31) && (f1 != 0);
+    bool n2_is_nan = (e2 == 31) && (f2 != 0);
+
+    // NaN Handling
+    if (n1_is_nan || n2_is_nan || (n1_is_inf && n2_is_inf && (s1 != s2))) {
+        FP16_PATH_HIT(FP16_PATH_ADD_NAN);
+        ret.res = 0x7FFF; ret.nan = true; return ret;
+    }
+
+    // Infinity Handling
+    if (n1_is_inf || n2_is_inf) {
+        FP16_PATH_HIT(FP16_PATH_ADD_INF);
+        ret.overflow = true;
+        if (n1_is_inf) ret.res = n1; else ret.res = n2;
+        return ret;
+    }
+
+    // 3. Align (Big/Small) - Treat denormal exp as 1 for diff calc
+    int32_t exp1, exp2;
+    uint32_t mant1, mant2;
+    if constexpr ((DENORM & FP16_DENORM_DAZ) != 0) {
+        // DAZ: every non-zero operand is normal. x + 0 = x; 0 + 0 is -0
+        // only when both are -0.
+        if (e1 == 0 || e2 == 0) {
+            if (e1 == 0 && e2 == 0) ret.res = (fp16_t)((s1 & s2) << 15);
+            else ret.res = (e1 == 0) ? n2 : n1;
+            ret.zero = (ret.res & 0x7FFF) == 0;
+            return ret;
+        }
+        exp1 = e1; exp2 = e2;
+        mant1 = f1 | 1024; mant2 = f2 | 1024;
+    } else {
+        exp1 = (e1 == 0) ? 1 : e1;
+        exp2 = (e2 == 0) ? 1 : e2;
+
+        // Add hidden bit
+        mant1 = (e1 == 0) ? f1 : (f1 | 1024);
+        mant2 = (e2 == 0) ? f2 : (f2 | 1024);
+    }
+
+    bool swap = false;
+    if (exp1 < exp2) swap = true;
+    else if (exp1 == exp2 && mant1 < mant2) swap = true;
+
+    uint16_t sign_big = swap ? s2 : s1;
+    int32_t  exp_big  = swap ? exp2 : exp1;
+    uint32_t mant_big = swap ? mant2 : mant1;
+
+    uint16_t sign_sml = swap ? s1 : s2;
+    int32_t  exp_sml  = swap ? exp1 : exp2;
+    uint32_t mant_sml = swap ? mant1 : mant2;
+
+    int32_t exp_diff = exp_big - exp_sml;
+
+    // 4. Shift Small Mantissa
+    uint32_t mant_sml_shifted = 0;
+    uint32_t bits_lost = 0; // "Precision Lost" tracking
+
+    if (exp_diff >= 11 + 2) {
+        FP16_PATH_HIT(FP16_PATH_ADD_EXP_DIFF_GE13);
+        mant_sml_shifted = 0;
+        bits_lost = (mant_sml != 0);
+    } else {
+        mant_sml_shifted = mant_sml >> exp_diff;
+        uint32_t mask = (1 << exp_diff) - 1;
+        bits_lost = (mant_sml & mask);
+    }
+
+    // 5. Add/Sub
+    int32_t mant_res_signed;
+    if (sign_big == sign_sml) {
+        FP16_PATH_HIT(FP16_PATH_ADD_SAME_SIGN);
+        mant_res_signed = mant_big + mant_sml_shifted;
+    } else {
+        FP16_PATH_HIT(FP16_PATH_ADD_DIFF_SIGN);
+        mant_res_signed = mant_big - mant_sml_shifted;
+    }
+
+    // 6. Normalize
+    int32_t final_exp = exp_big;
+    uint32_t final_mant = mant_res_signed;
+
+    if (final_mant == 0) {
+        FP16_PATH_HIT(FP16_PATH_ADD_ZERO_RESULT);
+        ret.res = 0;
+        if (sign_big == sign_sml && sign_big == 1) ret.res = 0x8000; // -0
+        ret.zero = true;
+        if (bits_lost) ret.precision_lost = true;
+        return ret;
+    }
+
+    // Renormalize
+    if (final_mant >= 2048) { // Overflow
+        FP16_PATH_HIT(FP16_PATH_ADD_CARRY_RENORM);
+        if (final_mant & 1) bits_lost = 1; // Accumulate lost
+        final_mant >>= 1;
+        final_exp++;
+    } else if constexpr ((DENORM & FP16_DENORM_FTZ) != 0) { // Normalize, flush below 2^-14
+        while (final_mant < 1024) {
+             final_mant <<= 1;
+             final_exp--;
+        }
+        if (final_exp < 1) {
+            ret.res = (fp16_t)(sign_big << 15);
+            ret.zero = true;
+            ret.precision_lost = true;
+            return ret;
+        }
+    } else { // Normalize (for subtraction)
+        int norm_shifts = 0;
+        while (final_mant < 1024 && final_exp > 1) {
+             final_mant <<= 1;
+             final_exp--;
+             norm_shifts++;
+        }
+        FP16_PATH_HIT(FP16_PATH_ADD_NORM_SHIFT_0 + norm_shifts);
+        (void)norm_shifts;
+        if (final_mant < 1024 && final_exp == 1) { // Denormal
+            FP16_PATH_HIT(FP16_PATH_ADD_DENORMAL_PACK);
+            final_exp = 0;
+        }
+    }
+
+    // 7. Precision Lost Flag
+    if (bits_lost) {
+        FP16_PATH_HIT(FP16_PATH_ADD_PRECISION_LOST);
+        ret.precision_lost = true;
+    }
+
+    // 8. Pack Result
+    if (final_exp >= 31) {
+        FP16_PATH_HIT(FP16_PATH_ADD_OVERFLOW_PACK);
+        ret.overflow = true;
+        ret.res = (sign_big << 15) | 0x7C00; // Inf
+    } else {
+        ret.res = (sign_big << 15) | (final_exp << 10) | (final_mant & 0x3FF);
+    }
+
+    if ((ret.res & 0x7FFF) == 0) ret.zero = true;
+
+    return ret;
+}
+
+inline BitTrueResult fp16_add_bittrue(fp16_t n1, fp16_t n2) {
+    return fp16_add_bittrue_policy<FP16_DENORM_IEEE>(n1, n2);
+}
+
+// ----------------------------------------------------------------------------
+// Batch Kernels
+// ----------------------------------------------------------------------------
+// Scalar loop over fp16_add_bittrue, results split into res[] / flags[].
+inline void fp16_add_batch(const fp16_t* a, const fp16_t* b,
+                           fp16_t* res, uint8_t* flags, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_ADD_BATCH, n);
+    for (size_t i = 0; i < n; ++i) {
+        BitTrueResult r = fp16_add_bittrue(a[i], b[i]);
+        res[i] = r.res;
+        flags[i] = pack_flags(r);
+    }
+}
+
+// Batch form of fp16_add_bittrue_policy (denormal policy variants).
+template <unsigned DENORM>
+inline void fp16_add_batch_policy(const fp16_t* a, const fp16_t* b, fp16_t* res, uint8_t* flags, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_ADD_BATCH, n);
+    for (size_t i = 0; i < n; ++i) {
+        BitTrueResult r = fp16_add_bittrue_policy<DENORM>(a[i], b[i]);
+        res[i] = r.res;
+        flags[i] = pack_flags(r);
+    }
+}
+
+// Branch-free form of fp16_add_bittrue for auto-vectorization. Every early
+// return becomes a select and the normalize loop becomes a single shift by
+// min(leading zeros, exp_big - 1).
+inline void fp16_add_simd(const fp16_t* __restrict a, const fp16_t* __restrict b,
+                          fp16_t* __restrict res, uint8_t* __restrict flags, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_ADD_SIMD, n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t n1 = a[i], n2 = b[i];
+        uint32_t s1 = n1 >> 15, e1 = (n1 >> 10) & 0x1F, f1 = n1 & 0x3FF;
+        uint32_t s2 = n2 >> 15, e2 = (n2 >> 10) & 0x1F, f2 = n2 & 0x3FF;
+
+        uint32_t n1_is_inf = (e1 == 31) & (f1 == 0);
+        uint32_t n2_is_inf = (e2 == 31) & (f2 == 0);
+        uint32_t is_nan = ((e1 == 31) & (f1 != 0)) | ((e2 == 31) & (f2 != 0)) |
+                          (n1_is_inf & n2_is_inf & (s1 ^ s2));
+        uint32_t is_inf = n1_is_inf | n2_is_inf;
+
+        // Big/small by comparing {exp, mant} as one key
+        uint32_t key1 = ((e1 | (e1 == 0)) << 11) | f1 | ((e1 != 0) << 10);
+        uint32_t key2 = ((e2 | (e2 == 0)) << 11) | f2 | ((e2 != 0) << 10);
+        uint32_t swap = key1 < key2;
+        uint32_t key_big = fp16_sel(swap, key2, key1);
+        uint32_t key_sml = fp16_sel(swap, key1, key2);
+
+        uint32_t sign_big = fp16_sel(swap, s2, s1);
+        uint32_t exp_big  = key_big >> 11;
+        uint32_t mant_big = key_big & 0x7FF;
+        uint32_t mant_sml = key_sml & 0x7FF;
+
+        // mant_sml < 2^11, so the exp_diff >= 13 case needs no special path
+        uint32_t exp_diff  = exp_big - (key_sml >> 11);
+        uint32_t shifted   = mant_sml >> exp_diff;
+        uint32_t bits_lost = (mant_sml & ((1u << exp_diff) - 1)) != 0;
+
+        uint32_t same = s1 == s2;
+        uint32_t sum  = fp16_sel(same, mant_big + shifted, mant_big - shifted);
+
+        // Carry: shift right by one
+        uint32_t carry = sum >= 2048;
+        bits_lost |= carry & sum;
+
+        // Borrow: shift left by min(lz, exp_big - 1), lz of the 11-bit sum
+        // found with a four-step binary search on a 16-bit window
+        uint32_t x  = sum << 5;
+        uint32_t lz = 0;
+        uint32_t c;
+        c = x < 0x0100; lz += c << 3; x = fp16_sel(c, x << 8, x);
+        c = x < 0x1000; lz += c << 2; x = fp16_sel(c, x << 4, x);
+        c = x < 0x4000; lz += c << 1; x = fp16_sel(c, x << 2, x);
+        c = x < 0x8000; lz += c;
+        uint32_t lim = exp_big - 1;
+        uint32_t lsh = fp16_sel(carry, 0, fp16_sel(lz < lim, lz, lim));
+
+        uint32_t mant = fp16_sel(carry, sum >> 1, sum << lsh);
+        uint32_t exp  = fp16_sel(carry, exp_big + 1, exp_big - lsh);
+        exp = fp16_sel(mant < 1024, 0, exp);
+
+        uint32_t zero_sum = sum == 0;
+        uint32_t of = (exp >= 31) & !zero_sum;
+        uint32_t r  = fp16_sel(of, (sign_big << 15) | 0x7C00,
+                               (sign_big << 15) | (exp << 10) | (mant & 0x3FF));
+        r = fp16_sel(zero_sum, (same & sign_big) << 15, r);
+
+        uint32_t fl = fp16_sel(of, FP16_FLAG_OF, 0) |
+                      fp16_sel((r & 0x7FFF) == 0, FP16_FLAG_Z, 0) |
+                      fp16_sel(bits_lost, FP16_FLAG_PL, 0);
+
+        r  = fp16_sel(is_inf, fp16_sel(n1_is_inf, n1, n2), r);
+        fl = fp16_sel(is_inf, FP16_FLAG_OF, fl);
+        r  = fp16_sel(is_nan, 0x7FFF, r);
+        fl = fp16_sel(is_nan, FP16_FLAG_NAN, fl);
+
+        res[i]   = (fp16_t)r;
+        flags[i] = (uint8_t)fl;
+    }
+}
+
+// fp16_add_simd over [0, n) in FP16_POOL_GRAIN slices on a work-stealing pool.
+inline void fp16_add_parallel(Fp16Pool& pool, const fp16_t* a, const fp16_t* b,
+                              fp16_t* res, uint8_t* flags, size_t n) {
+    pool.parallel_for(0, n, FP16_POOL_GRAIN, [&](uint64_t lo, uint64_t hi, unsigned) {
+        fp16_add_simd(a + lo, b + lo, res + lo, flags + lo, (size_t)(hi - lo));
+    });
+}
+
+#endif // FP16_ADDER_H
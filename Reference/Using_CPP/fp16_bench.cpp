@@ -0,0 +1,257 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <memory>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_oracle.h"
+#include "fp16_perf.h"
+#include "fp16_rng.h"
+#include "fp16_sr.h"
+#include "fp16_stimulus.h"
+
+// ----------------------------------------------------------------------------
+// Micro-benchmark for the reference kernels
+// ----------------------------------------------------------------------------
+// Usage: fp16_bench [--n N] [--min-time SEC] [--filter SUBSTR] [--json FILE] [--threads T]
+//
+// Every kernel (add, mul, to_float, to_fp16) is timed in these forms:
+//   scalar   : one call per element, returning a BitTrueResult / value
+//   batch    : fp16_*_batch (scalar loop writing res[] / flags[])
+//   simd     : fp16_*_simd  (branch-free, auto-vectorized)
+//   parallel : fp16_*_parallel (simd on the fp16_pool.h pool, --threads
+//              workers; add and mul only)
+//   oracle   : fp16_oracle_*_simd<RNE>, the exact reference (add and mul)
+//   sr       : fp16_*_sr_batch, stochastic rounding including the random
+//              words from Fp16RngLanes (add and mul; compare with simd)
+// over each input distribution. The stimulus generator (fp16_stimulus.h)
+// is timed once per preset and the operand-pair generators (mt19937 with
+// uniform_int_distribution, scalar xoshiro256++, Fp16RngLanes) once each;
+// an op is one (a, b) pair. cycles/op is based on the time-stamp
+// counter (reference cycles), 0 where it is not available. Build with
+// -DFP16_PERF to add a per-kernel hardware counter report (fp16_perf.h).
+
+static uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// Input Distributions
+// ----------------------------------------------------------------------------
+static fp16_t make_fp16(uint32_t s, uint32_t e, uint32_t f) {
+    return (fp16_t)((s << 15) | (e << 10) | (f & 0x3FF));
+}
+
+static void gen_inputs(const std::string& dist, std::vector<fp16_t>& a,
+                       std::vector<fp16_t>& b, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    size_t n = a.size();
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t r = gen();
+        uint32_t s1 = r & 1, s2 = (r >> 1) & 1;
+        uint32_t f1 = (r >> 2) & 0x3FF, f2 = (r >> 12) & 0x3FF;
+        uint32_t e1 = 1 + (uint32_t)((r >> 22) % 30), e2 = 1 + (uint32_t)((r >> 32) % 30);
+        uint32_t sel = (r >> 40) & 0xFF;
+
+        if (dist == "uniform") {
+            a[i] = (fp16_t)r; b[i] = (fp16_t)(r >> 16);
+        } else if (dist == "normal") { // finite, non-zero normals only
+            a[i] = make_fp16(s1, e1, f1); b[i] = make_fp16(s2, e2, f2);
+        } else if (dist == "denormal") { // ~75% of operands are subnormal
+            a[i] = make_fp16(s1, (sel & 3) ? 0 : e1, f1 | 1);
+            b[i] = make_fp16(s2, (sel & 12) ? 0 : (e2 % 3), f2 | 1);
+        } else if (dist == "cancel") { // opposite signs, near-equal magnitude
+            a[i] = make_fp16(s1, e1, f1);
+            uint32_t df = (sel & 15);
+            b[i] = make_fp16(!s1, e1, (f1 ^ df));
+        } else { // "special": zeros, infinities, NaNs, max/min mixed with normals
+            static const fp16_t specials[8] = {
+                0x0000, 0x8000, 0x7C00, 0xFC00, 0x7E00, 0x7BFF, 0x0400, 0x0001
+            };
+            a[i] = (sel & 1) ? specials[(sel >> 1) & 7] : make_fp16(s1, e1, f1);
+            b[i] = (sel & 16) ? specials[(sel >> 5) & 7] : make_fp16(s2, e2, f2);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Timing
+// ----------------------------------------------------------------------------
+struct BenchResult {
+    std::string kernel, variant, dist;
+    double ns_per_op, ops_per_s, cycles_per_op;
+};
+
+// Runs fn (which processes n elements) until min_time has elapsed and
+// reports the fastest repetition.
+static BenchResult time_kernel(const std::function<void()>& fn, size_t n, double min_time) {
+    fn(); // warm-up
+    double best_ns = 1e300, best_cyc = 1e300, total = 0;
+    int reps = 0;
+    while (total < min_time || reps < 3) {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = read_cycles();
+        fn();
+        uint64_t c1 = read_cycles();
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (ns < best_ns) { best_ns = ns; best_cyc = (double)(c1 - c0); }
+        total += ns * 1e-9;
+        ++reps;
+    }
+    BenchResult r;
+    r.ns_per_op = best_ns / n;
+    r.ops_per_s = 1e9 / r.ns_per_op;
+    r.cycles_per_op = best_cyc / n;
+    return r;
+}
+
+static void write_json(const std::string& path, const std::vector<BenchResult>& results, size_t n) {
+    std::ofstream out(path);
+    out << "{\n  \"n\": " << n << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    {\"kernel\": \"" << r.kernel << "\", \"variant\": \"" << r.variant
+            << "\", \"dist\": \"" << r.dist << "\", \"ns_per_op\": " << r.ns_per_op
+            << ", \"ops_per_s\": " << r.ops_per_s << ", \"cycles_per_op\": " << r.cycles_per_op
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// ----------------------------------------------------------------------------
+// Main: Benchmark
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    size_t n = 1 << 16;
+    double min_time = 0.2;
+    unsigned threads = 0; // hardware_concurrency
+    std::string filter, json_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--n" && i + 1 < argc) n = std::stoull(argv[++i]);
+        else if (arg == "--min-time" && i + 1 < argc) min_time = std::stod(argv[++i]);
+        else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) json_path = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--n N] [--min-time SEC] [--filter SUBSTR] [--json FILE] [--threads T]\n";
+            return 1;
+        }
+    }
+    if (n == 0) {
+        std::cerr << "--n must be positive\n";
+        return 1;
+    }
+
+    std::vector<fp16_t> a(n), b(n), res(n);
+    std::vector<uint8_t> flags(n);
+    std::vector<float> fin(n), fout(n);
+    volatile uint32_t sink = 0;
+    Fp16Pool pool(threads);
+
+    const char* dists[] = {"uniform", "normal", "denormal", "cancel", "special"};
+    std::vector<BenchResult> results;
+
+    std::cout << "--------------------------------------------------------------------------------\n";
+    std::cout << " FP16 Reference Kernel Benchmark (n = " << n << ")\n";
+    std::cout << "--------------------------------------------------------------------------------\n";
+    std::cout << "  Kernel    | Variant  | Dist     ||    ns/op |       Mops/s | cycles/op\n";
+    std::cout << "--------------------------------------------------------------------------------\n";
+
+    Fp16RngLanes sr_rng(0x5EED);
+
+    for (const char* dist : dists) {
+        gen_inputs(dist, a, b, 0x5EED);
+        for (size_t i = 0; i < n; ++i) fin[i] = fp16_to_float(a[i]) + fp16_to_float(b[i]);
+
+        struct Case { const char* kernel; const char* variant; std::function<void()> fn; };
+        std::vector<Case> cases = {
+            {"add", "scalar", [&] {
+                uint32_t acc = 0;
+                for (size_t i = 0; i < n; ++i) acc += fp16_add_bittrue(a[i], b[i]).res;
+                sink = sink + acc; }},
+            {"add", "batch", [&] { fp16_add_batch(a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"add", "simd",  [&] { fp16_add_simd(a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"add", "parallel", [&] { fp16_add_parallel(pool, a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"add", "oracle", [&] { fp16_oracle_add_simd<FP16_ROUND_RNE>(a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"add", "sr", [&] { fp16_add_sr_batch(sr_rng, a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"mul", "scalar", [&] {
+                uint32_t acc = 0;
+                for (size_t i = 0; i < n; ++i) acc += fp16_mul_bittrue(a[i], b[i]).res;
+                sink = sink + acc; }},
+            {"mul", "batch", [&] { fp16_mul_batch(a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"mul", "simd",  [&] { fp16_mul_simd(a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"mul", "parallel", [&] { fp16_mul_parallel(pool, a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"mul", "oracle", [&] { fp16_oracle_mul_simd<FP16_ROUND_RNE>(a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"mul", "sr", [&] { fp16_mul_sr_batch(sr_rng, a.data(), b.data(), res.data(), flags.data(), n); }},
+            {"to_float", "scalar", [&] {
+                float acc = 0;
+                for (size_t i = 0; i < n; ++i) acc += fp16_to_float(a[i]);
+                sink = sink + (uint32_t)(acc != 0); }},
+            {"to_float", "batch", [&] { fp16_to_float_batch(a.data(), fout.data(), n); }},
+            {"to_float", "simd",  [&] { fp16_to_float_simd(a.data(), fout.data(), n); }},
+            {"to_fp16", "scalar", [&] {
+                uint32_t acc = 0;
+                for (size_t i = 0; i < n; ++i) acc += float_to_fp16(fin[i]);
+                sink = sink + acc; }},
+            {"to_fp16", "batch", [&] { float_to_fp16_batch(fin.data(), res.data(), n); }},
+            {"to_fp16", "simd",  [&] { float_to_fp16_simd(fin.data(), res.data(), n); }},
+        };
+        if (std::string(dist) == "uniform") { // the generator ignores dist
+            for (const char* preset : {"uniform", "add", "mul", "mixed"}) {
+                auto stim = std::make_shared<Fp16Stimulus>(0x5EED, fp16_stim_weights(preset));
+                cases.push_back({"stim", preset, [&, stim] { stim->fill(a.data(), b.data(), n); }});
+            }
+            auto mt = std::make_shared<std::mt19937>(0x5EED);
+            auto xo = std::make_shared<Xoshiro256>(0x5EED);
+            auto lanes = std::make_shared<Fp16RngLanes>(0x5EED);
+            cases.push_back({"rng", "mt19937", [&, mt] {
+                std::uniform_int_distribution<> dis(0, 0xFFFF);
+                for (size_t i = 0; i < n; ++i) { a[i] = (fp16_t)dis(*mt); b[i] = (fp16_t)dis(*mt); } }});
+            cases.push_back({"rng", "xoshiro", [&, xo] {
+                for (size_t i = 0; i < n; ++i) { uint64_t r = xo->next(); a[i] = (fp16_t)r; b[i] = (fp16_t)(r >> 16); } }});
+            cases.push_back({"rng", "lanes", [&, lanes] { lanes->fill_pairs(a.data(), b.data(), n); }});
+        }
+
+        for (const Case& c : cases) {
+            std::string name = std::string(c.kernel) + "/" + c.variant + "/" + dist;
+            if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+            BenchResult r = time_kernel(c.fn, n, min_time);
+            r.kernel = c.kernel; r.variant = c.variant; r.dist = dist;
+            results.push_back(r);
+
+            std::cout << "  " << std::left << std::setw(9) << c.kernel << " | "
+                      << std::setw(8) << c.variant << " | " << std::setw(8) << dist << " || "
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(8) << r.ns_per_op
+                      << " | " << std::setw(12) << r.ops_per_s * 1e-6
+                      << " | " << std::setw(9) << r.cycles_per_op << "\n";
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------------\n";
+
+    if (!json_path.empty()) {
+        write_json(json_path, results, n);
+        std::cout << "Results written to " << json_path << "\n";
+    }
+    fp16_perf_report(std::cout);
+    return 0;
+}
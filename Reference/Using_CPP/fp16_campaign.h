@@ -0,0 +1,156 @@
+#ifndef FP16_CAMPAIGN_H
+#define FP16_CAMPAIGN_H
+
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+
+// ----------------------------------------------------------------------------
+// Random Campaign: Bit-True (HW) vs TLM (Exact Oracle, RZ)
+// ----------------------------------------------------------------------------
+// Runs `vectors` uniform random operand pairs through the SIMD bit-true
+// kernel and the vectorized RZ oracle of fp16_oracle.h, counting rounding
+// differences and real mismatches separately (NaN == NaN). The work is cut
+// into fixed chunks of FP16_CAMPAIGN_CHUNK pairs; chunk c is generated from
+// fp16_rng_chunk_seed(seed, c) and the first mismatch is the one with the
+// lowest global index, so results are bit-identical for any thread count
+// and any stealing order.
+
+enum { FP16_CAMPAIGN_CHUNK = 1 << 16 };
+
+enum Fp16CampaignOp { FP16_CAMPAIGN_ADD, FP16_CAMPAIGN_MUL };
+
+struct Fp16CampaignResult {
+    uint64_t vectors = 0;
+    uint64_t mismatches = 0;
+    uint64_t rounding = 0; // HW == the other rounded neighbour of the exact value
+    uint64_t flag_count[5] = {0, 0, 0, 0, 0}; // OF, Z, NaN, PL, UF
+    // First mismatch (lowest index); valid when mismatches != 0.
+    uint64_t first_index = 0;
+    fp16_t first_a = 0, first_b = 0, first_hw = 0, first_tlm = 0;
+
+    void merge(const Fp16CampaignResult& o) {
+        vectors += o.vectors;
+        rounding += o.rounding;
+        for (int k = 0; k < 5; ++k) flag_count[k] += o.flag_count[k];
+        if (o.mismatches && (!mismatches || o.first_index < first_index)) {
+            first_index = o.first_index;
+            first_a = o.first_a; first_b = o.first_b;
+            first_hw = o.first_hw; first_tlm = o.first_tlm;
+        }
+        mismatches += o.mismatches;
+    }
+};
+
+// Per-worker scratch, allocated once per campaign.
+struct Fp16CampaignBuffers {
+    std::vector<fp16_t> a, b, hw, tlm;
+    std::vector<uint8_t> flags, tlm_flags;
+
+    Fp16CampaignBuffers()
+        : a(FP16_CAMPAIGN_CHUNK), b(FP16_CAMPAIGN_CHUNK), hw(FP16_CAMPAIGN_CHUNK), tlm(FP16_CAMPAIGN_CHUNK),
+          flags(FP16_CAMPAIGN_CHUNK), tlm_flags(FP16_CAMPAIGN_CHUNK) {}
+};
+
+// One chunk of n <= FP16_CAMPAIGN_CHUNK vectors.
+inline void fp16_campaign_chunk(Fp16CampaignOp op, uint64_t seed, uint64_t chunk, size_t n,
+                                Fp16CampaignBuffers& buf, Fp16CampaignResult& r) {
+    fp16_t* a = buf.a.data(); fp16_t* b = buf.b.data();
+    fp16_t* hw = buf.hw.data(); fp16_t* tlm = buf.tlm.data();
+    uint8_t* flags = buf.flags.data(); uint8_t* tlm_flags = buf.tlm_flags.data();
+
+    Fp16RngLanes rng(fp16_rng_chunk_seed(seed, chunk));
+    rng.fill_pairs(a, b, n);
+
+    if (op == FP16_CAMPAIGN_ADD) {
+        fp16_add_simd(a, b, hw, flags, n);
+        fp16_oracle_add_simd<FP16_ROUND_RZ>(a, b, tlm, tlm_flags, n);
+    } else {
+        fp16_mul_simd(a, b, hw, flags, n);
+        fp16_oracle_mul_simd<FP16_ROUND_RZ>(a, b, tlm, tlm_flags, n);
+    }
+
+    r.vectors += n;
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t f = flags[i];
+        r.flag_count[0] += (f & FP16_FLAG_OF) != 0;
+        r.flag_count[1] += (f & FP16_FLAG_Z) != 0;
+        r.flag_count[2] += (f & FP16_FLAG_NAN) != 0;
+        r.flag_count[3] += (f & FP16_FLAG_PL) != 0;
+        r.flag_count[4] += (f & FP16_FLAG_UF) != 0;
+        if (hw[i] == tlm[i]) continue;
+        Fp16Verdict v = fp16_oracle_classify(hw[i], f, tlm[i], tlm_flags[i], tlm[i], tlm_flags[i]);
+        if (v == FP16_VERDICT_MATCH) continue;
+        if (v == FP16_VERDICT_ROUNDING) { r.rounding++; continue; }
+        if (r.mismatches++ == 0) {
+            r.first_index = chunk * FP16_CAMPAIGN_CHUNK + i;
+            r.first_a = a[i]; r.first_b = b[i];
+            r.first_hw = hw[i]; r.first_tlm = tlm[i];
+        }
+    }
+}
+
+// Chunks are scheduled one at a time on the work-stealing pool; every worker
+// keeps its own scratch buffers and partial result.
+inline Fp16CampaignResult fp16_campaign(Fp16Pool& pool, Fp16CampaignOp op, uint64_t seed,
+                                        uint64_t vectors) {
+    uint64_t chunks = (vectors + FP16_CAMPAIGN_CHUNK - 1) / FP16_CAMPAIGN_CHUNK;
+    std::vector<std::unique_ptr<Fp16CampaignBuffers>> buf(pool.size());
+    std::vector<Fp16CampaignResult> part(pool.size());
+
+    pool.parallel_for(0, chunks, 1, [&](uint64_t lo, uint64_t hi, unsigned w) {
+        if (!buf[w]) buf[w].reset(new Fp16CampaignBuffers());
+        for (uint64_t c = lo; c < hi; ++c) {
+            uint64_t left = vectors - c * FP16_CAMPAIGN_CHUNK;
+            size_t n = left < FP16_CAMPAIGN_CHUNK ? (size_t)left : (size_t)FP16_CAMPAIGN_CHUNK;
+            Fp16CampaignResult r;
+            fp16_campaign_chunk(op, seed, c, n, *buf[w], r);
+            part[w].merge(r);
+        }
+    });
+
+    Fp16CampaignResult total;
+    for (const Fp16CampaignResult& r : part) total.merge(r);
+    return total;
+}
+
+inline Fp16CampaignResult fp16_campaign(Fp16CampaignOp op, uint64_t seed, uint64_t vectors,
+                                        unsigned threads) {
+    Fp16Pool pool(threads ? threads : 1);
+    return fp16_campaign(pool, op, seed, vectors);
+}
+
+inline void fp16_campaign_report(std::ostream& os, const Fp16CampaignResult& r, uint64_t seed) {
+    std::ios saved(nullptr);
+    saved.copyfmt(os);
+    os << std::dec << std::setfill(' ');
+
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os << " Random Campaign (seed = 0x" << std::hex << std::uppercase << seed << std::dec << ", "
+       << r.vectors << " vectors)\n";
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os << "  Mismatches : " << r.mismatches << " (" << std::fixed << std::setprecision(4)
+       << (r.vectors ? 100.0 * r.mismatches / r.vectors : 0.0) << " %)\n";
+    os << "  Rounding   : " << r.rounding << " (" << (r.vectors ? 100.0 * r.rounding / r.vectors : 0.0)
+       << " %, HW one step from the exact RZ result)\n";
+    os << "  Flags      : OF " << r.flag_count[0] << ", Z " << r.flag_count[1] << ", NaN "
+       << r.flag_count[2] << ", PL " << r.flag_count[3] << ", UF " << r.flag_count[4] << "\n";
+    if (r.mismatches) {
+        os << std::hex << std::uppercase << std::setfill('0')
+           << "  First      : #" << std::dec << r.first_index << std::hex
+           << "  0x" << std::setw(4) << r.first_a << ", 0x" << std::setw(4) << r.first_b
+           << " -> HW 0x" << std::setw(4) << r.first_hw << ", TLM 0x" << std::setw(4) << r.first_tlm << "\n";
+    }
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os.copyfmt(saved);
+}
+
+#endif // FP16_CAMPAIGN_H
@@ -0,0 +1,202 @@
+#ifndef FP16_COMMON_H
+#define FP16_COMMON_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <cstring>
+
+#include "fp16_perf.h"
+
+// ----------------------------------------------------------------------------
+// FP16 Types & Helpers
+// ----------------------------------------------------------------------------
+typedef uint16_t fp16_t;
+
+// Union for bit manipulation of float (32-bit)
+union FloatBits {
+    float f;
+    uint32_t i;
+};
+
+// Convert FP16 to Float32 (Standard IEEE 754 logic)
+inline float fp16_to_float(fp16_t h) {
+    uint32_t sign = (h >> 15) & 0x1;
+    uint32_t exp  = (h >> 10) & 0x1F;
+    uint32_t frac = h & 0x3FF;
+
+    if (exp == 0) {
+        if (frac == 0) { // Signed Zero
+            float res = 0.0f;
+            uint32_t bits;
+            std::memcpy(&bits, &res, 4);
+            bits |= (sign << 31);
+            std::memcpy(&res, &bits, 4);
+            return res;
+        }
+        else { // Subnormal
+            return std::ldexp((float)frac, -24) * (sign ? -1.0f : 1.0f);
+        }
+    }
+    else if (exp == 31) {
+        if (frac == 0) return sign ? -INFINITY : INFINITY;
+        else return NAN; // NaN
+    }
+    else { // Normal
+        return std::ldexp(1.0f + (float)frac / 1024.0f, exp - 15) * (sign ? -1.0f : 1.0f);
+    }
+}
+
+// Convert Float32 to FP16 (Truncation/Round to Zero style for TLM comparison)
+// This is a "Golden Reference" for the mathematical value.
+inline fp16_t float_to_fp16(float f) {
+    FloatBits fb;
+    fb.f = f;
+    uint32_t sign = (fb.i >> 31) & 0x1;
+    int32_t exp = ((fb.i >> 23) & 0xFF) - 127;
+    uint32_t mant = fb.i & 0x7FFFFF;
+
+    if (std::isnan(f)) return 0x7FFF; // Canonical NaN
+    if (std::isinf(f)) return (sign << 15) | 0x7C00;
+
+    if (f == 0.0f) return (sign << 15); // Zero
+
+    // Normalized to FP16 range
+    int32_t new_exp = exp + 15;
+
+    if (new_exp <= 0) { // Denormal or Underflow
+        // Simplified: Flush to zero or handle denormal
+        // For TLM comparison, let's just use simple conversion
+        if (new_exp < -10) return (sign << 15); // Too small
+
+        // Denormalize
+        mant = (mant | 0x800000) >> (1 - new_exp);
+        return (sign << 15) | (mant >> 13);
+
+    } else if (new_exp >= 31) { // Overflow
+        return (sign << 15) | 0x7C00;
+    } else {
+        return (sign << 15) | (new_exp << 10) | (mant >> 13);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Result Structures
+// ----------------------------------------------------------------------------
+// Shared by the adder and the multiplier. The adder reports precision_lost,
+// the multiplier reports underflow; the other field stays false.
+struct BitTrueResult {
+    fp16_t res;
+    bool overflow;
+    bool zero;
+    bool nan;
+    bool precision_lost;
+    bool underflow;
+};
+
+// Packed flag byte used by the batch kernels (one byte per result).
+enum : uint8_t {
+    FP16_FLAG_OF  = 1 << 0, // overflow
+    FP16_FLAG_Z   = 1 << 1, // zero
+    FP16_FLAG_NAN = 1 << 2, // NaN
+    FP16_FLAG_PL  = 1 << 3, // precision lost (adder)
+    FP16_FLAG_UF  = 1 << 4  // underflow (multiplier)
+};
+
+inline uint8_t pack_flags(const BitTrueResult& r) {
+    return (uint8_t)((r.overflow       ? FP16_FLAG_OF  : 0) |
+                     (r.zero           ? FP16_FLAG_Z   : 0) |
+                     (r.nan            ? FP16_FLAG_NAN : 0) |
+                     (r.precision_lost ? FP16_FLAG_PL  : 0) |
+                     (r.underflow      ? FP16_FLAG_UF  : 0));
+}
+
+// Denormal policies of the bit-true models (compile-time template argument).
+// DAZ treats denormal inputs as signed zero, FTZ flushes results that would
+// be denormal to signed zero; both drop the denormal datapath branches.
+enum : unsigned {
+    FP16_DENORM_IEEE    = 0,
+    FP16_DENORM_DAZ     = 1 << 0,
+    FP16_DENORM_FTZ     = 1 << 1,
+    FP16_DENORM_FTZ_DAZ = FP16_DENORM_FTZ | FP16_DENORM_DAZ
+};
+
+// Signature of the batch, SIMD and oracle kernels: res[i] / flags[i] for
+// the pair (a[i], b[i]), i < n.
+using Fp16BinaryKernel = void (*)(const fp16_t*, const fp16_t*, fp16_t*, uint8_t*, size_t);
+
+// Branch-free select (c ? a : b) for the vectorized kernels. Plain ternaries
+// in a long loop body are sometimes kept as branches, which blocks
+// vectorization; the mask form is always if-converted.
+inline uint32_t fp16_sel(uint32_t c, uint32_t a, uint32_t b) {
+    uint32_t m = 0u - (c & 1);
+    return (a & m) | (b & ~m);
+}
+
+// ----------------------------------------------------------------------------
+// Batch Conversions
+// ----------------------------------------------------------------------------
+// Scalar loops over the reference conversions.
+inline void fp16_to_float_batch(const fp16_t* in, float* out, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_TO_FLOAT, n);
+    for (size_t i = 0; i < n; ++i) out[i] = fp16_to_float(in[i]);
+}
+
+inline void float_to_fp16_batch(const float* in, fp16_t* out, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_TO_FP16, n);
+    for (size_t i = 0; i < n; ++i) out[i] = float_to_fp16(in[i]);
+}
+
+// Branch-free variants written for auto-vectorization. Bit-identical to the
+// scalar conversions above (NaN maps to the same 0x7FC00000 / 0x7FFF).
+inline void fp16_to_float_simd(const fp16_t* __restrict in, float* __restrict out, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_TO_FLOAT, n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t h    = in[i];
+        uint32_t sign = (h & 0x8000u) << 16;
+        uint32_t exp  = (h >> 10) & 0x1F;
+        uint32_t frac = h & 0x3FF;
+
+        // Subnormal: frac * 2^-24 is exact in float
+        float sub = (float)(int32_t)frac * 5.9604644775390625e-8f;
+        uint32_t sub_bits;
+        std::memcpy(&sub_bits, &sub, 4);
+
+        uint32_t is_nan  = (exp == 31) & (frac != 0);
+        uint32_t normal  = ((exp + 112) << 23) | (frac << 13);
+        uint32_t special = fp16_sel(frac != 0, 0x7FC00000u, 0x7F800000u);
+        uint32_t bits    = fp16_sel(exp == 0, sub_bits, fp16_sel(exp == 31, special, normal));
+        bits |= fp16_sel(is_nan, 0, sign);
+
+        std::memcpy(&out[i], &bits, 4);
+    }
+}
+
+inline void float_to_fp16_simd(const float* __restrict in, fp16_t* __restrict out, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_TO_FP16, n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &in[i], 4);
+        uint32_t sign    = (bits >> 16) & 0x8000u;
+        uint32_t e_field = (bits >> 23) & 0xFF;
+        uint32_t mant    = bits & 0x7FFFFF;
+        int32_t  new_exp = (int32_t)e_field - 127 + 15;
+
+        uint32_t is_nan  = (e_field == 0xFF) & (mant != 0);
+        uint32_t is_inf  = (e_field == 0xFF) & (mant == 0);
+        uint32_t is_tiny = new_exp < -10; // includes zero and float subnormals
+
+        uint32_t shift  = (uint32_t)(1 - new_exp) & 31;
+        uint32_t denorm = sign | (((mant | 0x800000u) >> shift) >> 13);
+        uint32_t normal = sign | ((uint32_t)new_exp << 10) | (mant >> 13);
+
+        uint32_t r = fp16_sel(new_exp <= 0, denorm, normal);
+        r = fp16_sel(new_exp >= 31, sign | 0x7C00u, r);
+        r = fp16_sel(is_tiny, sign, r);
+        r = fp16_sel(is_inf, sign | 0x7C00u, r);
+        r = fp16_sel(is_nan, 0x7FFFu, r);
+        out[i] = (fp16_t)r;
+    }
+}
+
+#endif // FP16_COMMON_H
@@ -0,0 +1,244 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_conv.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+#include "fp16_workload.h"
+
+// ----------------------------------------------------------------------------
+// Convolution Layer Emulation
+// ----------------------------------------------------------------------------
+// Usage: fp16_conv [--layer NAME | --shape C,H,W,K,R,S,STRIDE,PAD] [--batch N]
+//                  [--layout nchw|nhwc|all] [--method im2col|direct|all] [--order crs|rsc]
+//                  [--chunk J] [--workload NAME] [--seed S] [--threads T]
+//
+// Runs one convolution layer (a ResNet-50 layer at 224 x 224, default
+// res3_3x3) through fp16_conv.h in every selected layout and method and
+// checks that they agree bit for bit. Activations and filters follow a
+// fp16_workload.h workload (default conv); input plane (n, c) and filter k
+// are seeded from (seed, plane) and (seed, k), so the data and results do
+// not depend on the layout or the thread count. Reports time, MAC/s and
+// the error against the exact sums (FP16 ULPs at the exact result,
+// "CR %" = share equal to the RNE result).
+
+struct Fp16ConvLayer {
+    const char* name;
+    Fp16ConvShape shape; // batch 1
+};
+
+static const Fp16ConvLayer kLayers[] = {
+    {"conv1",    {1,    3, 224, 224,  64, 7, 7, 2, 3}},
+    {"res2_3x3", {1,   64,  56,  56,  64, 3, 3, 1, 1}},
+    {"res3_3x3", {1,  128,  28,  28, 128, 3, 3, 1, 1}},
+    {"res4_3x3", {1,  256,  14,  14, 256, 3, 3, 1, 1}},
+    {"res5_3x3", {1,  512,   7,   7, 512, 3, 3, 1, 1}},
+    {"res2_1x1", {1,  256,  56,  56,  64, 1, 1, 1, 0}},
+    {"res3_1x1", {1,  512,  28,  28, 128, 1, 1, 1, 0}},
+    {"res4_1x1", {1, 1024,  14,  14, 256, 1, 1, 1, 0}},
+    {"res5_1x1", {1, 2048,   7,   7, 512, 1, 1, 1, 0}},
+};
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    std::string layer = "res3_3x3", shape_arg, layout_name = "all", method_name = "all", order_name = "crs";
+    std::string name = "conv";
+    uint32_t batch = 1;
+    size_t chunk = 0;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--layer" && i + 1 < argc) layer = argv[++i];
+        else if (arg == "--shape" && i + 1 < argc) shape_arg = argv[++i];
+        else if (arg == "--batch" && i + 1 < argc) batch = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--layout" && i + 1 < argc) layout_name = argv[++i];
+        else if (arg == "--method" && i + 1 < argc) method_name = argv[++i];
+        else if (arg == "--order" && i + 1 < argc) order_name = argv[++i];
+        else if (arg == "--chunk" && i + 1 < argc) chunk = std::stoull(argv[++i]);
+        else if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--layer NAME | --shape C,H,W,K,R,S,STRIDE,PAD] [--batch N]"
+                      << " [--layout nchw|nhwc|all] [--method im2col|direct|all] [--order crs|rsc] [--chunk J]"
+                      << " [--workload NAME] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+
+    Fp16ConvShape sh;
+    if (!shape_arg.empty()) {
+        if (std::sscanf(shape_arg.c_str(), "%u,%u,%u,%u,%u,%u,%u,%u", &sh.c, &sh.h, &sh.w, &sh.k, &sh.r, &sh.s,
+                        &sh.stride, &sh.pad) != 8) {
+            std::cerr << "Bad --shape: " << shape_arg << " (expected C,H,W,K,R,S,STRIDE,PAD)\n";
+            return 1;
+        }
+        layer = "custom";
+    } else {
+        const Fp16ConvLayer* l = nullptr;
+        for (const Fp16ConvLayer& x : kLayers) {
+            if (layer == x.name) l = &x;
+        }
+        if (!l) {
+            std::cerr << "Unknown layer: " << layer << " (available:";
+            for (const Fp16ConvLayer& x : kLayers) std::cerr << " " << x.name;
+            std::cerr << ")\n";
+            return 1;
+        }
+        sh = l->shape;
+    }
+    sh.n = batch;
+    if (!sh.valid()) {
+        std::cerr << "Invalid convolution shape\n";
+        return 1;
+    }
+    std::vector<Fp16Layout> layouts;
+    if (layout_name == "all") layouts = {FP16_LAYOUT_NCHW, FP16_LAYOUT_NHWC};
+    else if (layout_name == "nchw") layouts = {FP16_LAYOUT_NCHW};
+    else if (layout_name == "nhwc") layouts = {FP16_LAYOUT_NHWC};
+    else {
+        std::cerr << "Unknown layout: " << layout_name << " (available: nchw nhwc all)\n";
+        return 1;
+    }
+    std::vector<Fp16ConvMethod> methods;
+    if (method_name == "all") methods = {FP16_CONV_IM2COL, FP16_CONV_DIRECT};
+    else if (method_name == "im2col") methods = {FP16_CONV_IM2COL};
+    else if (method_name == "direct") methods = {FP16_CONV_DIRECT};
+    else {
+        std::cerr << "Unknown method: " << method_name << " (available: im2col direct all)\n";
+        return 1;
+    }
+    Fp16ConvOrder order;
+    if (order_name == "crs") order = FP16_CONV_CRS;
+    else if (order_name == "rsc") order = FP16_CONV_RSC;
+    else {
+        std::cerr << "Unknown order: " << order_name << " (available: crs rsc)\n";
+        return 1;
+    }
+    Fp16Workload wl;
+    if (!fp16_workload(name, wl)) {
+        fp16_workload_unknown(name);
+        return 1;
+    }
+
+    Fp16Pool pool(threads ? threads : 1);
+    const size_t P = sh.p(), Q = sh.q(), J = sh.reduction();
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << std::nouppercase << ", layer "
+              << layer << ": " << sh.n << " x " << sh.c << " x " << sh.h << " x " << sh.w << " -> " << sh.k << " x " << P << " x "
+              << Q << ", " << sh.r << "x" << sh.s << " filters, stride " << sh.stride << ", pad " << sh.pad << " ("
+              << wl.name << "), " << sh.macs() / 1e6 << " M MACs, order " << fp16_conv_order_name(order)
+              << ", chunk " << chunk << ", " << pool.size() << " thread(s)\n";
+
+    // Logical NCHW planes and KCRS filters; stored per layout below
+    const size_t HW = (size_t)sh.h * sh.w;
+    std::vector<fp16_t> x(sh.input_size()), f(sh.filter_size());
+    pool.parallel_for(0, (uint64_t)sh.n * sh.c + sh.k, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        std::vector<fp16_t> act(HW > J ? HW : J), w(HW > J ? HW : J);
+        for (uint64_t r = lo; r < hi; ++r) {
+            bool plane = r < (uint64_t)sh.n * sh.c;
+            Fp16Workload wk = wl;
+            wk.k = (uint32_t)(plane ? HW : J);
+            Xoshiro256 g(fp16_rng_chunk_seed(seed ^ fp16_mix64(plane ? 1 : 2), plane ? r : r - sh.n * sh.c));
+            fp16_workload_fill(wk, g, act.data(), w.data());
+            if (plane) {
+                for (size_t i = 0; i < HW; ++i) x[r * HW + i] = act[i];
+            } else {
+                for (size_t j = 0; j < J; ++j) f[(r - sh.n * sh.c) * J + j] = w[j];
+            }
+        }
+    });
+
+    // Exact sums (in the logical layouts, NKPQ)
+    std::vector<double> exact(sh.output_size());
+    pool.parallel_for(0, (uint64_t)sh.n * sh.k, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        for (uint64_t nk = lo; nk < hi; ++nk) {
+            size_t in_n = nk / sh.k, k = nk % sh.k;
+            for (size_t y = 0; y < P; ++y) {
+                for (size_t xo = 0; xo < Q; ++xo) {
+                    double acc = 0;
+                    for (size_t c = 0; c < sh.c; ++c) {
+                        for (size_t r = 0; r < sh.r; ++r) {
+                            long iy = (long)(y * sh.stride + r) - (long)sh.pad;
+                            if (iy < 0 || iy >= (long)sh.h) continue;
+                            for (size_t s = 0; s < sh.s; ++s) {
+                                long ix = (long)(xo * sh.stride + s) - (long)sh.pad;
+                                if (ix < 0 || ix >= (long)sh.w) continue;
+                                acc += fp16_oracle_to_double(x[(in_n * sh.c + c) * HW + iy * sh.w + ix]) *
+                                       fp16_oracle_to_double(f[(k * sh.c + c) * sh.r * sh.s + r * sh.s + s]);
+                            }
+                        }
+                    }
+                    exact[(nk * P + y) * Q + xo] = acc;
+                }
+            }
+        }
+    });
+
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << "  " << std::left << std::setw(8) << "Layout" << std::setw(10) << "Method" << std::right
+              << std::setw(10) << "time s" << std::setw(12) << "M MAC/s" << std::setw(14) << "mean rel"
+              << std::setw(14) << "max rel" << std::setw(12) << "mean |ULP|" << std::setw(8) << "CR %"
+              << std::setw(8) << "same" << "\n"
+              << "--------------------------------------------------------------------------------------------------\n";
+    std::vector<fp16_t> first; // first result, logical NKPQ
+    bool all_same = true;
+    for (Fp16Layout layout : layouts) {
+        std::vector<fp16_t> in(sh.input_size()), filt(sh.filter_size()), out(sh.output_size());
+        for (size_t in_n = 0; in_n < sh.n; ++in_n) {
+            for (size_t c = 0; c < sh.c; ++c) {
+                for (size_t i = 0; i < HW; ++i) {
+                    in[sh.input_index(layout, in_n, c, i / sh.w, i % sh.w)] = x[(in_n * sh.c + c) * HW + i];
+                }
+            }
+        }
+        for (size_t k = 0; k < sh.k; ++k) {
+            for (size_t j = 0; j < J; ++j) {
+                filt[sh.filter_index(layout, k, j / (sh.r * sh.s), j / sh.s % sh.r, j % sh.s)] = f[k * J + j];
+            }
+        }
+        for (Fp16ConvMethod method : methods) {
+            Fp16ConvConfig cfg;
+            cfg.layout = layout;
+            cfg.order = order;
+            cfg.chunk = chunk;
+            cfg.method = method;
+            Fp16Conv conv(sh, cfg);
+            auto t0 = std::chrono::steady_clock::now();
+            conv.run(pool, in.data(), filt.data(), out.data());
+            double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+            std::vector<fp16_t> res(sh.output_size());
+            for (size_t nk = 0; nk < (size_t)sh.n * sh.k; ++nk) {
+                for (size_t pq = 0; pq < P * Q; ++pq) {
+                    res[nk * P * Q + pq] = out[sh.output_index(layout, nk / sh.k, nk % sh.k, pq / Q, pq % Q)];
+                }
+            }
+            bool same = first.empty() || res == first;
+            if (first.empty()) first = res;
+            all_same &= same;
+
+            Fp16WorkloadScore err;
+            for (size_t i = 0; i < res.size(); ++i) fp16_workload_score(err, res[i], exact[i]);
+            std::cout << "  " << std::left << std::setw(8) << fp16_layout_name(layout) << std::setw(10)
+                      << fp16_conv_method_name(method) << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(10) << sec << std::setprecision(1) << std::setw(12) << sh.macs() / sec / 1e6
+                      << std::scientific << std::setprecision(3) << std::setw(14)
+                      << err.mean_rel() << std::setw(14) << err.max_rel << std::fixed << std::setprecision(2)
+                      << std::setw(12) << err.mean_ulp() << std::setw(8) << err.cr_percent() << std::setw(8)
+                      << (same ? "yes" : "NO") << "\n";
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << (all_same ? "All layouts and methods bit-identical\n" : "MISMATCH between layouts / methods\n");
+    return all_same ? 0 : 1;
+}
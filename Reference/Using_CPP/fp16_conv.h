@@ -0,0 +1,185 @@
+#ifndef FP16_CONV_H
+#define FP16_CONV_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// 2D Convolution on the Bit-True MAC
+// ----------------------------------------------------------------------------
+// out[n][k][y][x] = sum over (c, r, s) of in[n][c][y*stride - pad + r][x*stride - pad + s] * f[k][c][r][s]
+// with the bit-true multiplier and adder. Activations and outputs are NCHW
+// or NHWC, filters KCRS or KRSC to match. Padding taps are multiplied as
+// zeros, as an im2col buffer feeds them to the MAC.
+//
+// Accumulation order: the J = C * R * S reduction terms of an output run
+// in crs (c outer, s inner) or rsc (c inner) order, from +0. With chunk > 0
+// every chunk of `chunk` terms is accumulated from +0 and the chunk sums
+// are added in order into the output (a MAC array that reduces one tile
+// of the reduction at a time); chunk = 0 is one serial chain.
+//
+// Methods, bit-identical to each other:
+//   im2col : the patch matrix [N*P*Q x J] is built first, then multiplied
+//            by the packed filters [J x K] as a GEMM.
+//   direct : the loop nest reads the activations in place.
+// Both split the layer into tiles of FP16_CONV_TILE_PX output pixels x
+// FP16_CONV_TILE_K output channels on the pool and run fp16_mul_simd /
+// fp16_add_simd across the output channels of a tile, so the results do
+// not depend on the thread count.
+
+enum Fp16Layout { FP16_LAYOUT_NCHW, FP16_LAYOUT_NHWC };
+enum Fp16ConvOrder { FP16_CONV_CRS, FP16_CONV_RSC };
+enum Fp16ConvMethod { FP16_CONV_IM2COL, FP16_CONV_DIRECT };
+
+static const size_t FP16_CONV_TILE_PX = 8;
+static const size_t FP16_CONV_TILE_K = 64;
+
+inline const char* fp16_layout_name(Fp16Layout l) { return l == FP16_LAYOUT_NCHW ? "nchw" : "nhwc"; }
+inline const char* fp16_conv_order_name(Fp16ConvOrder o) { return o == FP16_CONV_CRS ? "crs" : "rsc"; }
+inline const char* fp16_conv_method_name(Fp16ConvMethod m) { return m == FP16_CONV_IM2COL ? "im2col" : "direct"; }
+
+struct Fp16ConvShape {
+    uint32_t n = 1, c = 64, h = 56, w = 56; // input
+    uint32_t k = 64, r = 3, s = 3;          // filters
+    uint32_t stride = 1, pad = 1;
+
+    bool valid() const {
+        return n && c && h && w && k && r && s && stride && h + 2 * pad >= r && w + 2 * pad >= s;
+    }
+    uint32_t p() const { return (h + 2 * pad - r) / stride + 1; }
+    uint32_t q() const { return (w + 2 * pad - s) / stride + 1; }
+    size_t reduction() const { return (size_t)c * r * s; }
+    uint64_t macs() const { return (uint64_t)n * k * p() * q() * reduction(); }
+
+    size_t input_size() const { return (size_t)n * c * h * w; }
+    size_t filter_size() const { return (size_t)k * reduction(); }
+    size_t output_size() const { return (size_t)n * k * p() * q(); }
+
+    size_t input_index(Fp16Layout l, size_t in, size_t ic, size_t y, size_t x) const {
+        return l == FP16_LAYOUT_NCHW ? ((in * c + ic) * h + y) * w + x : ((in * h + y) * w + x) * c + ic;
+    }
+    size_t filter_index(Fp16Layout l, size_t ik, size_t ic, size_t ir, size_t is) const {
+        return l == FP16_LAYOUT_NCHW ? ((ik * c + ic) * r + ir) * s + is : ((ik * r + ir) * s + is) * c + ic;
+    }
+    size_t output_index(Fp16Layout l, size_t in, size_t ik, size_t y, size_t x) const {
+        return l == FP16_LAYOUT_NCHW ? ((in * k + ik) * p() + y) * q() + x : ((in * p() + y) * q() + x) * k + ik;
+    }
+};
+
+struct Fp16ConvConfig {
+    Fp16Layout layout = FP16_LAYOUT_NCHW;
+    Fp16ConvOrder order = FP16_CONV_CRS;
+    size_t chunk = 0;
+    Fp16ConvMethod method = FP16_CONV_IM2COL;
+};
+
+class Fp16Conv {
+public:
+    Fp16Conv(const Fp16ConvShape& sh, const Fp16ConvConfig& cfg) : sh_(sh), cfg_(cfg) {
+        // (c, r, s) of every reduction index j
+        size_t J = sh_.reduction();
+        jc_.resize(J); jr_.resize(J); js_.resize(J);
+        for (size_t j = 0; j < J; ++j) {
+            if (cfg_.order == FP16_CONV_CRS) {
+                jc_[j] = (uint32_t)(j / (sh_.r * sh_.s)); jr_[j] = (uint32_t)(j / sh_.s % sh_.r); js_[j] = (uint32_t)(j % sh_.s);
+            } else {
+                jr_[j] = (uint32_t)(j / ((size_t)sh_.s * sh_.c)); js_[j] = (uint32_t)(j / sh_.c % sh_.s); jc_[j] = (uint32_t)(j % sh_.c);
+            }
+        }
+    }
+
+    void run(Fp16Pool& pool, const fp16_t* in, const fp16_t* filt, fp16_t* out) const {
+        const size_t J = sh_.reduction(), K = sh_.k, PQ = (size_t)sh_.p() * sh_.q();
+        // Filters packed as [J][K]
+        std::vector<fp16_t> wt(J * K);
+        pool.parallel_for(0, K, 16, [&](uint64_t lo, uint64_t hi, unsigned) {
+            for (uint64_t k = lo; k < hi; ++k) {
+                for (size_t j = 0; j < J; ++j) wt[j * K + k] = filt[sh_.filter_index(cfg_.layout, k, jc_[j], jr_[j], js_[j])];
+            }
+        });
+        std::vector<fp16_t> col;
+        if (cfg_.method == FP16_CONV_IM2COL) {
+            col.resize(sh_.n * PQ * J);
+            pool.parallel_for(0, sh_.n * PQ, 64, [&](uint64_t lo, uint64_t hi, unsigned) {
+                for (uint64_t px = lo; px < hi; ++px) {
+                    for (size_t j = 0; j < J; ++j) col[px * J + j] = tap(in, px / PQ, px % PQ, j);
+                }
+            });
+        }
+
+        const size_t pt = (PQ + FP16_CONV_TILE_PX - 1) / FP16_CONV_TILE_PX;
+        const size_t kt = (K + FP16_CONV_TILE_K - 1) / FP16_CONV_TILE_K;
+        pool.parallel_for(0, sh_.n * pt * kt, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+            for (uint64_t t = lo; t < hi; ++t) {
+                size_t in_n = t / (pt * kt), p0 = t / kt % pt * FP16_CONV_TILE_PX, k0 = t % kt * FP16_CONV_TILE_K;
+                tile(in, col.data(), wt.data(), out, in_n, p0, k0);
+            }
+        });
+    }
+
+private:
+    // Activation feeding reduction term j of output pixel pq (0 in the padding).
+    fp16_t tap(const fp16_t* in, size_t in_n, size_t pq, size_t j) const {
+        long y = (long)(pq / sh_.q() * sh_.stride + jr_[j]) - (long)sh_.pad;
+        long x = (long)(pq % sh_.q() * sh_.stride + js_[j]) - (long)sh_.pad;
+        if (y < 0 || x < 0 || y >= (long)sh_.h || x >= (long)sh_.w) return 0;
+        return in[sh_.input_index(cfg_.layout, in_n, jc_[j], (size_t)y, (size_t)x)];
+    }
+
+    // Output pixels [p0, p0 + TILE_PX) x channels [k0, k0 + TILE_K) of image in_n;
+    // activations come from col with im2col and from tap() with direct.
+    void tile(const fp16_t* in, const fp16_t* col, const fp16_t* wt, fp16_t* out, size_t in_n, size_t p0,
+              size_t k0) const {
+        const size_t J = sh_.reduction(), K = sh_.k, PQ = (size_t)sh_.p() * sh_.q();
+        const size_t np = PQ - p0 < FP16_CONV_TILE_PX ? PQ - p0 : FP16_CONV_TILE_PX;
+        const size_t nk = K - k0 < FP16_CONV_TILE_K ? K - k0 : FP16_CONV_TILE_K;
+        const size_t chunk = cfg_.chunk ? cfg_.chunk : J;
+        // acc ping-pongs between two buffers per term; sum holds the chunk sums
+        fp16_t acc[2][FP16_CONV_TILE_PX][FP16_CONV_TILE_K] = {}, sum[FP16_CONV_TILE_PX][FP16_CONV_TILE_K];
+        fp16_t bcast[FP16_CONV_TILE_K], prod[FP16_CONV_TILE_K], tmp[FP16_CONV_TILE_K];
+        uint8_t fl[FP16_CONV_TILE_K];
+        int cur = 0;
+        for (size_t j = 0; j < J; ++j) {
+            if (j && j % chunk == 0) {
+                for (size_t i = 0; i < np; ++i) {
+                    if (j == chunk) {
+                        for (size_t kk = 0; kk < nk; ++kk) sum[i][kk] = acc[cur][i][kk];
+                    } else {
+                        fp16_add_simd(sum[i], acc[cur][i], tmp, fl, nk);
+                        for (size_t kk = 0; kk < nk; ++kk) sum[i][kk] = tmp[kk];
+                    }
+                    for (size_t kk = 0; kk < nk; ++kk) acc[cur][i][kk] = 0;
+                }
+            }
+            const fp16_t* w = wt + j * K + k0;
+            for (size_t i = 0; i < np; ++i) {
+                fp16_t a = cfg_.method == FP16_CONV_IM2COL ? col[(in_n * PQ + p0 + i) * J + j] : tap(in, in_n, p0 + i, j);
+                for (size_t kk = 0; kk < nk; ++kk) bcast[kk] = a;
+                fp16_mul_simd(bcast, w, prod, fl, nk);
+                fp16_add_simd(acc[cur][i], prod, acc[cur ^ 1][i], fl, nk);
+            }
+            cur ^= 1;
+        }
+        for (size_t i = 0; i < np; ++i) {
+            const fp16_t* res = acc[cur][i];
+            if (J > chunk) {
+                fp16_add_simd(sum[i], acc[cur][i], tmp, fl, nk);
+                res = tmp;
+            }
+            size_t y = (p0 + i) / sh_.q(), x = (p0 + i) % sh_.q();
+            for (size_t kk = 0; kk < nk; ++kk) out[sh_.output_index(cfg_.layout, in_n, k0 + kk, y, x)] = res[kk];
+        }
+    }
+
+    Fp16ConvShape sh_;
+    Fp16ConvConfig cfg_;
+    std::vector<uint32_t> jc_, jr_, js_;
+};
+
+#endif // FP16_CONV_H
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_diff.h"
+
+// ----------------------------------------------------------------------------
+// Multi-Model Differential Runner
+// ----------------------------------------------------------------------------
+// Usage: fp16_diff [--op add|mul] [--models M1,M2,...] [--vectors N]
+//                  [--stim PRESET] [--seed S] [--threads T] [--examples K]
+//                  [--flags MASK]
+//
+// Runs the listed models of fp16_diff.h on the same stimulus in one pass and
+// prints the pairwise disagreement matrices, the kernel time of every model
+// and the first K counterexamples of each disagreeing pair. Models:
+//   bittrue, simd      : fp16_add_batch / fp16_add_simd (mul: fp16_mul_*)
+//   rtl                : fpadder_rtl.h, signal-level fpadder.v (add only)
+//   oracle-rz|rne|ru|rd: exact oracle of fp16_oracle.h in that rounding
+// --flags masks the FP16_FLAG_* bits that are compared (default 0x1F).
+// Results depend only on the seed, never on the thread count. Exits with 1
+// when any pair disagrees on a result.
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t vectors = 1 << 24;
+    size_t keep = 5;
+    unsigned threads = std::thread::hardware_concurrency();
+    unsigned flag_mask = 0x1F;
+    std::string op = "add", list, stim_name;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--op" && i + 1 < argc) op = argv[++i];
+        else if (arg == "--models" && i + 1 < argc) list = argv[++i];
+        else if (arg == "--vectors" && i + 1 < argc) vectors = std::stoull(argv[++i]);
+        else if (arg == "--stim" && i + 1 < argc) stim_name = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else if (arg == "--examples" && i + 1 < argc) keep = std::stoull(argv[++i]);
+        else if (arg == "--flags" && i + 1 < argc) flag_mask = (unsigned)std::stoul(argv[++i], nullptr, 0);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--op add|mul] [--models M1,M2,...] [--vectors N]\n"
+                      << "       [--stim PRESET] [--seed S] [--threads T] [--examples K] [--flags MASK]\n";
+            return 1;
+        }
+    }
+    if (op != "add" && op != "mul") {
+        std::cerr << "Invalid --op: " << op << "\n";
+        return 1;
+    }
+    if (list.empty()) list = (op == "add") ? "bittrue,simd,rtl,oracle-rz,oracle-rne" : "bittrue,simd,oracle-rz,oracle-rne";
+    if (stim_name.empty()) stim_name = op;
+
+    std::vector<Fp16DiffModel> models;
+    for (size_t pos = 0; pos <= list.size();) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        std::string name = list.substr(pos, end - pos);
+        Fp16DiffModel m;
+        if (!fp16_diff_model(op, name, m)) {
+            std::cerr << "Unknown " << op << " model: " << name << " (available:";
+            for (const Fp16DiffModel& a : fp16_diff_models(op)) std::cerr << " " << a.name;
+            std::cerr << ")\n";
+            return 1;
+        }
+        models.push_back(m);
+        pos = end + 1;
+    }
+    if (models.size() < 2) {
+        std::cerr << "--models needs at least two models\n";
+        return 1;
+    }
+    Fp16StimWeights weights;
+    if (!fp16_stim_weights(stim_name, weights)) {
+        std::cerr << "Unknown stimulus preset: " << stim_name << "\n";
+        return 1;
+    }
+
+    Fp16Pool pool(threads ? threads : 1);
+    auto t0 = std::chrono::steady_clock::now();
+    Fp16DiffResult r = fp16_diff_run(pool, models, weights, (uint8_t)flag_mask, seed, vectors, keep);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << ", op " << op << ", stim "
+              << stim_name << ", " << models.size() << " models, " << pool.size() << " thread(s), "
+              << std::fixed << std::setprecision(2) << sec << " s\n";
+    fp16_diff_report(std::cout, models, r);
+
+    uint64_t total = 0;
+    for (uint64_t d : r.result_diff) total += d;
+    return total ? 1 : 0;
+}
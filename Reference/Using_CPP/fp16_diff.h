@@ -0,0 +1,269 @@
+#ifndef FP16_DIFF_H
+#define FP16_DIFF_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+#include "fp16_stimulus.h"
+#include "fpadder_rtl.h"
+
+// ----------------------------------------------------------------------------
+// Single-Pass Differential Runner
+// ----------------------------------------------------------------------------
+// Evaluates N registered models on the same operand pairs in one pass. Each
+// chunk of FP16_DIFF_CHUNK pairs comes from fp16_stimulus.h seeded with
+// fp16_rng_chunk_seed(seed, c) and is processed in blocks of FP16_DIFF_BLOCK
+// pairs: the block is generated, every model writes its results, and all
+// model pairs are compared while inputs and outputs are still in L1
+// (4 KiB of operands plus 3 KiB per model). The cost of a run is the sum of
+// the model kernels plus one generation and a vectorized comparison pass.
+//
+// For every model pair (i, j) it counts
+//   result : results differ (NaN == NaN, any payload)
+//   flags  : results equal, flags differ under the flag mask
+// and keeps the first K disagreements of either kind (lowest global index),
+// so the report is identical for any thread count and stealing order.
+
+enum { FP16_DIFF_CHUNK = 1 << 16, FP16_DIFF_BLOCK = 1 << 10 };
+
+struct Fp16DiffModel {
+    const char* name;
+    Fp16BinaryKernel kernel;
+};
+
+// Models available for an operation ("add" or "mul").
+inline std::vector<Fp16DiffModel> fp16_diff_models(const std::string& op) {
+    if (op == "add") {
+        return {{"bittrue", fp16_add_batch},
+                {"bittrue-daz", fp16_add_batch_policy<FP16_DENORM_DAZ>},
+                {"bittrue-ftz", fp16_add_batch_policy<FP16_DENORM_FTZ>},
+                {"bittrue-ftzdaz", fp16_add_batch_policy<FP16_DENORM_FTZ_DAZ>},
+                {"simd", fp16_add_simd},
+                {"rtl", fpadder_rtl_batch},
+                {"oracle-rz", fp16_oracle_add_simd<FP16_ROUND_RZ>},
+                {"oracle-rne", fp16_oracle_add_simd<FP16_ROUND_RNE>},
+                {"oracle-ru", fp16_oracle_add_simd<FP16_ROUND_RU>},
+                {"oracle-rd", fp16_oracle_add_simd<FP16_ROUND_RD>}};
+    }
+    if (op == "mul") {
+        return {{"bittrue", fp16_mul_batch},
+                {"bittrue-daz", fp16_mul_batch_policy<FP16_DENORM_DAZ>},
+                {"bittrue-ftz", fp16_mul_batch_policy<FP16_DENORM_FTZ>},
+                {"bittrue-ftzdaz", fp16_mul_batch_policy<FP16_DENORM_FTZ_DAZ>},
+                {"simd", fp16_mul_simd},
+                {"oracle-rz", fp16_oracle_mul_simd<FP16_ROUND_RZ>},
+                {"oracle-rne", fp16_oracle_mul_simd<FP16_ROUND_RNE>},
+                {"oracle-ru", fp16_oracle_mul_simd<FP16_ROUND_RU>},
+                {"oracle-rd", fp16_oracle_mul_simd<FP16_ROUND_RD>}};
+    }
+    return {};
+}
+
+inline bool fp16_diff_model(const std::string& op, const std::string& name, Fp16DiffModel& out) {
+    for (const Fp16DiffModel& m : fp16_diff_models(op)) {
+        if (name == m.name) { out = m; return true; }
+    }
+    return false;
+}
+
+struct Fp16DiffExample {
+    uint64_t index;
+    fp16_t a, b, res_i, res_j;
+    uint8_t flags_i, flags_j;
+};
+
+struct Fp16DiffResult {
+    size_t models = 0;
+    size_t keep = 0;
+    uint64_t vectors = 0;
+    std::vector<uint64_t> result_diff;                // [i * models + j], i < j
+    std::vector<uint64_t> flag_diff;                  // [i * models + j], i < j
+    std::vector<std::vector<Fp16DiffExample>> first;  // [i * models + j], i < j
+    std::vector<double> seconds;                      // kernel time per model (all workers)
+
+    Fp16DiffResult() {}
+    Fp16DiffResult(size_t m, size_t k)
+        : models(m), keep(k), result_diff(m * m), flag_diff(m * m), first(m * m), seconds(m) {}
+
+    // Pair p is full when it already holds K examples below `index`.
+    bool full(size_t p, uint64_t index) const {
+        return first[p].size() >= keep && (keep == 0 || first[p].back().index < index);
+    }
+
+    void merge(const Fp16DiffResult& o) {
+        vectors += o.vectors;
+        for (size_t p = 0; p < result_diff.size(); ++p) {
+            result_diff[p] += o.result_diff[p];
+            flag_diff[p] += o.flag_diff[p];
+            if (o.first[p].empty()) continue;
+            std::vector<Fp16DiffExample> m(first[p].size() + o.first[p].size());
+            std::merge(first[p].begin(), first[p].end(), o.first[p].begin(), o.first[p].end(), m.begin(),
+                       [](const Fp16DiffExample& x, const Fp16DiffExample& y) { return x.index < y.index; });
+            if (m.size() > keep) m.resize(keep);
+            first[p].swap(m);
+        }
+        for (size_t k = 0; k < seconds.size(); ++k) seconds[k] += o.seconds[k];
+    }
+};
+
+// Per-worker scratch: one block of operands and one result block per model.
+struct Fp16DiffBuffers {
+    std::vector<fp16_t> a, b, res;
+    std::vector<uint8_t> flags;
+
+    explicit Fp16DiffBuffers(size_t models)
+        : a(FP16_DIFF_BLOCK), b(FP16_DIFF_BLOCK), res(models * FP16_DIFF_BLOCK), flags(models * FP16_DIFF_BLOCK) {}
+};
+
+// Counts the disagreements of one model pair over a block. Branch-free, so
+// it vectorizes; returns (result count) | (flag count) << 32.
+inline uint64_t fp16_diff_count(const fp16_t* __restrict ri, const fp16_t* __restrict rj,
+                                const uint8_t* __restrict fi, const uint8_t* __restrict fj,
+                                uint8_t flag_mask, size_t n) {
+    uint32_t nr = 0, nf = 0;
+    for (size_t k = 0; k < n; ++k) {
+        uint32_t x = ri[k], y = rj[k];
+        uint32_t both_nan = ((x & 0x7FFF) > 0x7C00) & ((y & 0x7FFF) > 0x7C00);
+        uint32_t rd = (x != y) & (both_nan ^ 1);
+        nr += rd;
+        nf += (rd ^ 1) & (((fi[k] ^ fj[k]) & flag_mask) != 0);
+    }
+    return nr | ((uint64_t)nf << 32);
+}
+
+// One chunk of n <= FP16_DIFF_CHUNK pairs.
+inline void fp16_diff_chunk(const std::vector<Fp16DiffModel>& models, const Fp16StimWeights& w,
+                            uint8_t flag_mask, uint64_t seed, uint64_t chunk, size_t n,
+                            Fp16DiffBuffers& buf, Fp16DiffResult& r) {
+    const size_t m = models.size();
+    Fp16Stimulus stim(fp16_rng_chunk_seed(seed, chunk), w);
+
+    for (size_t off = 0; off < n; off += FP16_DIFF_BLOCK) {
+        size_t len = (n - off < (size_t)FP16_DIFF_BLOCK) ? n - off : (size_t)FP16_DIFF_BLOCK;
+        uint64_t base = chunk * FP16_DIFF_CHUNK + off;
+        stim.fill(buf.a.data(), buf.b.data(), len);
+
+        for (size_t i = 0; i < m; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            models[i].kernel(buf.a.data(), buf.b.data(), &buf.res[i * FP16_DIFF_BLOCK],
+                             &buf.flags[i * FP16_DIFF_BLOCK], len);
+            r.seconds[i] += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        }
+
+        for (size_t i = 0; i < m; ++i) {
+            const fp16_t* ri = &buf.res[i * FP16_DIFF_BLOCK];
+            const uint8_t* fi = &buf.flags[i * FP16_DIFF_BLOCK];
+            for (size_t j = i + 1; j < m; ++j) {
+                const fp16_t* rj = &buf.res[j * FP16_DIFF_BLOCK];
+                const uint8_t* fj = &buf.flags[j * FP16_DIFF_BLOCK];
+                size_t p = i * m + j;
+                uint64_t c = fp16_diff_count(ri, rj, fi, fj, flag_mask, len);
+                if (!c) continue;
+                r.result_diff[p] += (uint32_t)c;
+                r.flag_diff[p] += c >> 32;
+
+                // Examples: only scanned while this pair can still improve.
+                for (size_t k = 0; k < len && !r.full(p, base + k); ++k) {
+                    bool nan = ((ri[k] & 0x7FFF) > 0x7C00) && ((rj[k] & 0x7FFF) > 0x7C00);
+                    bool diff = (ri[k] != rj[k] && !nan) || ((fi[k] ^ fj[k]) & flag_mask);
+                    if (!diff) continue;
+                    Fp16DiffExample e = {base + k, buf.a[k], buf.b[k], ri[k], rj[k], fi[k], fj[k]};
+                    std::vector<Fp16DiffExample>& f = r.first[p];
+                    if (f.size() >= r.keep) f.pop_back();
+                    auto at = std::upper_bound(f.begin(), f.end(), e.index,
+                                               [](uint64_t x, const Fp16DiffExample& y) { return x < y.index; });
+                    f.insert(at, e);
+                }
+            }
+        }
+    }
+    r.vectors += n;
+}
+
+// Chunks are scheduled one at a time on the work-stealing pool; every worker
+// keeps its own buffers and partial result. A worker mostly takes chunks in
+// increasing order, so once a pair holds K examples later chunks skip the
+// example scan for it.
+inline Fp16DiffResult fp16_diff_run(Fp16Pool& pool, const std::vector<Fp16DiffModel>& models,
+                                    const Fp16StimWeights& w, uint8_t flag_mask, uint64_t seed,
+                                    uint64_t vectors, size_t keep) {
+    uint64_t chunks = (vectors + FP16_DIFF_CHUNK - 1) / FP16_DIFF_CHUNK;
+    std::vector<std::unique_ptr<Fp16DiffBuffers>> buf(pool.size());
+    std::vector<Fp16DiffResult> part(pool.size(), Fp16DiffResult(models.size(), keep));
+
+    pool.parallel_for(0, chunks, 1, [&](uint64_t lo, uint64_t hi, unsigned t) {
+        if (!buf[t]) buf[t].reset(new Fp16DiffBuffers(models.size()));
+        for (uint64_t c = lo; c < hi; ++c) {
+            uint64_t left = vectors - c * FP16_DIFF_CHUNK;
+            size_t n = left < FP16_DIFF_CHUNK ? (size_t)left : (size_t)FP16_DIFF_CHUNK;
+            fp16_diff_chunk(models, w, flag_mask, seed, c, n, *buf[t], part[t]);
+        }
+    });
+
+    Fp16DiffResult total(models.size(), keep);
+    for (const Fp16DiffResult& r : part) total.merge(r);
+    return total;
+}
+
+// Disagreement matrices (result above the diagonal, flags below), per-model
+// kernel time and the first K examples of every disagreeing pair.
+inline void fp16_diff_report(std::ostream& os, const std::vector<Fp16DiffModel>& models,
+                             const Fp16DiffResult& r) {
+    std::ios saved(nullptr);
+    saved.copyfmt(os);
+    const size_t m = models.size();
+    const char* rule = "--------------------------------------------------------------------------------------------------\n";
+
+    os << std::dec << std::setfill(' ');
+    os << rule << " Disagreements (" << r.vectors << " vectors; upper: result, lower: flags only)\n" << rule;
+    os << "  " << std::left << std::setw(12) << "";
+    for (size_t j = 0; j < m; ++j) os << std::right << std::setw(12) << models[j].name;
+    os << "\n";
+    for (size_t i = 0; i < m; ++i) {
+        os << "  " << std::left << std::setw(12) << models[i].name << std::right;
+        for (size_t j = 0; j < m; ++j) {
+            if (i == j) os << std::setw(12) << "-";
+            else if (i < j) os << std::setw(12) << r.result_diff[i * m + j];
+            else os << std::setw(12) << r.flag_diff[j * m + i];
+        }
+        os << "\n";
+    }
+
+    os << rule << "  Model        | Kernel s | ns/op\n" << rule;
+    for (size_t i = 0; i < m; ++i) {
+        os << "  " << std::left << std::setw(12) << models[i].name << std::right << " | " << std::fixed
+           << std::setprecision(3) << std::setw(8) << r.seconds[i] << " | " << std::setw(6)
+           << (r.vectors ? 1e9 * r.seconds[i] / r.vectors : 0.0) << "\n";
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = i + 1; j < m; ++j) {
+            const std::vector<Fp16DiffExample>& ex = r.first[i * m + j];
+            if (ex.empty()) continue;
+            os << rule << " " << models[i].name << " vs " << models[j].name << ": first " << ex.size() << "\n";
+            for (const Fp16DiffExample& e : ex) {
+                os << "  #" << std::dec << std::setfill(' ') << std::left << std::setw(12) << e.index
+                   << std::right << std::hex << std::uppercase << std::setfill('0')
+                   << " 0x" << std::setw(4) << e.a << ", 0x" << std::setw(4) << e.b
+                   << " -> 0x" << std::setw(4) << e.res_i << " [" << std::setw(2) << (unsigned)e.flags_i
+                   << "] vs 0x" << std::setw(4) << e.res_j << " [" << std::setw(2) << (unsigned)e.flags_j
+                   << "]\n";
+            }
+        }
+    }
+    os << rule;
+    os.copyfmt(saved);
+}
+
+#endif // FP16_DIFF_H
@@ -0,0 +1,256 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_pipe.h"
+#include "fp16_rng.h"
+#include "fp16_stage.h"
+#include "fp16_workload.h"
+
+// ----------------------------------------------------------------------------
+// Pipeline-Depth Design-Space Exploration
+// ----------------------------------------------------------------------------
+// Usage: fp16_dse [--unit add|mul|all] [--input FILE | --workload NAME --vectors N]
+//                 [--delay UNIT.STAGE=NS,...] [--reg-ns R] [--out-regs O] [--acc K]
+//                 [--format table|csv|jsonl] [--seed S]
+//
+// Runs an operand stream through every stage cut (fp16_stage.h) of the
+// adder and the multiplier: 1 to 4 pipeline stages over align / add /
+// normalize / pack (exponent / multiply / normalize / pack). The stream is
+// a recorded file of packed little-endian (a, b) uint16 pairs (the --filter
+// input format of the references) or N activation / weight pairs of a
+// fp16_workload.h workload (default fc). Per cut it reports
+//   latency   : pipeline stages plus O output registers (default 1, as the
+//               output registers of fpadder.v), in cycles and ns
+//   clock     : slowest stage from the per-stage delays plus R ns register
+//               overhead (--delay overrides the estimates in fp16_stage.h)
+//   stream    : ops per cycle and Mops/s of the cycle-level simulation
+//   MAC       : MACs per cycle and MMAC/s of the stream as one dot product
+//               on fp16_pipe.h with K accumulators, the unit at this
+//               latency and the other unstaged at 2 cycles. The MAC runs at
+//               the slower of the two units' clocks, which is reported with
+//               the unit that sets it
+//   check     : results that differ from the unstaged bit-true model
+// --format csv|jsonl prints one row per cut for plotting.
+
+struct CutRow {
+    std::string unit, stages;
+    uint32_t cut, depth, latency;
+    double period_ns, fmax_mhz, stream_opc, mac_opc;
+    double mac_fmax_mhz;        // min(fmax_mhz, the unstaged other unit's Fmax)
+    bool mac_other_limits;      // the other unit sets the MAC clock
+    uint64_t cycles, mismatches;
+};
+
+template <typename S>
+static void explore(const std::string& unit, const Fp16StageDef<S>* stages, Fp16ScalarOp ref_op,
+                    const std::vector<fp16_t>& a, const std::vector<fp16_t>& b, double reg_ns, uint32_t out_regs,
+                    uint32_t acc, double other_fmax_mhz, std::vector<CutRow>& rows) {
+    size_t n = a.size();
+    std::vector<fp16_t> res(n), ref(n);
+    std::vector<uint8_t> flags(n), ref_flags(n);
+    for (size_t i = 0; i < n; ++i) {
+        BitTrueResult r = ref_op(a[i], b[i]);
+        ref[i] = r.res;
+        ref_flags[i] = pack_flags(r);
+    }
+
+    for (uint32_t cut = 0; cut < FP16_STAGE_CUTS; ++cut) {
+        Fp16StagePipe<S> pipe(stages, cut);
+        CutRow row;
+        row.unit = unit;
+        row.stages = fp16_cut_name(stages, cut);
+        row.cut = cut;
+        row.depth = pipe.depth();
+        row.latency = row.depth + out_regs;
+        Fp16CutTiming t = fp16_cut_timing(stages, cut, reg_ns);
+        row.period_ns = t.period_ns;
+        row.fmax_mhz = t.fmax_mhz;
+        row.cycles = pipe.run(a.data(), b.data(), n, res.data(), flags.data()) + out_regs;
+        row.stream_opc = (double)n / row.cycles;
+        row.mismatches = 0;
+        for (size_t i = 0; i < n; ++i) row.mismatches += res[i] != ref[i] || flags[i] != ref_flags[i];
+
+        Fp16PipeConfig cfg;
+        cfg.accumulators = acc;
+        if (unit == "add") cfg.add_latency = row.latency;
+        else cfg.mul_latency = row.latency;
+        Fp16PipeStats st;
+        Fp16MacPipe mac(cfg);
+        mac.dot(a.data(), b.data(), n, st);
+        row.mac_opc = st.macs_per_cycle();
+        row.mac_other_limits = other_fmax_mhz < row.fmax_mhz;
+        row.mac_fmax_mhz = row.mac_other_limits ? other_fmax_mhz : row.fmax_mhz;
+        rows.push_back(row);
+    }
+}
+
+// Unit whose clock limits the MAC of a row.
+static const char* mac_clock_unit(const CutRow& r) {
+    return (r.unit == "add") != r.mac_other_limits ? "add" : "mul";
+}
+
+static bool set_delay(const std::string& spec, Fp16StageDef<Fp16AddState>* add, Fp16StageDef<Fp16MulState>* mul) {
+    size_t dot = spec.find('.'), eq = spec.find('=');
+    if (dot == std::string::npos || eq == std::string::npos || eq < dot) return false;
+    std::string unit = spec.substr(0, dot), stage = spec.substr(dot + 1, eq - dot - 1);
+    double ns = std::stod(spec.substr(eq + 1));
+    for (uint32_t i = 0; i < FP16_STAGES; ++i) {
+        if (unit == "add" && stage == add[i].name) { add[i].delay_ns = ns; return true; }
+        if (unit == "mul" && stage == mul[i].name) { mul[i].delay_ns = ns; return true; }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t vectors = 1 << 20;
+    uint32_t out_regs = 1, acc = 1;
+    double reg_ns = 0.35;
+    std::string unit = "all", input, name = "fc", format = "table", delays;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--unit" && i + 1 < argc) unit = argv[++i];
+        else if (arg == "--input" && i + 1 < argc) input = argv[++i];
+        else if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--vectors" && i + 1 < argc) vectors = std::stoull(argv[++i]);
+        else if (arg == "--delay" && i + 1 < argc) delays = argv[++i];
+        else if (arg == "--reg-ns" && i + 1 < argc) reg_ns = std::stod(argv[++i]);
+        else if (arg == "--out-regs" && i + 1 < argc) out_regs = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--acc" && i + 1 < argc) acc = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--format" && i + 1 < argc) format = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--unit add|mul|all] [--input FILE | --workload NAME --vectors N]"
+                      << " [--delay UNIT.STAGE=NS,...] [--reg-ns R] [--out-regs O] [--acc K]"
+                      << " [--format table|csv|jsonl] [--seed S]\n";
+            return 1;
+        }
+    }
+    if ((unit != "add" && unit != "mul" && unit != "all") ||
+        (format != "table" && format != "csv" && format != "jsonl") || acc == 0) {
+        std::cerr << "Bad --unit, --format or --acc\n";
+        return 1;
+    }
+
+    Fp16StageDef<Fp16AddState> add_stages[FP16_STAGES];
+    Fp16StageDef<Fp16MulState> mul_stages[FP16_STAGES];
+    for (uint32_t i = 0; i < FP16_STAGES; ++i) {
+        add_stages[i] = fp16_add_stages()[i];
+        mul_stages[i] = fp16_mul_stages()[i];
+    }
+    std::stringstream ds(delays);
+    for (std::string spec; std::getline(ds, spec, ',');) {
+        if (!set_delay(spec, add_stages, mul_stages)) {
+            std::cerr << "Bad delay: " << spec << " (UNIT.STAGE=NS, stages:";
+            for (uint32_t i = 0; i < FP16_STAGES; ++i) std::cerr << " add." << add_stages[i].name;
+            for (uint32_t i = 0; i < FP16_STAGES; ++i) std::cerr << " mul." << mul_stages[i].name;
+            std::cerr << ")\n";
+            return 1;
+        }
+    }
+
+    std::vector<fp16_t> a, b;
+    std::string source;
+    if (!input.empty()) {
+        std::ifstream f(input, std::ios::binary);
+        std::vector<char> raw((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        if (!f.good() && !f.eof()) {
+            std::cerr << "Cannot read " << input << "\n";
+            return 1;
+        }
+        if (raw.empty() || raw.size() % 4) {
+            std::cerr << input << ": expected packed (a, b) uint16 pairs\n";
+            return 1;
+        }
+        size_t n = raw.size() / 4;
+        a.resize(n); b.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            const unsigned char* p = (const unsigned char*)raw.data() + 4 * i;
+            a[i] = (fp16_t)(p[0] | (p[1] << 8));
+            b[i] = (fp16_t)(p[2] | (p[3] << 8));
+        }
+        source = input;
+    } else {
+        Fp16Workload wl;
+        if (!fp16_workload(name, wl)) {
+            fp16_workload_unknown(name);
+            return 1;
+        }
+        wl.k = (uint32_t)vectors;
+        a.resize(vectors); b.resize(vectors);
+        Xoshiro256 g(seed);
+        fp16_workload_fill(wl, g, a.data(), b.data());
+        std::ostringstream s;
+        s << "workload " << wl.name << ", seed 0x" << std::hex << std::uppercase << seed;
+        source = s.str();
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<CutRow> rows;
+    // The MAC partner of each swept unit is the other one unstaged (cut 0).
+    double add_fmax = fp16_cut_timing(add_stages, 0, reg_ns).fmax_mhz;
+    double mul_fmax = fp16_cut_timing(mul_stages, 0, reg_ns).fmax_mhz;
+    if (unit != "mul") explore("add", add_stages, fp16_add_bittrue, a, b, reg_ns, out_regs, acc, mul_fmax, rows);
+    if (unit != "add") explore("mul", mul_stages, fp16_mul_bittrue, a, b, reg_ns, out_regs, acc, add_fmax, rows);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (format == "csv") {
+        std::cout << "unit,cut,stages,depth,latency_cycles,period_ns,fmax_mhz,latency_ns,stream_ops_per_cycle,"
+                     "stream_mops,mac_per_cycle,mac_fmax_mhz,mac_clock_unit,mac_mmacs,mismatches\n";
+        for (const CutRow& r : rows) {
+            std::cout << r.unit << "," << r.cut << "," << r.stages << "," << r.depth << "," << r.latency << ","
+                      << r.period_ns << "," << r.fmax_mhz << "," << r.latency * r.period_ns << "," << r.stream_opc
+                      << "," << r.stream_opc * r.fmax_mhz << "," << r.mac_opc << "," << r.mac_fmax_mhz << ","
+                      << mac_clock_unit(r) << "," << r.mac_opc * r.mac_fmax_mhz << "," << r.mismatches << "\n";
+        }
+        return 0;
+    }
+    if (format == "jsonl") {
+        for (const CutRow& r : rows) {
+            std::cout << "{\"unit\":\"" << r.unit << "\",\"cut\":" << r.cut << ",\"stages\":\"" << r.stages
+                      << "\",\"depth\":" << r.depth << ",\"latency_cycles\":" << r.latency << ",\"period_ns\":"
+                      << r.period_ns << ",\"fmax_mhz\":" << r.fmax_mhz << ",\"latency_ns\":"
+                      << r.latency * r.period_ns << ",\"stream_ops_per_cycle\":" << r.stream_opc
+                      << ",\"stream_mops\":" << r.stream_opc * r.fmax_mhz << ",\"mac_per_cycle\":" << r.mac_opc
+                      << ",\"mac_fmax_mhz\":" << r.mac_fmax_mhz << ",\"mac_clock_unit\":\"" << mac_clock_unit(r)
+                      << "\",\"mac_mmacs\":" << r.mac_opc * r.mac_fmax_mhz << ",\"mismatches\":" << r.mismatches
+                      << "}\n";
+        }
+        return 0;
+    }
+
+    std::cout << "Stream: " << source << ", " << a.size() << " pairs, register overhead " << reg_ns << " ns, "
+              << out_regs << " output register(s), " << acc << " accumulator(s)\n";
+    std::string last;
+    for (const CutRow& r : rows) {
+        if (r.unit != last) {
+            std::cout << "--------------------------------------------------------------------------------------------------\n"
+                      << " " << (r.unit == "add" ? "Adder" : "Multiplier") << "\n"
+                      << "--------------------------------------------------------------------------------------------------\n"
+                      << "  Stages                               | Lat | Period |   Fmax | Lat ns | Stream Mop/s | MAC/cyc | MAC clock |  MMAC/s | Check\n"
+                      << "--------------------------------------------------------------------------------------------------\n";
+            last = r.unit;
+        }
+        std::cout << "  " << std::left << std::setw(36) << r.stages << std::right << " | " << std::setw(3) << r.latency
+                  << " | " << std::fixed << std::setprecision(2) << std::setw(6) << r.period_ns << " | "
+                  << std::setprecision(1) << std::setw(6) << r.fmax_mhz << " | " << std::setprecision(2)
+                  << std::setw(6) << r.latency * r.period_ns << " | " << std::setprecision(1) << std::setw(12)
+                  << r.stream_opc * r.fmax_mhz << " | " << std::setprecision(4) << std::setw(7) << r.mac_opc << " | "
+                  << std::setprecision(1) << std::setw(5) << r.mac_fmax_mhz << " " << mac_clock_unit(r) << " | "
+                  << std::setw(7) << r.mac_opc * r.mac_fmax_mhz << " | "
+                  << (r.mismatches ? "FAIL" : "ok") << "\n";
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << "  " << std::fixed << std::setprecision(2) << sec << " s\n";
+    return 0;
+}
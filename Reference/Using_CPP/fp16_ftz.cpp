@@ -0,0 +1,172 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+#include "fp16_workload.h"
+
+// ----------------------------------------------------------------------------
+// FTZ / DAZ Accuracy Cost on Layer Workloads
+// ----------------------------------------------------------------------------
+// Usage: fp16_ftz [--workload NAME|all] [--outputs M] [--seed S] [--threads T]
+//
+// Computes M dot products per workload (fp16_workload.h) on the bit-true MAC
+// chain, acc = add(acc, mul(a, w)) in FP16, once per denormal policy
+// (IEEE, DAZ, FTZ, FTZ+DAZ; fp16_add_bittrue_policy / fp16_mul_bittrue_policy)
+// and compares every output with the exact dot product of the same FP16
+// operands. Reports the share of denormal operands, products and partial
+// sums, the relative and ULP error per policy, how many outputs differ from
+// the IEEE model and how many were flushed to zero. Outputs are generated in
+// chunks seeded from (seed, workload, chunk), so results are identical for
+// any thread count.
+
+static const uint64_t CHUNK = 64;
+static const int POLICIES = 4;
+static const char* POLICY_NAME[POLICIES] = {"IEEE", "DAZ", "FTZ", "FTZ+DAZ"};
+
+struct PolicyStats {
+    Fp16WorkloadScore err;
+    uint64_t differ = 0, flushed = 0;
+};
+
+struct WorkloadStats {
+    uint64_t operands = 0, denorm_operands = 0;
+    uint64_t products = 0, denorm_products = 0, denorm_sums = 0;
+    PolicyStats p[POLICIES];
+
+    void merge(const WorkloadStats& o) {
+        operands += o.operands; denorm_operands += o.denorm_operands;
+        products += o.products; denorm_products += o.denorm_products; denorm_sums += o.denorm_sums;
+        for (int i = 0; i < POLICIES; ++i) {
+            PolicyStats& d = p[i];
+            const PolicyStats& s = o.p[i];
+            d.err.merge(s.err);
+            d.differ += s.differ; d.flushed += s.flushed;
+        }
+    }
+};
+
+static inline bool is_denormal(fp16_t h) { return (h & 0x7C00) == 0 && (h & 0x3FF) != 0; }
+
+template <unsigned DENORM>
+static fp16_t mac_chain(const fp16_t* a, const fp16_t* w, uint32_t k, WorkloadStats* s) {
+    fp16_t acc = 0;
+    for (uint32_t i = 0; i < k; ++i) {
+        fp16_t p = fp16_mul_bittrue_policy<DENORM>(a[i], w[i]).res;
+        acc = fp16_add_bittrue_policy<DENORM>(acc, p).res;
+        if (s) {
+            s->denorm_products += is_denormal(p);
+            s->denorm_sums += is_denormal(acc);
+        }
+    }
+    return acc;
+}
+
+static void run_output(const Fp16Workload& wl, const fp16_t* a, const fp16_t* w, WorkloadStats& s) {
+    double exact = fp16_workload_exact_dot(a, w, wl.k);
+    for (uint32_t i = 0; i < wl.k; ++i) s.denorm_operands += is_denormal(a[i]) + is_denormal(w[i]);
+    s.operands += 2 * wl.k;
+    s.products += wl.k;
+
+    fp16_t out[POLICIES];
+    out[0] = mac_chain<FP16_DENORM_IEEE>(a, w, wl.k, &s);
+    out[1] = mac_chain<FP16_DENORM_DAZ>(a, w, wl.k, nullptr);
+    out[2] = mac_chain<FP16_DENORM_FTZ>(a, w, wl.k, nullptr);
+    out[3] = mac_chain<FP16_DENORM_FTZ_DAZ>(a, w, wl.k, nullptr);
+
+    for (int i = 0; i < POLICIES; ++i) {
+        PolicyStats& ps = s.p[i];
+        fp16_workload_score(ps.err, out[i], exact);
+        ps.differ += out[i] != out[0];
+        ps.flushed += (out[i] & 0x7FFF) == 0 && exact != 0;
+    }
+}
+
+static void report(const Fp16Workload& wl, const WorkloadStats& s) {
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << " " << wl.name << ": " << wl.what << " (K = " << wl.k << ", act " << (wl.act_relu ? "ReLU " : "")
+              << "N(0, " << wl.act_sigma << "), weight N(0, " << wl.w_sigma << "))\n"
+              << "  Denormal   : " << std::fixed << std::setprecision(3)
+              << 100.0 * s.denorm_operands / s.operands << " % of operands, "
+              << 100.0 * s.denorm_products / s.products << " % of products, "
+              << 100.0 * s.denorm_sums / s.products << " % of partial sums (IEEE)\n"
+              << "--------------------------------------------------------------------------------------------------\n"
+              << "  Policy   | Mean rel err | Max rel err | Mean |ULP| |  != IEEE % | Flushed to 0 %\n"
+              << "--------------------------------------------------------------------------------------------------\n";
+    for (int i = 0; i < POLICIES; ++i) {
+        const PolicyStats& p = s.p[i];
+        std::cout << "  " << std::left << std::setw(8) << POLICY_NAME[i] << std::right << " | " << std::scientific
+                  << std::setprecision(4) << std::setw(12) << p.err.mean_rel() << " | " << std::setw(11)
+                  << p.err.max_rel << " | " << std::fixed << std::setw(10) << p.err.mean_ulp() << " | "
+                  << std::setw(10) << 100.0 * p.differ / p.err.outputs << " | " << std::setw(14)
+                  << 100.0 * p.flushed / p.err.outputs << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t outputs = 4096;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string name = "all";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--outputs" && i + 1 < argc) outputs = std::stoull(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--workload NAME|all] [--outputs M] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+    if (outputs == 0) {
+        std::cerr << "--outputs must be positive\n";
+        return 1;
+    }
+
+    size_t count;
+    const Fp16Workload* all = fp16_workloads(count);
+    std::vector<size_t> run;
+    if (!fp16_workload_select(name, run)) return 1;
+
+    Fp16Pool pool(threads ? threads : 1);
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << ", " << outputs
+              << " outputs per workload, " << pool.size() << " thread(s)\n";
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t wi : run) {
+        const Fp16Workload& wl = all[wi];
+        uint64_t chunks = (outputs + CHUNK - 1) / CHUNK;
+        std::vector<WorkloadStats> part(pool.size());
+        std::vector<std::vector<fp16_t>> a(pool.size()), w(pool.size());
+        pool.parallel_for(0, chunks, 1, [&](uint64_t lo, uint64_t hi, unsigned t) {
+            a[t].resize(wl.k); w[t].resize(wl.k);
+            for (uint64_t c = lo; c < hi; ++c) {
+                Xoshiro256 g(fp16_rng_chunk_seed(seed ^ fp16_mix64(wi + 1), c));
+                uint64_t end = (c + 1) * CHUNK < outputs ? (c + 1) * CHUNK : outputs;
+                for (uint64_t o = c * CHUNK; o < end; ++o) {
+                    fp16_workload_fill(wl, g, a[t].data(), w[t].data());
+                    run_output(wl, a[t].data(), w[t].data(), part[t]);
+                }
+            }
+        });
+        WorkloadStats total;
+        for (const WorkloadStats& p : part) total.merge(p);
+        report(wl, total);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << "  " << std::fixed << std::setprecision(2) << sec << " s\n";
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_mac.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+#include "fp16_workload.h"
+
+// ----------------------------------------------------------------------------
+// FP16 vs FP32 Accumulator Accuracy on Layer Workloads
+// ----------------------------------------------------------------------------
+// Usage: fp16_mac [--workload NAME|all] [--outputs M] [--k K] [--seed S] [--threads T]
+//
+// Computes M dot products per workload (fp16_workload.h, --k overrides the
+// dot-product length) with
+//   fp16-hw       : fp16_mul_bittrue -> fp16_add_bittrue chain (current MAC)
+//   fp16-rne      : correctly rounded FP16 multiply and add (fp16_oracle.h)
+//   fp32-rz/rne   : exact product into an FP32 accumulator (fp16_mac.h),
+//                   reported as the FP32 value and rounded once to FP16
+// and compares them with the exact dot product (double). Errors are in
+// FP16 ULPs at the exact result; "CR %" is the share of FP16 outputs equal
+// to the correctly rounded (RNE) exact result. Outputs are generated in
+// chunks seeded from (seed, workload, chunk), so results are identical for
+// any thread count.
+
+static const uint64_t CHUNK = FP16_MAC_LANES;
+static const int MODELS = 6;
+static const char* MODEL_NAME[MODELS] = {"fp16-hw", "fp16-rne", "fp32-rz", "fp32-rne", "fp32-rz", "fp32-rne"};
+static const char* MODEL_OUT[MODELS] = {"FP16", "FP16", "FP32", "FP32", "FP16", "FP16"};
+
+struct ModelStats {
+    Fp16WorkloadScore err;
+    double ns = 0;
+};
+
+struct MacStats {
+    ModelStats m[MODELS];
+
+    void merge(const MacStats& o) {
+        for (int i = 0; i < MODELS; ++i) {
+            ModelStats& d = m[i];
+            const ModelStats& s = o.m[i];
+            d.err.merge(s.err);
+            d.ns += s.ns;
+        }
+    }
+};
+
+template <typename F>
+static double time_ns(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void run_chunk(uint32_t k, size_t n, const fp16_t* a, const fp16_t* w, MacStats& s) {
+    fp16_t hw[CHUNK], rne[CHUNK];
+    uint32_t rz32[CHUNK], rne32[CHUNK];
+
+    s.m[0].ns += time_ns([&] {
+        for (size_t i = 0; i < n; ++i) {
+            fp16_t acc = 0;
+            for (uint32_t j = 0; j < k; ++j) {
+                fp16_t p = fp16_mul_bittrue(a[i * k + j], w[i * k + j]).res;
+                acc = fp16_add_bittrue(acc, p).res;
+            }
+            hw[i] = acc;
+        }
+    });
+    s.m[1].ns += time_ns([&] {
+        for (size_t i = 0; i < n; ++i) {
+            fp16_t acc = 0;
+            for (uint32_t j = 0; j < k; ++j) {
+                fp16_t p = (fp16_t)fp16_oracle_mul_packed<FP16_ROUND_RNE>(a[i * k + j], w[i * k + j]);
+                acc = (fp16_t)fp16_oracle_add_packed<FP16_ROUND_RNE>(acc, p);
+            }
+            rne[i] = acc;
+        }
+    });
+    s.m[2].ns += time_ns([&] { fp16_mac_dot_simd<FP16_ROUND_RZ>(a, w, k, n, rz32); });
+    s.m[3].ns += time_ns([&] { fp16_mac_dot_simd<FP16_ROUND_RNE>(a, w, k, n, rne32); });
+
+    for (size_t i = 0; i < n; ++i) {
+        double exact = fp16_workload_exact_dot(a + i * k, w + i * k, k);
+        fp16_t out16[MODELS] = {hw[i], rne[i], 0, 0, (fp16_t)fp16_mac_to_fp16<FP16_ROUND_RZ>(rz32[i]),
+                                (fp16_t)fp16_mac_to_fp16<FP16_ROUND_RNE>(rne32[i])};
+        for (int m = 0; m < MODELS; ++m) {
+            if (m == 2) fp16_workload_score_value(s.m[m].err, fp16_mac_float(rz32[i]), exact);
+            else if (m == 3) fp16_workload_score_value(s.m[m].err, fp16_mac_float(rne32[i]), exact);
+            else fp16_workload_score(s.m[m].err, out16[m], exact);
+        }
+    }
+}
+
+static void report(const Fp16Workload& wl, uint32_t k, const MacStats& s) {
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << " " << wl.name << ": " << wl.what << " (K = " << k << ")\n"
+              << "--------------------------------------------------------------------------------------------------\n"
+              << "  Accumulator | Output | Mean rel err | Max rel err | Mean |ULP| |    CR % | ns / MAC\n"
+              << "--------------------------------------------------------------------------------------------------\n";
+    for (int i = 0; i < MODELS; ++i) {
+        const ModelStats& p = s.m[i];
+        std::cout << "  " << std::left << std::setw(11) << MODEL_NAME[i] << " | " << std::setw(6) << MODEL_OUT[i]
+                  << std::right << " | " << std::scientific << std::setprecision(4) << std::setw(12)
+                  << p.err.mean_rel() << " | " << std::setw(11) << p.err.max_rel << " | " << std::fixed
+                  << std::setw(10) << p.err.mean_ulp() << " | ";
+        if (i == 2 || i == 3) std::cout << "      -";
+        else std::cout << std::setprecision(2) << std::setw(7) << p.err.cr_percent();
+        std::cout << " | ";
+        if (i < 4) std::cout << std::setprecision(2) << std::setw(8) << p.ns / ((double)p.err.outputs * k);
+        else std::cout << "       -";
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t outputs = 4096;
+    uint32_t k_override = 0;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string name = "all";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--outputs" && i + 1 < argc) outputs = std::stoull(argv[++i]);
+        else if (arg == "--k" && i + 1 < argc) k_override = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--workload NAME|all] [--outputs M] [--k K] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+
+    size_t count;
+    const Fp16Workload* all = fp16_workloads(count);
+    std::vector<size_t> run;
+    if (!fp16_workload_select(name, run)) return 1;
+
+    Fp16Pool pool(threads ? threads : 1);
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << ", " << outputs
+              << " outputs per workload, " << pool.size() << " thread(s)\n";
+
+    for (size_t wi : run) {
+        Fp16Workload wl = all[wi];
+        if (k_override) wl.k = k_override;
+        uint64_t chunks = (outputs + CHUNK - 1) / CHUNK;
+        std::vector<MacStats> part(pool.size());
+        std::vector<std::vector<fp16_t>> a(pool.size()), w(pool.size());
+        pool.parallel_for(0, chunks, 1, [&](uint64_t lo, uint64_t hi, unsigned t) {
+            a[t].resize(CHUNK * wl.k); w[t].resize(CHUNK * wl.k);
+            for (uint64_t c = lo; c < hi; ++c) {
+                Xoshiro256 g(fp16_rng_chunk_seed(seed ^ fp16_mix64(wi + 1), c));
+                size_t n = (c + 1) * CHUNK < outputs ? CHUNK : (size_t)(outputs - c * CHUNK);
+                for (size_t o = 0; o < n; ++o) {
+                    fp16_workload_fill(wl, g, a[t].data() + o * wl.k, w[t].data() + o * wl.k);
+                }
+                run_chunk(wl.k, n, a[t].data(), w[t].data(), part[t]);
+            }
+        });
+        MacStats total;
+        for (const MacStats& p : part) total.merge(p);
+        report(wl, wl.k, total);
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------\n";
+    return 0;
+}
@@ -0,0 +1,215 @@
+#ifndef FP16_MAC_H
+#define FP16_MAC_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "fp16_common.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Mixed-Precision MAC: FP16 x FP16 -> FP32 Accumulate
+// ----------------------------------------------------------------------------
+// Bit-true model of a MAC that multiplies in FP16 and accumulates in FP32:
+//   product : the full 11 x 11 = 22-bit significand product. With exponents
+//             in [-48, 31] it always fits an FP32 normal, so the product is
+//             passed on exactly (fp16_mul_bittrue keeps only 10 bits).
+//   add     : IEEE FP32 adder with guard, round and sticky bits, subnormals
+//             and one rounding in the selected Fp16Round mode (RZ, RNE,
+//             RU, RD).
+// Accumulators are FP32 bit patterns (uint32_t); NaN results are the
+// canonical 0x7FC00000. Flags are not modeled: overflow and invalid
+// operations show up as Inf / NaN in the accumulator. fp16_mac_to_fp16
+// rounds a finished accumulator to the FP16 output once.
+//
+// All kernels are branch-free so the batch dot product vectorizes across
+// outputs (build with -O3 -march=native).
+
+// Exact FP16 product as FP32 bits.
+inline uint32_t fp16_mac_product(uint32_t a, uint32_t b) {
+    uint32_t e1 = (a >> 10) & 0x1F, f1 = a & 0x3FF;
+    uint32_t e2 = (b >> 10) & 0x1F, f2 = b & 0x3FF;
+    uint32_t sign = ((a ^ b) & 0x8000u) << 16;
+
+    uint32_t a_inf  = (e1 == 31) & (f1 == 0), b_inf  = (e2 == 31) & (f2 == 0);
+    uint32_t a_zero = (e1 == 0) & (f1 == 0),  b_zero = (e2 == 0) & (f2 == 0);
+    uint32_t is_nan = ((e1 == 31) & (f1 != 0)) | ((e2 == 31) & (f2 != 0)) | (a_inf & b_zero) | (b_inf & a_zero);
+    uint32_t is_inf = a_inf | b_inf;
+
+    // value = p * 2^(E1 + E2 - 50), E = max(e, 1). The int -> float
+    // conversion of p (< 2^22, exact) normalizes it; the exponent field is
+    // then moved by E1 + E2 - 50, which keeps it in [79, 158].
+    uint32_t p = (f1 | ((e1 != 0) << 10)) * (f2 | ((e2 != 0) << 10));
+    float pf = (float)(int32_t)p;
+    uint32_t pb;
+    std::memcpy(&pb, &pf, 4);
+    int32_t shift = (int32_t)((e1 | (e1 == 0)) + (e2 | (e2 == 0))) - 50;
+    uint32_t r = sign | (pb + (uint32_t)(shift * (1 << 23)));
+
+    r = fp16_sel(p == 0, sign, r);
+    r = fp16_sel(is_inf, sign | 0x7F800000u, r);
+    r = fp16_sel(is_nan, 0x7FC00000u, r);
+    return r;
+}
+
+// IEEE FP32 addition x + y in mode MODE.
+template <Fp16Round MODE>
+inline uint32_t fp32_add_bittrue(uint32_t x, uint32_t y) {
+    uint32_t ax = x & 0x7FFFFFFFu, ay = y & 0x7FFFFFFFu;
+    uint32_t is_nan = (ax > 0x7F800000u) | (ay > 0x7F800000u) |
+                      ((ax == 0x7F800000u) & (ay == 0x7F800000u) & ((x ^ y) >> 31));
+
+    // Swap so that |big| >= |small|
+    uint32_t swap  = ay > ax;
+    uint32_t big   = fp16_sel(swap, y, x);
+    uint32_t small = fp16_sel(swap, x, y);
+    uint32_t sign  = big >> 31;
+    uint32_t sub   = (big ^ small) >> 31;
+    uint32_t eb = (big >> 23) & 0xFF, es = (small >> 23) & 0xFF;
+    uint32_t mb = (big & 0x7FFFFF) | ((eb != 0) << 23);
+    uint32_t ms = (small & 0x7FFFFF) | ((es != 0) << 23);
+    uint32_t Eb = eb | (eb == 0), Es = es | (es == 0);
+
+    // Align with 3 extra bits (guard, round, sticky)
+    uint32_t d = Eb - Es;
+    d = fp16_sel(d > 31, 31, d);
+    uint32_t xs = ms << 3;
+    uint32_t sticky = ((xs << (31 - d)) << 1) != 0;
+    uint32_t al = (xs >> d) | sticky;
+    uint32_t S = fp16_sel(sub, (mb << 3) - al, (mb << 3) + al); // < 2^28
+
+    // S = sum * 2^(153 - Eb); t = position of its leading one (the int ->
+    // double conversion is exact for S < 2^53; S | 1 keeps t >= 0 for S = 0)
+    double sd = (double)(int32_t)(S | 1);
+    uint64_t sbits;
+    std::memcpy(&sbits, &sd, 8);
+    int32_t t  = (int32_t)((sbits >> 52) & 0x7FF) - 1023;
+    int32_t eR = t + (int32_t)Eb - 26; // biased result exponent
+    uint32_t tiny = eR < 1;
+
+    // Keep 24 bits (normal) or the bits down to 2^-149 (subnormal): drop
+    // sh bits of S, or shift it left when cancellation lost leading bits.
+    int32_t sh = (int32_t)fp16_sel(tiny, (uint32_t)(4 - (int32_t)Eb), (uint32_t)(t - 23));
+    uint32_t rsh = (uint32_t)fp16_sel(sh > 0, (uint32_t)sh, 0);
+    uint32_t lsh = (uint32_t)fp16_sel(sh < 0, (uint32_t)-sh, 0);
+    uint32_t q   = (S >> rsh) << lsh;
+    uint32_t rem = (S << (31 - rsh)) << 1; // dropped bits, rounding point at 2^31
+
+    // Normal: q carries the hidden bit, which the -1 folds into the exponent
+    uint32_t base = fp16_sel(tiny, q, ((uint32_t)(eR - 1) << 23) + q);
+    uint32_t inexact = rem != 0;
+    uint32_t inc;
+    if (MODE == FP16_ROUND_RZ) inc = 0;
+    else if (MODE == FP16_ROUND_RNE) inc = (rem > 0x80000000u) | ((rem == 0x80000000u) & base);
+    else if (MODE == FP16_ROUND_RU) inc = inexact & (sign ^ 1);
+    else inc = inexact & sign;
+    uint32_t mag = base + (inc & 1);
+
+    uint32_t to_inf = (MODE == FP16_ROUND_RNE) | ((MODE == FP16_ROUND_RU) & (sign ^ 1)) |
+                      ((MODE == FP16_ROUND_RD) & sign);
+    mag = fp16_sel(mag >= 0x7F800000u, fp16_sel(to_inf, 0x7F800000u, 0x7F7FFFFFu), mag);
+    uint32_t r = (sign << 31) | mag;
+
+    // Exact zero: -0 only for -0 + -0, or for cancellation under RD
+    uint32_t zero_sign = fp16_sel(sub, MODE == FP16_ROUND_RD, sign);
+    r = fp16_sel(S == 0, zero_sign << 31, r);
+    r = fp16_sel(eb == 0xFF, big, r);
+    r = fp16_sel(is_nan, 0x7FC00000u, r);
+    return r;
+}
+
+// One MAC step: acc + a * b.
+template <Fp16Round MODE>
+inline uint32_t fp16_mac_fp32(uint32_t acc, fp16_t a, fp16_t b) {
+    return fp32_add_bittrue<MODE>(acc, fp16_mac_product(a, b));
+}
+
+inline float fp16_mac_float(uint32_t acc) {
+    float f;
+    std::memcpy(&f, &acc, 4);
+    return f;
+}
+
+// Rounds a finished FP32 accumulator to FP16. Returns res | flags << 16
+// (fp16_oracle_round semantics).
+template <Fp16Round MODE>
+inline uint32_t fp16_mac_to_fp16(uint32_t acc) {
+    return fp16_oracle_round<MODE>((double)fp16_mac_float(acc));
+}
+
+// ----------------------------------------------------------------------------
+// Dot Products
+// ----------------------------------------------------------------------------
+// acc + sum a[j] * b[j], accumulated in order j = 0 .. k-1 like the MAC
+// pipeline does.
+template <Fp16Round MODE>
+inline uint32_t fp16_mac_dot(const fp16_t* a, const fp16_t* b, size_t k, uint32_t acc = 0) {
+    for (size_t j = 0; j < k; ++j) acc = fp16_mac_fp32<MODE>(acc, a[j], b[j]);
+    return acc;
+}
+
+static const size_t FP16_MAC_LANES = 64; // outputs per vectorized block
+static const size_t FP16_MAC_TILE  = 32; // k values transposed per step
+
+// n independent dot products of length k: out[i] = dot(a + i*k, b + i*k).
+// Bit-identical to fp16_mac_dot per output. Blocks of FP16_MAC_LANES
+// outputs are transposed tile by tile so the inner loop runs across
+// outputs and vectorizes.
+template <Fp16Round MODE>
+inline void fp16_mac_dot_simd(const fp16_t* __restrict a, const fp16_t* __restrict b, size_t k, size_t n,
+                              uint32_t* __restrict out) {
+    alignas(64) fp16_t ta[FP16_MAC_TILE][FP16_MAC_LANES];
+    alignas(64) fp16_t tb[FP16_MAC_TILE][FP16_MAC_LANES];
+    alignas(64) uint32_t acc[FP16_MAC_LANES];
+    for (size_t i0 = 0; i0 < n; i0 += FP16_MAC_LANES) {
+        size_t m = n - i0 < FP16_MAC_LANES ? n - i0 : FP16_MAC_LANES;
+        for (size_t i = 0; i < FP16_MAC_LANES; ++i) acc[i] = 0;
+        if (m < FP16_MAC_LANES) {
+            std::memset(ta, 0, sizeof(ta));
+            std::memset(tb, 0, sizeof(tb));
+        }
+        for (size_t j0 = 0; j0 < k; j0 += FP16_MAC_TILE) {
+            size_t jn = k - j0 < FP16_MAC_TILE ? k - j0 : FP16_MAC_TILE;
+            for (size_t i = 0; i < m; ++i) {
+                const fp16_t* ra = a + (i0 + i) * k + j0;
+                const fp16_t* rb = b + (i0 + i) * k + j0;
+                for (size_t j = 0; j < jn; ++j) {
+                    ta[j][i] = ra[j];
+                    tb[j][i] = rb[j];
+                }
+            }
+            for (size_t j = 0; j < jn; ++j) {
+                for (size_t i = 0; i < FP16_MAC_LANES; ++i) {
+                    acc[i] = fp32_add_bittrue<MODE>(acc[i], fp16_mac_product(ta[j][i], tb[j][i]));
+                }
+            }
+        }
+        for (size_t i = 0; i < m; ++i) out[i0 + i] = acc[i];
+    }
+}
+
+inline void fp16_mac_dot_batch(Fp16Round mode, const fp16_t* a, const fp16_t* b, size_t k, size_t n,
+                               uint32_t* out) {
+    switch (mode) {
+    case FP16_ROUND_RNE: fp16_mac_dot_simd<FP16_ROUND_RNE>(a, b, k, n, out); break;
+    case FP16_ROUND_RU:  fp16_mac_dot_simd<FP16_ROUND_RU>(a, b, k, n, out); break;
+    case FP16_ROUND_RD:  fp16_mac_dot_simd<FP16_ROUND_RD>(a, b, k, n, out); break;
+    default:             fp16_mac_dot_simd<FP16_ROUND_RZ>(a, b, k, n, out); break;
+    }
+}
+
+// fp16_mac_dot_batch over n outputs in blocks of FP16_MAC_LANES on a
+// work-stealing pool.
+inline void fp16_mac_dot_parallel(Fp16Pool& pool, Fp16Round mode, const fp16_t* a, const fp16_t* b, size_t k,
+                                  size_t n, uint32_t* out) {
+    uint64_t blocks = (n + FP16_MAC_LANES - 1) / FP16_MAC_LANES;
+    pool.parallel_for(0, blocks, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        size_t first = (size_t)lo * FP16_MAC_LANES;
+        size_t last = (size_t)hi * FP16_MAC_LANES < n ? (size_t)hi * FP16_MAC_LANES : n;
+        fp16_mac_dot_batch(mode, a + first * k, b + first * k, k, last - first, out + first);
+    });
+}
+
+#endif // FP16_MAC_H
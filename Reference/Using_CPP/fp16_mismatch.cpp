@@ -0,0 +1,180 @@
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#include "fp16_diff.h"
+#include "fp16_mismatch_index.h"
+
+// ----------------------------------------------------------------------------
+// Mismatch Index Builder / Query Tool
+// ----------------------------------------------------------------------------
+// Usage: fp16_mismatch --build FILE [--op add|mul] [--model NAME] [--round rz|rne|ru|rd]
+//                      [--verdict mismatch|rounding|any] [--threads T]
+//        fp16_mismatch --index FILE [--stats] [--row A [--limit K]] [--query A,B ...]
+//
+// --build sweeps all 2^32 pairs of a fp16_diff.h model (default simd) against
+// the exact oracle (fp16_oracle.h) and saves the pairs with the selected
+// verdicts as a compressed index (fp16_mismatch_index.h). --index loads one
+// and answers queries without rerunning the sweep:
+//   --stats   : pair count, container mix, size and the densest rows
+//   --row A   : the b values of row A (first K, default 32)
+//   --query   : membership of (A, B) plus the recomputed explanation
+// Operands are hex or decimal (0x3C00 or 15360).
+
+static bool parse_pair(const std::string& s, fp16_t& a, fp16_t& b) {
+    size_t comma = s.find(',');
+    if (comma == std::string::npos) return false;
+    a = (fp16_t)std::stoul(s.substr(0, comma), nullptr, 0);
+    b = (fp16_t)std::stoul(s.substr(comma + 1), nullptr, 0);
+    return true;
+}
+
+static void print_stats(const Fp16MismatchIndex& idx) {
+    uint64_t type_rows[3] = {0, 0, 0}, used = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> dense;
+    for (uint32_t a = 0; a < 65536; ++a) {
+        const Fp16MismatchIndex::Row& r = idx.row((fp16_t)a);
+        if (!r.count) continue;
+        used++;
+        type_rows[r.type]++;
+        dense.push_back({r.count, a});
+    }
+    std::sort(dense.begin(), dense.end(), [](const std::pair<uint32_t, uint32_t>& x,
+                                             const std::pair<uint32_t, uint32_t>& y) {
+        return x.first != y.first ? x.first > y.first : x.second < y.second;
+    });
+    uint64_t n = idx.size();
+    std::cout << "  Pairs      : " << n << " (" << std::fixed << std::setprecision(4)
+              << 100.0 * n / 4294967296.0 << " % of 2^32)\n";
+    std::cout << "  Rows       : " << used << " non-empty (array " << type_rows[FP16_MIX_ARRAY] << ", bitmap "
+              << type_rows[FP16_MIX_BITMAP] << ", runs " << type_rows[FP16_MIX_RUNS] << ")\n";
+    std::cout << "  Size       : " << idx.bytes() << " bytes (" << std::setprecision(3)
+              << (n ? 8.0 * idx.bytes() / n : 0.0) << " bits per pair)\n";
+    std::cout << "  Densest    :";
+    for (size_t k = 0; k < dense.size() && k < 8; ++k) {
+        std::cout << " 0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << dense[k].second
+                  << std::dec << std::nouppercase << std::setfill(' ') << " (" << dense[k].first << ")";
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char** argv) {
+    std::string build, index, op = "add", model = "simd", verdict = "mismatch";
+    Fp16Round round = FP16_ROUND_RZ;
+    unsigned threads = std::thread::hardware_concurrency();
+    bool stats = false;
+    int row = -1;
+    size_t limit = 32;
+    std::vector<std::string> queries;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--build" && i + 1 < argc) build = argv[++i];
+        else if (arg == "--index" && i + 1 < argc) index = argv[++i];
+        else if (arg == "--op" && i + 1 < argc) op = argv[++i];
+        else if (arg == "--model" && i + 1 < argc) model = argv[++i];
+        else if (arg == "--round" && i + 1 < argc && fp16_round_mode(argv[i + 1], round)) ++i;
+        else if (arg == "--verdict" && i + 1 < argc) verdict = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else if (arg == "--stats") stats = true;
+        else if (arg == "--row" && i + 1 < argc) row = (int)(std::stoul(argv[++i], nullptr, 0) & 0xFFFF);
+        else if (arg == "--limit" && i + 1 < argc) limit = std::stoull(argv[++i]);
+        else if (arg == "--query" && i + 1 < argc) queries.push_back(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " --build FILE [--op add|mul] [--model NAME] [--round rz|rne|ru|rd]\n"
+                      << "                     [--verdict mismatch|rounding|any] [--threads T]\n"
+                      << "       " << argv[0] << " --index FILE [--stats] [--row A [--limit K]] [--query A,B ...]\n";
+            return 1;
+        }
+    }
+    if (build.empty() == index.empty()) {
+        std::cerr << "Give exactly one of --build FILE or --index FILE\n";
+        return 1;
+    }
+
+    Fp16MismatchIndex idx;
+    if (!build.empty()) {
+        if (op != "add" && op != "mul") {
+            std::cerr << "Invalid --op: " << op << "\n";
+            return 1;
+        }
+        if (verdict == "mismatch") idx.verdicts = FP16_MIX_MISMATCH;
+        else if (verdict == "rounding") idx.verdicts = FP16_MIX_ROUNDING;
+        else if (verdict == "any") idx.verdicts = FP16_MIX_MISMATCH | FP16_MIX_ROUNDING;
+        else {
+            std::cerr << "Invalid --verdict: " << verdict << "\n";
+            return 1;
+        }
+        Fp16DiffModel m;
+        if (!fp16_diff_model(op, model, m)) {
+            std::cerr << "Unknown " << op << " model: " << model << "\n";
+            return 1;
+        }
+        idx.mul = op == "mul";
+        idx.round = round;
+        idx.model = m.name;
+
+        Fp16Pool pool(threads ? threads : 1);
+        auto t0 = std::chrono::steady_clock::now();
+        fp16_mismatch_build(pool, idx, m.kernel);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (!idx.save(build)) {
+            std::cerr << "Cannot write " << build << "\n";
+            return 1;
+        }
+        std::cout << "Built " << build << ": " << op << ", model " << idx.model << " vs oracle "
+                  << fp16_round_name(round) << ", verdict " << verdict << ", " << pool.size() << " thread(s), "
+                  << std::fixed << std::setprecision(2) << sec << " s\n";
+        print_stats(idx);
+        return 0;
+    }
+
+    if (!idx.load(index)) {
+        std::cerr << "Cannot read index " << index << "\n";
+        return 1;
+    }
+    Fp16DiffModel m;
+    if (!fp16_diff_model(idx.mul ? "mul" : "add", idx.model, m)) {
+        std::cerr << "Index model " << idx.model << " is not registered\n";
+        return 1;
+    }
+    std::cout << "Index " << index << ": " << (idx.mul ? "mul" : "add") << ", model " << idx.model
+              << " vs oracle " << fp16_round_name(idx.round) << "\n";
+    if (stats) print_stats(idx);
+
+    if (row >= 0) {
+        std::cout << "Row 0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << row << std::dec
+                  << std::nouppercase << std::setfill(' ') << ": " << idx.row_count((fp16_t)row) << " pairs\n";
+        size_t shown = 0;
+        idx.for_each_in_row((fp16_t)row, [&](fp16_t b) {
+            if (shown++ >= limit) return;
+            std::cout << (shown % 8 == 1 ? "  " : " ") << "0x" << std::hex << std::uppercase << std::setw(4)
+                      << std::setfill('0') << b << std::dec << std::nouppercase << std::setfill(' ') << (shown % 8 == 0 ? "\n" : "");
+        });
+        if (shown && std::min(shown, limit) % 8) std::cout << "\n";
+    }
+
+    for (const std::string& q : queries) {
+        fp16_t a, b;
+        if (!parse_pair(q, a, b)) {
+            std::cerr << "Invalid --query (expected A,B): " << q << "\n";
+            return 1;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        bool hit = idx.contains(a, b);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "--------------------------------------------------------------------------------------------------\n"
+                  << " 0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << a << (idx.mul ? " * " : " + ")
+                  << "0x" << std::setw(4) << b << std::dec << std::nouppercase << std::setfill(' ') << ": "
+                  << (hit ? "in index" : "not in index") << " (lookup " << std::fixed << std::setprecision(2)
+                  << us << " us)\n";
+        std::cout.unsetf(std::ios::floatfield);
+        fp16_mismatch_explain(std::cout, idx, m.kernel, a, b);
+    }
+    return 0;
+}
@@ -0,0 +1,313 @@
+#ifndef FP16_MISMATCH_INDEX_H
+#define FP16_MISMATCH_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_ulp.h"
+#include "fpadder_rtl.h"
+
+// ----------------------------------------------------------------------------
+// Mismatch Index
+// ----------------------------------------------------------------------------
+// Compact set of the operand pairs (a, b) on which a model disagrees with the
+// exact oracle, kept after an exhaustive sweep so single pairs can be looked
+// up without rerunning it. Roaring-style layout: the key is a << 16 | b, and
+// every row a owns one container of its b values, whichever is smallest:
+//   array  : sorted uint16 b values               (2 bytes per pair)
+//   bitmap : 65536 bits as 4096 uint16 words      (8 KiB)
+//   runs   : sorted (start, length - 1) pairs     (4 bytes per run)
+// Membership is a binary search or one bit test inside the row; rows are
+// iterated in increasing b order.
+//
+// File format (host byte order): "FP16MIX1", op (0 add, 1 mul), round,
+// verdict mask, model name length + bytes, uint64 total, then for each of
+// the 65536 rows: uint32 count, uint8 container type, uint32 word count and
+// the uint16 words.
+
+enum Fp16MixContainer : uint8_t { FP16_MIX_ARRAY, FP16_MIX_BITMAP, FP16_MIX_RUNS };
+
+// Verdicts stored by an index (bit per Fp16Verdict).
+enum : uint8_t {
+    FP16_MIX_ROUNDING = 1 << FP16_VERDICT_ROUNDING,
+    FP16_MIX_MISMATCH = 1 << FP16_VERDICT_MISMATCH
+};
+
+class Fp16MismatchIndex {
+public:
+    struct Row {
+        uint32_t count = 0;
+        uint8_t type = FP16_MIX_ARRAY;
+        std::vector<uint16_t> data;
+    };
+
+    // What the index was built from.
+    bool mul = false;
+    Fp16Round round = FP16_ROUND_RZ;
+    uint8_t verdicts = FP16_MIX_MISMATCH;
+    std::string model;
+
+    Fp16MismatchIndex() : rows_(65536) {}
+
+    // Row a from its sorted b values (replaces any previous content).
+    void set_row(fp16_t a, const uint16_t* b, uint32_t n) {
+        Row& r = rows_[a];
+        uint32_t runs = 0;
+        for (uint32_t i = 0; i < n; ++i) runs += (i == 0 || b[i] != b[i - 1] + 1);
+        size_t array_words = n, run_words = 2 * (size_t)runs;
+
+        r.count = n;
+        r.data.clear();
+        if (run_words < array_words && run_words < 4096) {
+            r.type = FP16_MIX_RUNS;
+            for (uint32_t i = 0; i < n;) {
+                uint32_t j = i;
+                while (j + 1 < n && b[j + 1] == b[j] + 1) ++j;
+                r.data.push_back(b[i]);
+                r.data.push_back((uint16_t)(j - i));
+                i = j + 1;
+            }
+        } else if (array_words <= 4096) {
+            r.type = FP16_MIX_ARRAY;
+            r.data.assign(b, b + n);
+        } else {
+            r.type = FP16_MIX_BITMAP;
+            r.data.assign(4096, 0);
+            for (uint32_t i = 0; i < n; ++i) r.data[b[i] >> 4] |= (uint16_t)(1u << (b[i] & 15));
+        }
+        r.data.shrink_to_fit();
+    }
+
+    bool contains(fp16_t a, fp16_t b) const {
+        const Row& r = rows_[a];
+        if (r.count == 0) return false;
+        if (r.type == FP16_MIX_BITMAP) return (r.data[b >> 4] >> (b & 15)) & 1;
+        if (r.type == FP16_MIX_ARRAY) {
+            size_t lo = 0, hi = r.data.size();
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (r.data[mid] < b) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo < r.data.size() && r.data[lo] == b;
+        }
+        // Runs: last run starting at or before b.
+        size_t lo = 0, hi = r.data.size() / 2;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (r.data[2 * mid] <= b) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo > 0 && b - r.data[2 * (lo - 1)] <= r.data[2 * (lo - 1) + 1];
+    }
+
+    uint32_t row_count(fp16_t a) const { return rows_[a].count; }
+    const Row& row(fp16_t a) const { return rows_[a]; }
+
+    // f(b) for every b of row a, increasing.
+    template <typename F>
+    void for_each_in_row(fp16_t a, F f) const {
+        const Row& r = rows_[a];
+        if (r.type == FP16_MIX_ARRAY) {
+            for (uint16_t b : r.data) f((fp16_t)b);
+        } else if (r.type == FP16_MIX_RUNS) {
+            for (size_t i = 0; i < r.data.size(); i += 2) {
+                for (uint32_t b = r.data[i]; b <= (uint32_t)r.data[i] + r.data[i + 1]; ++b) f((fp16_t)b);
+            }
+        } else {
+            for (uint32_t w = 0; w < 4096; ++w) {
+                for (uint32_t bits = r.data[w]; bits; bits &= bits - 1) f((fp16_t)(w * 16 + __builtin_ctz(bits)));
+            }
+        }
+    }
+
+    uint64_t size() const {
+        uint64_t n = 0;
+        for (const Row& r : rows_) n += r.count;
+        return n;
+    }
+
+    // Payload bytes (container words only).
+    uint64_t bytes() const {
+        uint64_t n = 0;
+        for (const Row& r : rows_) n += 2 * (uint64_t)r.data.size();
+        return n;
+    }
+
+    bool save(const std::string& path) const {
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        uint8_t head[4] = {(uint8_t)mul, (uint8_t)round, verdicts, (uint8_t)model.size()};
+        uint64_t total = size();
+        bool ok = std::fwrite("FP16MIX1", 1, 8, f) == 8 && std::fwrite(head, 1, 4, f) == 4 &&
+                  std::fwrite(model.data(), 1, head[3], f) == head[3] && std::fwrite(&total, 8, 1, f) == 1;
+        for (uint32_t a = 0; ok && a < 65536; ++a) {
+            const Row& r = rows_[a];
+            uint32_t words = (uint32_t)r.data.size();
+            ok = std::fwrite(&r.count, 4, 1, f) == 1 && std::fwrite(&r.type, 1, 1, f) == 1 &&
+                 std::fwrite(&words, 4, 1, f) == 1 &&
+                 (words == 0 || std::fwrite(r.data.data(), 2, words, f) == words);
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+
+    bool load(const std::string& path) {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        char magic[8];
+        uint8_t head[4];
+        uint64_t total = 0;
+        bool ok = std::fread(magic, 1, 8, f) == 8 && std::memcmp(magic, "FP16MIX1", 8) == 0 &&
+                  std::fread(head, 1, 4, f) == 4 && head[1] <= FP16_ROUND_RD;
+        if (ok) {
+            mul = head[0] != 0;
+            round = (Fp16Round)head[1];
+            verdicts = head[2];
+            model.assign(head[3], '\0');
+            ok = (head[3] == 0 || std::fread(&model[0], 1, head[3], f) == head[3]) &&
+                 std::fread(&total, 8, 1, f) == 1;
+        }
+        for (uint32_t a = 0; ok && a < 65536; ++a) {
+            Row& r = rows_[a];
+            uint32_t words = 0;
+            ok = std::fread(&r.count, 4, 1, f) == 1 && std::fread(&r.type, 1, 1, f) == 1 &&
+                 std::fread(&words, 4, 1, f) == 1 &&
+                 (r.type == FP16_MIX_BITMAP ? words == 4096
+                  : r.type == FP16_MIX_ARRAY ? words == r.count && words <= 4096
+                  : r.type == FP16_MIX_RUNS && words % 2 == 0 && words < 4096);
+            if (!ok) break;
+            r.data.resize(words);
+            ok = words == 0 || std::fread(r.data.data(), 2, words, f) == words;
+        }
+        std::fclose(f);
+        return ok && size() == total;
+    }
+
+private:
+    std::vector<Row> rows_;
+};
+
+// ----------------------------------------------------------------------------
+// Build: exhaustive sweep of a model against the oracle
+// ----------------------------------------------------------------------------
+// One pool task per row a; each row is written by exactly one worker, so the
+// index needs no merge and is identical for any thread count.
+inline void fp16_mismatch_build(Fp16Pool& pool, Fp16MismatchIndex& idx, Fp16BinaryKernel kernel) {
+    std::vector<fp16_t> b(65536);
+    for (uint32_t i = 0; i < 65536; ++i) b[i] = (fp16_t)i;
+
+    struct Scratch {
+        std::vector<fp16_t> a, hw, ref, rz;
+        std::vector<uint8_t> hw_f, ref_f, rz_f;
+        std::vector<uint16_t> keys;
+    };
+    std::vector<Scratch> sc(pool.size());
+    pool.parallel_for(0, 65536, 1, [&](uint64_t lo, uint64_t hi, unsigned t) {
+        Scratch& s = sc[t];
+        if (s.a.empty()) {
+            s.a.resize(65536); s.hw.resize(65536); s.ref.resize(65536); s.rz.resize(65536);
+            s.hw_f.resize(65536); s.ref_f.resize(65536); s.rz_f.resize(65536); s.keys.resize(65536);
+        }
+        for (uint64_t row = lo; row < hi; ++row) {
+            std::fill(s.a.begin(), s.a.end(), (fp16_t)row);
+            kernel(s.a.data(), b.data(), s.hw.data(), s.hw_f.data(), 65536);
+            if (idx.mul) {
+                fp16_oracle_mul_batch(idx.round, s.a.data(), b.data(), s.ref.data(), s.ref_f.data(), 65536);
+                fp16_oracle_mul_simd<FP16_ROUND_RZ>(s.a.data(), b.data(), s.rz.data(), s.rz_f.data(), 65536);
+            } else {
+                fp16_oracle_add_batch(idx.round, s.a.data(), b.data(), s.ref.data(), s.ref_f.data(), 65536);
+                fp16_oracle_add_simd<FP16_ROUND_RZ>(s.a.data(), b.data(), s.rz.data(), s.rz_f.data(), 65536);
+            }
+            uint32_t n = 0;
+            for (uint32_t j = 0; j < 65536; ++j) {
+                if (s.hw[j] == s.ref[j]) continue;
+                Fp16Verdict v = fp16_oracle_classify(s.hw[j], s.hw_f[j], s.ref[j], s.ref_f[j], s.rz[j], s.rz_f[j]);
+                if (idx.verdicts & (1u << v)) s.keys[n++] = (uint16_t)j;
+            }
+            idx.set_row((fp16_t)row, s.keys.data(), n);
+        }
+    });
+}
+
+// ----------------------------------------------------------------------------
+// Explain: why does (a, b) mismatch?
+// ----------------------------------------------------------------------------
+// Recomputes the pair on the model and the oracle and prints the operands,
+// both results with flags, the verdict and the ULP error; for the adder also
+// the fpadder.v datapath signals (fpadder_rtl.h).
+inline void fp16_mismatch_explain(std::ostream& os, const Fp16MismatchIndex& idx, Fp16BinaryKernel kernel,
+                                  fp16_t a, fp16_t b) {
+    std::ios saved(nullptr);
+    saved.copyfmt(os);
+    fp16_t hw, ref, rz;
+    uint8_t hw_f, ref_f, rz_f;
+    kernel(&a, &b, &hw, &hw_f, 1);
+    BitTrueResult r = idx.mul ? fp16_oracle_mul(a, b, idx.round) : fp16_oracle_add(a, b, idx.round);
+    BitTrueResult z = idx.mul ? fp16_oracle_mul(a, b, FP16_ROUND_RZ) : fp16_oracle_add(a, b, FP16_ROUND_RZ);
+    ref = r.res; ref_f = pack_flags(r);
+    rz = z.res; rz_f = pack_flags(z);
+    Fp16Verdict v = fp16_oracle_classify(hw, hw_f, ref, ref_f, rz, rz_f);
+
+    double da = fp16_oracle_to_double(a), db = fp16_oracle_to_double(b);
+    double x = idx.mul ? da * db : da + db;
+    auto hex = [&](fp16_t h) -> std::ostream& {
+        return os << "0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << h
+                  << std::dec << std::nouppercase << std::setfill(' ');
+    };
+    auto operand = [&](const char* name, fp16_t h) {
+        os << "  " << name << "      : ";
+        hex(h) << "  s " << (h >> 15) << " e " << std::setw(2) << ((h >> 10) & 0x1F) << " f 0x"
+               << std::hex << std::uppercase << std::setw(3) << std::setfill('0') << (h & 0x3FF)
+               << std::dec << std::nouppercase << std::setfill(' ') << "  " << std::setprecision(12) << fp16_oracle_to_double(h) << "\n";
+    };
+    auto flags = [&](uint8_t f) {
+        os << "  [OF " << ((f & FP16_FLAG_OF) != 0) << " Z " << ((f & FP16_FLAG_Z) != 0) << " NaN "
+           << ((f & FP16_FLAG_NAN) != 0) << " PL " << ((f & FP16_FLAG_PL) != 0) << " UF "
+           << ((f & FP16_FLAG_UF) != 0) << "]";
+    };
+
+    operand("A", a);
+    operand("B", b);
+    os << "  Exact  " << (idx.mul ? "a*b" : "a+b") << ": " << std::setprecision(17) << x << "\n";
+    os << "  HW (" << idx.model << ")" << std::string(idx.model.size() < 5 ? 5 - idx.model.size() : 0, ' ') << ": ";
+    hex(hw); flags(hw_f); os << "  " << std::setprecision(12) << fp16_oracle_to_double(hw) << "\n";
+    os << "  Oracle " << std::setw(3) << std::left << fp16_round_name(idx.round) << std::right << ": ";
+    hex(ref); flags(ref_f); os << "\n";
+    if (idx.round != FP16_ROUND_RZ) { os << "  Oracle RZ : "; hex(rz); flags(rz_f); os << "\n"; }
+
+    os << "  Verdict   : " << (v == FP16_VERDICT_MATCH ? "Match" : v == FP16_VERDICT_ROUNDING ? "Rounding Diff" : "Mismatch");
+    double h = fp16_oracle_to_double(hw);
+    if (v != FP16_VERDICT_MATCH && std::isfinite(x) && std::isfinite(h)) {
+        int e = fp16_ulp_exp(x);
+        if (x == 0 || e < -14) e = -14;
+        os << ", HW - exact = " << std::showpos << std::setprecision(6) << std::ldexp(h - x, 10 - e)
+           << std::noshowpos << " ULP";
+    }
+    os << "\n";
+
+    if (!idx.mul) {
+        FpadderSignals s = fpadder_rtl_eval(a, b);
+        os << std::hex << std::uppercase << std::setfill('0')
+           << "  fpadder.v : big_ex " << std::dec << (unsigned)s.big_ex << " sml_ex " << (unsigned)s.sml_ex
+           << " ex_diff " << (unsigned)s.ex_diff << " sameSign " << (unsigned)s.sameSign << std::hex
+           << " shifted_small 0x" << std::setw(3) << s.shifted_small_float
+           << " small_ext 0x" << std::setw(3) << s.small_extension << "\n"
+           << "              sum 0x" << std::setw(3) << s.sum << " carry " << (unsigned)s.sum_carry
+           << " shift_am " << std::dec << (unsigned)s.shift_am << " neg_exp " << (unsigned)s.neg_exp
+           << " res_exp " << (unsigned)s.res_exp << std::hex << " res_frac 0x" << std::setw(3) << s.res_frac
+           << " PL " << (unsigned)s.res_precisionLost << "\n";
+    }
+    os.copyfmt(saved);
+}
+
+#endif // FP16_MISMATCH_INDEX_H
@@ -0,0 +1,257 @@
+#ifndef FP16_MUL_H
+#define FP16_MUL_H
+
+#include "fp16_common.h"
+#include "fp16_path_cov.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Bit-True Function: Hardware Logic Emulation (Multiplier)
+// ----------------------------------------------------------------------------
+// This mimics the Verilog behavior for FP16 Multiplication
+//
+// DENORM selects the denormal policy (FP16_DENORM_*, see fp16_add_bittrue_policy).
+template <unsigned DENORM>
+inline BitTrueResult fp16_mul_bittrue_policy(fp16_t n1, fp16_t n2) {
+    BitTrueResult ret = {0, false, false, false, false, false};
+    FP16_PATH_HIT(FP16_PATH_MUL_CALLS);
+
+    // 1. Decode inputs
+    uint16_t s1 = (n1 >> 15) & 1;
+    uint16_t e1 = (n1 >> 10) & 0x1F;
+    uint16_t f1 = n1 & 0x3FF;
+
+    uint16_t s2 = (n2 >> 15) & 1;
+    uint16_t e2 = (n2 >> 10) & 0x1F;
+    uint16_t f2 = n2 & 0x3FF;
+
+    if constexpr ((DENORM & FP16_DENORM_DAZ) != 0) {
+        if (e1 == 0) f1 = 0;
+        if (e2 == 0) f2 = 0;
+    }
+
+    // 2. Check Special Values
+    bool n1_is_inf = (e1 == 31) && (f1 == 0);
+    bool n2_is_inf = (e2 == 31) && (f2 == 0);
+    bool n1_is_nan = (e1 == 31) && (f1 != 0);
+    bool n2_is_nan = (e2 == 31) && (f2 != 0);
+    bool n1_is_zero = (e1 == 0) && (f1 == 0);
+    bool n2_is_zero = (e2 == 0) && (f2 == 0);
+
+    // Compute Result Sign
+    uint16_t s_res = s1 ^ s2;
+
+    // NaN Handling
+    if (n1_is_nan || n2_is_nan) {
+        FP16_PATH_HIT(FP16_PATH_MUL_NAN);
+        ret.res = 0x7FFF; ret.nan = true; return ret;
+    }
+    // Inf * 0 = NaN
+    if ((n1_is_inf && n2_is_zero) || (n2_is_inf && n1_is_zero)) {
+        FP16_PATH_HIT(FP16_PATH_MUL_INF_TIMES_ZERO);
+        ret.res = 0x7FFF; ret.nan = true; return ret;
+    }
+    // Infinity Handling
+    if (n1_is_inf || n2_is_inf) {
+        FP16_PATH_HIT(FP16_PATH_MUL_INF);
+        ret.overflow = true;
+        ret.res = (s_res << 15) | 0x7C00;
+        return ret;
+    }
+    // Zero Handling
+    if (n1_is_zero || n2_is_zero) {
+        FP16_PATH_HIT(FP16_PATH_MUL_ZERO_OPERAND);
+        ret.zero = true;
+        ret.res = (s_res << 15); // Signed Zero
+        return ret;
+    }
+
+    // 3. Extract Mantissa & Exponent (Handling Denormals)
+    // Note: This HW model assumes simplified denormal handling (flush to zero or treat as 0.xxx)
+    // For full IEEE 754, we need to handle denormals precisely.
+    // Here we treat denormals as having exponent 1 but mantissa 0.xxx (without hidden bit)
+
+    int32_t exp1, exp2;
+    uint32_t mant1, mant2;
+    if constexpr ((DENORM & FP16_DENORM_DAZ) != 0) { // zeros returned above
+        exp1 = e1; exp2 = e2;
+        mant1 = f1 | 1024; mant2 = f2 | 1024;
+    } else {
+        exp1 = (e1 == 0) ? 1 : e1;
+        exp2 = (e2 == 0) ? 1 : e2;
+
+        mant1 = (e1 == 0) ? f1 : (f1 | 1024);
+        mant2 = (e2 == 0) ? f2 : (f2 | 1024);
+    }
+
+    // 4. Exponent Calculation
+    // Bias is 15. E_res = E1 + E2 - Bias
+    int32_t exp_res = exp1 + exp2 - 15;
+
+    // 5. Mantissa Multiplication
+    // 11 bits * 11 bits = 22 bits (max)
+    uint32_t mant_mult = mant1 * mant2;
+
+    // 6. Normalization
+    // Result of 1.x * 1.y is in [1, 4)
+    // If result >= 2.0 (bit 21 is 1), shift right and increment exponent
+    // range of mant_mult:
+    // Min (1.0 * 1.0): 1024 * 1024 = 1048576 (0x100000) - bit 20 is 1
+    // Max (near 2.0 * 2.0): ~2047 * ~2047 = ~4190209 (0x3FF001) - bit 21 might be 1
+
+    if (mant_mult & 0x200000) { // Bit 21 is set (Result >= 2.0)
+        // Normalize: Right Shift 1
+        FP16_PATH_HIT(FP16_PATH_MUL_NORM_SHIFT);
+        mant_mult >>= 1;
+        exp_res++;
+    }
+    // Else: Bit 20 should be set for normalized numbers.
+
+    // 7. Handling Exponent Overflow/Underflow
+    if (exp_res >= 31) { // Overflow
+        FP16_PATH_HIT(FP16_PATH_MUL_OVERFLOW);
+        ret.overflow = true;
+        ret.res = (s_res << 15) | 0x7C00;
+    }
+    else if (exp_res <= 0) { // Underflow to Zero/Denormal
+        if constexpr ((DENORM & FP16_DENORM_FTZ) != 0) { // FTZ: flush to signed zero
+            ret.underflow = true;
+            ret.zero = true;
+            ret.res = (s_res << 15);
+            return ret;
+        }
+        // For simplicity, flush negative exponents to zero or minimal denormal
+        // A real HW might shift right to make it denormal.
+
+        if (exp_res < -10) { // Too small
+             FP16_PATH_HIT(FP16_PATH_MUL_UNDERFLOW_LT_M10);
+             ret.underflow = true;
+             ret.zero = true;
+             ret.res = (s_res << 15);
+        } else {
+             // Denormalize
+             // Shift amount = 1 - exp_res
+             FP16_PATH_HIT(FP16_PATH_MUL_DENORMAL_PACK);
+             int shift = 1 - exp_res;
+             mant_mult >>= shift;
+             exp_res = 0;
+
+             if (mant_mult == 0) ret.zero = true;
+
+             // Pack Denormal
+             // Remove hidden bit? No, denormal doesn't have hidden bit.
+             // But our mant_mult includes the integer part.
+             // We need to take the top 10 bits of fractional part.
+             // Wait, for Denormal, E=0, Fraction is the bits.
+
+             // Current mant_mult is scaled such that bit 20 is the unit.
+             // We need to align it to bit 10 for storage.
+             // Normal: bit 20 is hidden, 19-10 are stored.
+             // Denormal: bit 20 is 0. 19-10...
+
+             ret.res = (s_res << 15) | (exp_res << 10) | ((mant_mult >> 10) & 0x3FF);
+        }
+    }
+    else { // Normal result
+        FP16_PATH_HIT(FP16_PATH_MUL_NORMAL_PACK);
+        // Pack: Sign | Exp | Mantissa
+        // mant_mult: bit 20 is hidden bit (1). Bits 19-10 are the top 10 fraction bits.
+        // We drop bit 20.
+        ret.res = (s_res << 15) | (exp_res << 10) | ((mant_mult >> 10) & 0x3FF);
+    }
+
+    if ((ret.res & 0x7FFF) == 0) ret.zero = true;
+
+    return ret;
+}
+
+inline BitTrueResult fp16_mul_bittrue(fp16_t n1, fp16_t n2) {
+    return fp16_mul_bittrue_policy<FP16_DENORM_IEEE>(n1, n2);
+}
+
+// ----------------------------------------------------------------------------
+// Batch Kernels
+// ----------------------------------------------------------------------------
+// Scalar loop over fp16_mul_bittrue, results split into res[] / flags[].
+inline void fp16_mul_batch(const fp16_t* a, const fp16_t* b,
+                           fp16_t* res, uint8_t* flags, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_MUL_BATCH, n);
+    for (size_t i = 0; i < n; ++i) {
+        BitTrueResult r = fp16_mul_bittrue(a[i], b[i]);
+        res[i] = r.res;
+        flags[i] = pack_flags(r);
+    }
+}
+
+// Batch form of fp16_mul_bittrue_policy (denormal policy variants).
+template <unsigned DENORM>
+inline void fp16_mul_batch_policy(const fp16_t* a, const fp16_t* b, fp16_t* res, uint8_t* flags, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_MUL_BATCH, n);
+    for (size_t i = 0; i < n; ++i) {
+        BitTrueResult r = fp16_mul_bittrue_policy<DENORM>(a[i], b[i]);
+        res[i] = r.res;
+        flags[i] = pack_flags(r);
+    }
+}
+
+// Branch-free form of fp16_mul_bittrue for auto-vectorization.
+inline void fp16_mul_simd(const fp16_t* __restrict a, const fp16_t* __restrict b,
+                          fp16_t* __restrict res, uint8_t* __restrict flags, size_t n) {
+    FP16_PERF_SCOPE(FP16_PERF_MUL_SIMD, n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t n1 = a[i], n2 = b[i];
+        uint32_t s1 = n1 >> 15, e1 = (n1 >> 10) & 0x1F, f1 = n1 & 0x3FF;
+        uint32_t s2 = n2 >> 15, e2 = (n2 >> 10) & 0x1F, f2 = n2 & 0x3FF;
+        uint32_t sign = (s1 ^ s2) << 15;
+
+        uint32_t n1_is_inf  = (e1 == 31) & (f1 == 0);
+        uint32_t n2_is_inf  = (e2 == 31) & (f2 == 0);
+        uint32_t n1_is_zero = (e1 == 0) & (f1 == 0);
+        uint32_t n2_is_zero = (e2 == 0) & (f2 == 0);
+        uint32_t is_nan  = ((e1 == 31) & (f1 != 0)) | ((e2 == 31) & (f2 != 0)) |
+                           (n1_is_inf & n2_is_zero) | (n2_is_inf & n1_is_zero);
+        uint32_t is_inf  = n1_is_inf | n2_is_inf;
+        uint32_t is_zero = n1_is_zero | n2_is_zero;
+
+        int32_t  exp_res = (int32_t)(e1 | (e1 == 0)) + (int32_t)(e2 | (e2 == 0)) - 15;
+        uint32_t mant    = (f1 | ((e1 != 0) << 10)) * (f2 | ((e2 != 0) << 10));
+
+        uint32_t norm = (mant >> 21) & 1;
+        mant >>= norm;
+        exp_res += norm;
+
+        uint32_t of    = exp_res >= 31;
+        uint32_t uf    = exp_res < -10;
+        uint32_t den   = (exp_res <= 0) & !uf;
+        uint32_t dmant = mant >> ((uint32_t)(1 - exp_res) & 31);
+
+        uint32_t r = sign | ((uint32_t)exp_res << 10) | ((mant >> 10) & 0x3FF);
+        r = fp16_sel(den, sign | ((dmant >> 10) & 0x3FF), r);
+        r = fp16_sel(uf, sign, r);
+        r = fp16_sel(of, sign | 0x7C00, r);
+
+        uint32_t fl = fp16_sel(of, FP16_FLAG_OF, 0) |
+                      fp16_sel((r & 0x7FFF) == 0, FP16_FLAG_Z, 0) |
+                      fp16_sel(uf, FP16_FLAG_UF, 0);
+
+        r  = fp16_sel(is_zero, sign, r);
+        fl = fp16_sel(is_zero, FP16_FLAG_Z, fl);
+        r  = fp16_sel(is_inf, sign | 0x7C00, r);
+        fl = fp16_sel(is_inf, FP16_FLAG_OF, fl);
+        r  = fp16_sel(is_nan, 0x7FFF, r);
+        fl = fp16_sel(is_nan, FP16_FLAG_NAN, fl);
+
+        res[i]   = (fp16_t)r;
+        flags[i] = (uint8_t)fl;
+    }
+}
+
+// fp16_mul_simd over [0, n) in FP16_POOL_GRAIN slices on a work-stealing pool.
+inline void fp16_mul_parallel(Fp16Pool& pool, const fp16_t* a, const fp16_t* b,
+                              fp16_t* res, uint8_t* flags, size_t n) {
+    pool.parallel_for(0, n, FP16_POOL_GRAIN, [&](uint64_t lo, uint64_t hi, unsigned) {
+        fp16_mul_simd(a + lo, b + lo, res + lo, flags + lo, (size_t)(hi - lo));
+    });
+}
+
+#endif // FP16_MUL_H
@@ -6,223 +6,59 @@
 #include <bitset>
 #include <cstring>
 #include <random>
+#include <string>
+#include <thread>
 
-// ----------------------------------------------------------------------------
-// FP16 Types & Helpers
-// ----------------------------------------------------------------------------
-typedef uint16_t fp16_t;
-
-// Union for bit manipulation of float (32-bit)
-union FloatBits {
-    float f;
-    uint32_t i;
-};
-
-// Convert FP16 to Float32 (Standard IEEE 754 logic)
-float fp16_to_float(fp16_t h) {
-    uint32_t sign = (h >> 15) & 0x1;
-    uint32_t exp  = (h >> 10) & 0x1F;
-    uint32_t frac = h & 0x3FF;
-
-    if (exp == 0) {
-        if (frac == 0) { // Signed Zero
-            float res = 0.0f;
-            uint32_t bits;
-            std::memcpy(&bits, &res, 4);
-            bits |= (sign << 31);
-            std::memcpy(&res, &bits, 4);
-            return res;
-        } 
-        else { // Subnormal
-            return std::ldexp((float)frac, -24) * (sign ? -1.0f : 1.0f);
-        }
-    } 
-    else if (exp == 31) {
-        if (frac == 0) return sign ? -INFINITY : INFINITY;
-        else return NAN; // NaN
-    } 
-    else { // Normal
-        return std::ldexp(1.0f + (float)frac / 1024.0f, exp - 15) * (sign ? -1.0f : 1.0f);
-    }
-}
-
-// Convert Float32 to FP16 (Truncation/Round to Zero style for TLM comparison)
-fp16_t float_to_fp16(float f) {
-    FloatBits fb;
-    fb.f = f;
-    uint32_t sign = (fb.i >> 31) & 0x1;
-    int32_t exp = ((fb.i >> 23) & 0xFF) - 127;
-    uint32_t mant = fb.i & 0x7FFFFF;
-
-    if (std::isnan(f)) return 0x7FFF; // Canonical NaN
-    if (std::isinf(f)) return (sign << 15) | 0x7C00; 
-
-    if (f == 0.0f) return (sign << 15); // Zero
-
-    // Normalized to FP16 range
-    int32_t new_exp = exp + 15;
-    
-    if (new_exp <= 0) { // Denormal or Underflow
-        // Simplified: Flush to zero or handle denormal
-        // For TLM comparison, let's just use simple conversion
-        if (new_exp < -10) return (sign << 15); // Too small
-        
-        // Denormalize
-        mant = (mant | 0x800000) >> (1 - new_exp);
-        return (sign << 15) | (mant >> 13);
-        
-    } else if (new_exp >= 31) { // Overflow
-        return (sign << 15) | 0x7C00;
-    } else {
-        return (sign << 15) | (new_exp << 10) | (mant >> 13);
-    }
-}
-
-// ----------------------------------------------------------------------------
-// Result Structures
-// ----------------------------------------------------------------------------
-struct BitTrueResult {
-    fp16_t res;
-    bool overflow;
-    bool zero;
-    bool nan;
-    bool underflow;
-};
+#include "fp16_mul.h"
+#include "fp16_campaign.h"
+#include "fp16_oracle.h"
+#include "fp16_report.h"
+#include "fp16_rng.h"
+#include "fp16_stream_io.h"
 
 // ----------------------------------------------------------------------------
-// Bit-True Function: Hardware Logic Emulation (Multiplier)
+// Main: Verification
 // ----------------------------------------------------------------------------
-// This mimics the Verilog behavior for FP16 Multiplication
-BitTrueResult fp16_mul_bittrue(fp16_t n1, fp16_t n2) {
-    BitTrueResult ret = {0, false, false, false, false};
-
-    // 1. Decode inputs
-    uint16_t s1 = (n1 >> 15) & 1;
-    uint16_t e1 = (n1 >> 10) & 0x1F;
-    uint16_t f1 = n1 & 0x3FF;
-
-    uint16_t s2 = (n2 >> 15) & 1;
-    uint16_t e2 = (n2 >> 10) & 0x1F;
-    uint16_t f2 = n2 & 0x3FF;
-
-    // 2. Check Special Values
-    bool n1_is_inf = (e1 == 31) && (f1 == 0);
-    bool n2_is_inf = (e2 == 31) && (f2 == 0);
-    bool n1_is_nan = (e1 == 31) && (f1 != 0);
-    bool n2_is_nan = (e2 == 31) && (f2 != 0);
-    bool n1_is_zero = (e1 == 0) && (f1 == 0);
-    bool n2_is_zero = (e2 == 0) && (f2 == 0);
-
-    // Compute Result Sign
-    uint16_t s_res = s1 ^ s2;
-
-    // NaN Handling
-    if (n1_is_nan || n2_is_nan) {
-        ret.res = 0x7FFF; ret.nan = true; return ret;
-    }
-    // Inf * 0 = NaN
-    if ((n1_is_inf && n2_is_zero) || (n2_is_inf && n1_is_zero)) {
-        ret.res = 0x7FFF; ret.nan = true; return ret;
-    }
-    // Infinity Handling
-    if (n1_is_inf || n2_is_inf) {
-        ret.overflow = true;
-        ret.res = (s_res << 15) | 0x7C00;
-        return ret;
-    }
-    // Zero Handling
-    if (n1_is_zero || n2_is_zero) {
-        ret.zero = true;
-        ret.res = (s_res << 15); // Signed Zero
-        return ret;
-    }
-
-    // 3. Extract Mantissa & Exponent (Handling Denormals)
-    // Note: This HW model assumes simplified denormal handling (flush to zero or treat as 0.xxx)
-    // For full IEEE 754, we need to handle denormals precisely.
-    // Here we treat denormals as having exponent 1 but mantissa 0.xxx (without hidden bit)
-    
-    int32_t exp1 = (e1 == 0) ? 1 : e1; 
-    int32_t exp2 = (e2 == 0) ? 1 : e2;
-    
-    uint32_t mant1 = (e1 == 0) ? f1 : (f1 | 1024); 
-    uint32_t mant2 = (e2 == 0) ? f2 : (f2 | 1024);
-
-    // 4. Exponent Calculation
-    // Bias is 15. E_res = E1 + E2 - Bias
-    int32_t exp_res = exp1 + exp2 - 15;
-
-    // 5. Mantissa Multiplication
-    // 11 bits * 11 bits = 22 bits (max)
-    uint32_t mant_mult = mant1 * mant2;
-
-    // 6. Normalization
-    // Result of 1.x * 1.y is in [1, 4)
-    // If result >= 2.0 (bit 21 is 1), shift right and increment exponent
-    // range of mant_mult: 
-    // Min (1.0 * 1.0): 1024 * 1024 = 1048576 (0x100000) - bit 20 is 1
-    // Max (near 2.0 * 2.0): ~2047 * ~2047 = ~4190209 (0x3FF001) - bit 21 might be 1
-    
-    if (mant_mult & 0x200000) { // Bit 21 is set (Result >= 2.0)
-        // Normalize: Right Shift 1
-        mant_mult >>= 1;
-        exp_res++;
-    }
-    // Else: Bit 20 should be set for normalized numbers.
-
-    // 7. Handling Exponent Overflow/Underflow
-    if (exp_res >= 31) { // Overflow
-        ret.overflow = true;
-        ret.res = (s_res << 15) | 0x7C00;
-    } 
-    else if (exp_res <= 0) { // Underflow to Zero/Denormal
-        // For simplicity, flush negative exponents to zero or minimal denormal
-        // A real HW might shift right to make it denormal.
-        
-        if (exp_res < -10) { // Too small
-             ret.underflow = true;
-             ret.zero = true;
-             ret.res = (s_res << 15);
-        } else {
-             // Denormalize
-             // Shift amount = 1 - exp_res
-             int shift = 1 - exp_res;
-             mant_mult >>= shift;
-             exp_res = 0;
-             
-             if (mant_mult == 0) ret.zero = true;
-             
-             // Pack Denormal
-             // Remove hidden bit? No, denormal doesn't have hidden bit.
-             // But our mant_mult includes the integer part. 
-             // We need to take the top 10 bits of fractional part.
-             // Wait, for Denormal, E=0, Fraction is the bits.
-             
-             // Current mant_mult is scaled such that bit 20 is the unit.
-             // We need to align it to bit 10 for storage.
-             // Normal: bit 20 is hidden, 19-10 are stored.
-             // Denormal: bit 20 is 0. 19-10...
-             
-             ret.res = (s_res << 15) | (exp_res << 10) | ((mant_mult >> 10) & 0x3FF);
+// Usage: fp16_mul_ref [--seed S] [--random N] [--campaign N] [--threads T] [--filter]
+//                     [--format table|csv|jsonl] [--round rz|rne|ru|rd]
+//   --seed     : seed of all random vectors (default: from std::random_device,
+//                printed so a failing run can be reproduced)
+//   --random   : random cases appended to the fixed table (default 20)
+//   --campaign : additionally run N random vectors through the SIMD kernels
+//                on T threads; results are identical for any T
+//   --filter   : binary filter, stdin (a, b) pairs -> stdout (res, flags)
+//                records on T threads (see fp16_stream_io.h); nothing else runs
+//   --format   : row format (fp16_report.h); csv and jsonl keep stdout for
+//                the rows and print the seed and summaries on stderr
+//   --round    : rounding of the exact TLM oracle (fp16_oracle.h, default rz,
+//                the mode the HW truncation implements)
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t num_random = 20;
+    uint64_t campaign = 0;
+    unsigned threads = std::thread::hardware_concurrency();
+    bool filter = false;
+    Fp16ReportFormat format = FP16_REPORT_TABLE;
+    Fp16Round round = FP16_ROUND_RZ;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--random" && i + 1 < argc) num_random = std::stoull(argv[++i]);
+        else if (arg == "--campaign" && i + 1 < argc) campaign = std::stoull(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else if (arg == "--filter") filter = true;
+        else if (arg == "--format" && i + 1 < argc && fp16_report_format(argv[i + 1], format)) ++i;
+        else if (arg == "--round" && i + 1 < argc && fp16_round_mode(argv[i + 1], round)) ++i;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--seed S] [--random N] [--campaign N] [--threads T] [--filter]\n"
+                      << "       [--format table|csv|jsonl] [--round rz|rne|ru|rd]\n";
+            return 1;
         }
-    } 
-    else { // Normal result
-        // Pack: Sign | Exp | Mantissa
-        // mant_mult: bit 20 is hidden bit (1). Bits 19-10 are the top 10 fraction bits.
-        // We drop bit 20.
-        ret.res = (s_res << 15) | (exp_res << 10) | ((mant_mult >> 10) & 0x3FF);
     }
-
-    if ((ret.res & 0x7FFF) == 0) ret.zero = true;
-
-    return ret;
-}
+    if (filter) return fp16_stream_filter(fp16_mul_simd, threads) ? 0 : 1;
 
 
-// ----------------------------------------------------------------------------
-// Main: Verification
-// ----------------------------------------------------------------------------
-int main() {
     // 1. Fixed Test Cases
     std::vector<std::pair<fp16_t, fp16_t>> tests = {
         {0x3C00, 0x3C00}, // 1.0 * 1.0 = 1.0
@@ -238,57 +74,66 @@ int main() {
         {0x3C00, 0x0400}  // 1.0 * Smallest Normal
     };
 
-    // 2. Random Test Cases (Add 20 random Inputs)
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 0xFFFF);
-    
-    for (int i = 0; i < 20; ++i) {
-        tests.push_back({(fp16_t)dis(gen), (fp16_t)dis(gen)});
-    }
+    // 2. Random Test Cases (reproducible with --seed), generated row by row
+    //    so large --random counts need no table in memory
+    Xoshiro256 gen(seed);
+    uint64_t rows = tests.size() + num_random;
 
-    std::cout << "--------------------------------------------------------------------------------------------------\n";
-    std::cout << " FP16 Multiplier Verification: Bit-True (HW) vs TLM (Float)\n";
-    std::cout << "--------------------------------------------------------------------------------------------------\n";
-    std::cout << "  Input A  |  Input B  || HW Res  | TLM Res | Match? | OF | Z | NaN| Note\n";
-    std::cout << "--------------------------------------------------------------------------------------------------\n";
+    // Table rows go to stdout; with --format csv|jsonl everything else goes
+    // to stderr so stdout stays machine-readable.
+    std::ostream& info = (format == FP16_REPORT_TABLE) ? std::cout : std::cerr;
+    info << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << "\n";
+    info.flush();
 
-    int mismatch_count = 0;
+    Fp16ReportWriter report(std::cout, format, false);
+    std::string title = std::string("FP16 Multiplier Verification: Bit-True (HW) vs TLM (Exact, ") + fp16_round_name(round) + ")";
+    report.header(title.c_str());
+
+    uint64_t mismatch_count = 0, rounding_count = 0;
+
+    for (uint64_t i = 0; i < rows; ++i) {
+        fp16_t in_a, in_b;
+        if (i < tests.size()) {
+            in_a = tests[i].first; in_b = tests[i].second;
+        } else {
+            uint64_t r = gen();
+            in_a = (fp16_t)r; in_b = (fp16_t)(r >> 16);
+        }
 
-    for (const auto& t : tests) {
         // Run HW Model
-        BitTrueResult hw = fp16_mul_bittrue(t.first, t.second);
-        
-        // Run TLM Model (ideal float multiplication)
-        float fa = fp16_to_float(t.first);
-        float fb = fp16_to_float(t.second);
-        float fmult = fa * fb;
-        fp16_t tlm_res = float_to_fp16(fmult); // Convert back for comparison
+        BitTrueResult hw = fp16_mul_bittrue(in_a, in_b);
+
+        // Run TLM Model (exact oracle, rounded once in the --round mode)
+        BitTrueResult tlm = fp16_oracle_mul(in_a, in_b, round);
+        BitTrueResult rz = fp16_oracle_mul(in_a, in_b, FP16_ROUND_RZ);
+        fp16_t tlm_res = tlm.res;
+
+        // Compare: NaN matches NaN; a result equal to the other correctly
+        // rounded neighbour of the exact value is only a rounding difference
+        Fp16Verdict verdict = fp16_oracle_classify(hw.res, pack_flags(hw), tlm.res, pack_flags(tlm),
+                                                   rz.res, pack_flags(rz));
+        bool match = verdict == FP16_VERDICT_MATCH;
 
-        // Compare
-        bool match = (hw.res == tlm_res);
-        // Exception: NaNs never equal
-        if (std::isnan(fmult) && hw.nan) match = true;
-        
-        std::string note = "";
-        if (!match) {
+        const char* note = "";
+        if (verdict == FP16_VERDICT_MISMATCH) {
             mismatch_count++;
             note = "Mismatch";
+        } else if (verdict == FP16_VERDICT_ROUNDING) {
+            rounding_count++;
+            note = "Rounding Diff";
         }
 
-        std::cout << "  0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << t.first
-                  << "   |  0x" << std::setw(4) << t.second 
-                  << "   || 0x" << std::setw(4) << hw.res
-                  << "  | 0x" << std::setw(4) << tlm_res
-                  << "  |   " << (match ? "O" : "X")
-                  << "    | " << hw.overflow 
-                  << "  | " << hw.zero 
-                  << " | "  << hw.nan 
-                  << "  | " << note << "\n";
+        report.row(in_a, in_b, hw.res, tlm_res, pack_flags(hw), match, note);
     }
-    
-    std::cout << "--------------------------------------------------------------------------------------------------\n";
-    std::cout << "Total Mismatches: " << std::dec << mismatch_count << "\n";
+
+    report.footer();
+    report.flush();
+    info << "Total Mismatches: " << std::dec << mismatch_count << ", Rounding Diffs: " << rounding_count
+         << " (HW vs exact " << fp16_round_name(round) << " oracle)\n";
+
+    if (campaign) fp16_campaign_report(info, fp16_campaign(FP16_CAMPAIGN_MUL, seed, campaign, threads), seed);
+
+    fp16_path_cov_report(info);
 
     return 0;
 }
@@ -0,0 +1,271 @@
+#ifndef FP16_NPY_H
+#define FP16_NPY_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fp16_common.h"
+
+// ----------------------------------------------------------------------------
+// Memory-Mapped .npy Tensors
+// ----------------------------------------------------------------------------
+// NumPy .npy files (format 1.0 / 2.0 / 3.0): the magic "\x93NUMPY", a
+// version, a header length and a Python dict literal
+//   {'descr': '<f2', 'fortran_order': False, 'shape': (64, 1024), }
+// padded so the data starts at a multiple of 64 bytes, then the raw
+// little-endian array. Files are mmap'ed: a read tensor points straight
+// into the page cache, and a created tensor's data pointer is the mapped
+// output file, so kernels read their operands and write their results in
+// place with no parse or copy. Files without the magic are raw uint16
+// arrays (one dimension). Little-endian hosts only, like the .npy data.
+//
+// Errors are reported on std::cerr as "fp16 npy: <path>: <reason>".
+
+struct Fp16NpyArray {
+    std::string descr;          // '<f2', '<u2', '|u1', '<f4', ...; "raw" for headerless files
+    std::vector<size_t> shape;
+    bool fortran = false;
+    size_t offset = 0;          // data offset in the file
+
+    size_t count() const {
+        size_t n = 1;
+        for (size_t d : shape) n *= d;
+        return n;
+    }
+    // FP16 bit patterns: float16, uint16/int16 or raw
+    bool fp16() const { return descr == "<f2" || descr == "<u2" || descr == "<i2" || descr == "raw"; }
+};
+
+// Data bytes of `shape` elements of `item` bytes; false if that overflows
+// size_t.
+inline bool fp16_npy_bytes(const std::vector<size_t>& shape, size_t item, size_t& bytes) {
+    bytes = item;
+    for (size_t d : shape) {
+        if (__builtin_mul_overflow(bytes, d, &bytes)) return false;
+    }
+    return true;
+}
+
+// True if both paths exist and name the same file (hard links included).
+inline bool fp16_same_file(const std::string& a, const std::string& b) {
+    struct stat sa, sb;
+    return stat(a.c_str(), &sa) == 0 && stat(b.c_str(), &sb) == 0 && sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+// Read-only or read-write file mapping; move-only.
+class Fp16Mapped {
+public:
+    Fp16Mapped() = default;
+    Fp16Mapped(const Fp16Mapped&) = delete;
+    Fp16Mapped& operator=(const Fp16Mapped&) = delete;
+    Fp16Mapped(Fp16Mapped&& o) noexcept : p_(o.p_), n_(o.n_) { o.p_ = nullptr; o.n_ = 0; }
+    Fp16Mapped& operator=(Fp16Mapped&& o) noexcept {
+        std::swap(p_, o.p_);
+        std::swap(n_, o.n_);
+        return *this;
+    }
+    ~Fp16Mapped() { close(); }
+
+    bool open_read(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail(path, std::strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return fail(path, std::strerror(errno));
+        }
+        n_ = (size_t)st.st_size;
+        if (n_) {
+            void* p = mmap(nullptr, n_, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                n_ = 0;
+                return fail(path, std::strerror(errno));
+            }
+            p_ = (uint8_t*)p;
+            madvise(p_, n_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        return true;
+    }
+
+    // Creates (or truncates) path with `bytes` bytes and maps it writable.
+    bool create(const std::string& path, size_t bytes) {
+        close();
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return fail(path, std::strerror(errno));
+        if (ftruncate(fd, (off_t)bytes) != 0) {
+            ::close(fd);
+            return fail(path, std::strerror(errno));
+        }
+        n_ = bytes;
+        if (n_) {
+            void* p = mmap(nullptr, n_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                n_ = 0;
+                return fail(path, std::strerror(errno));
+            }
+            p_ = (uint8_t*)p;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    void close() {
+        if (p_) munmap(p_, n_);
+        p_ = nullptr;
+        n_ = 0;
+    }
+
+    uint8_t* data() const { return p_; }
+    size_t size() const { return n_; }
+
+private:
+    static bool fail(const std::string& path, const char* why) {
+        std::cerr << "fp16 npy: " << path << ": " << why << "\n";
+        return false;
+    }
+
+    uint8_t* p_ = nullptr;
+    size_t n_ = 0;
+};
+
+// Bytes per element of a descr ('<f2' -> 2); 0 if unknown.
+inline size_t fp16_npy_item(const std::string& descr) {
+    if (descr == "raw") return 2;
+    if (descr.size() < 3 || (descr[0] != '<' && descr[0] != '|')) return 0;
+    return (size_t)std::strtoul(descr.c_str() + 2, nullptr, 10);
+}
+
+// Value of 'key' in a .npy header dict, trimmed; empty if absent.
+inline std::string fp16_npy_field(const std::string& dict, const char* key) {
+    size_t k = dict.find(std::string("'") + key + "'");
+    if (k == std::string::npos) return "";
+    size_t v = dict.find(':', k);
+    if (v == std::string::npos) return "";
+    ++v;
+    while (v < dict.size() && dict[v] == ' ') ++v;
+    size_t end;
+    if (dict[v] == '(') end = dict.find(')', v) + 1;
+    else if (dict[v] == '\'') end = dict.find('\'', v + 1) + 1;
+    else end = dict.find_first_of(",}", v);
+    if (end == std::string::npos || end == 0) return "";
+    return dict.substr(v, end - v);
+}
+
+// Parses the header of a mapped file (raw if it has no .npy magic) and
+// checks that the data fits.
+inline bool fp16_npy_parse(const std::string& path, const uint8_t* p, size_t n, Fp16NpyArray& arr) {
+    auto fail = [&](const std::string& why) {
+        std::cerr << "fp16 npy: " << path << ": " << why << "\n";
+        return false;
+    };
+    arr = Fp16NpyArray();
+    if (n < 6 || std::memcmp(p, "\x93NUMPY", 6) != 0) {
+        if (n % 2) return fail("raw file with an odd byte count");
+        arr.descr = "raw";
+        arr.shape = {n / 2};
+        return true;
+    }
+    if (n < 10) return fail("truncated .npy header");
+    size_t hlen, hdr;
+    if (p[6] == 1) {
+        hlen = p[8] | (size_t)p[9] << 8;
+        hdr = 10;
+    } else if (p[6] == 2 || p[6] == 3) {
+        if (n < 12) return fail("truncated .npy header");
+        hlen = p[8] | (size_t)p[9] << 8 | (size_t)p[10] << 16 | (size_t)p[11] << 24;
+        hdr = 12;
+    } else {
+        return fail("unsupported .npy version " + std::to_string(p[6]));
+    }
+    if (hdr + hlen > n) return fail("truncated .npy header");
+    std::string dict((const char*)p + hdr, hlen);
+    arr.offset = hdr + hlen;
+
+    std::string descr = fp16_npy_field(dict, "descr");
+    std::string order = fp16_npy_field(dict, "fortran_order");
+    std::string shape = fp16_npy_field(dict, "shape");
+    if (descr.size() < 2 || shape.empty() || order.empty()) return fail("malformed .npy header");
+    arr.descr = descr.substr(1, descr.size() - 2);
+    if (arr.descr == "=f2" || arr.descr == "=u2" || arr.descr == "=i2") arr.descr[0] = '<';
+    arr.fortran = order == "True";
+    for (size_t i = 1; i < shape.size();) {
+        if (shape[i] >= '0' && shape[i] <= '9') {
+            char* end;
+            arr.shape.push_back((size_t)std::strtoull(shape.c_str() + i, &end, 10));
+            i = (size_t)(end - shape.c_str());
+        } else {
+            ++i;
+        }
+    }
+    size_t item = fp16_npy_item(arr.descr);
+    if (!item) return fail("unsupported dtype '" + arr.descr + "'");
+    size_t bytes;
+    if (!fp16_npy_bytes(arr.shape, item, bytes)) return fail("shape too large");
+    if (n - arr.offset < bytes) return fail("truncated .npy data");
+    return true;
+}
+
+// Maps an FP16 tensor for reading: data points into the mapping.
+inline bool fp16_npy_open(const std::string& path, Fp16Mapped& map, Fp16NpyArray& arr, const fp16_t*& data) {
+    if (!map.open_read(path) || !fp16_npy_parse(path, map.data(), map.size(), arr)) return false;
+    if (!arr.fp16()) {
+        std::cerr << "fp16 npy: " << path << ": dtype '" << arr.descr << "' is not float16 / uint16\n";
+        return false;
+    }
+    static const fp16_t empty = 0;
+    data = map.data() ? (const fp16_t*)(map.data() + arr.offset) : &empty;
+    return true;
+}
+
+// .npy header for descr and shape, padded to a multiple of 64 bytes.
+inline std::string fp16_npy_header(const std::string& descr, const std::vector<size_t>& shape, bool fortran = false) {
+    std::string dict = "{'descr': '" + descr + "', 'fortran_order': " + (fortran ? "True" : "False") + ", 'shape': (";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        dict += std::to_string(shape[i]);
+        dict += shape.size() == 1 ? "," : i + 1 < shape.size() ? ", " : "";
+    }
+    dict += "), }";
+    size_t hdr = dict.size() + 1 + 10 < 65536 ? 10 : 12;
+    size_t total = (hdr + dict.size() + 1 + 63) & ~(size_t)63;
+    dict.append(total - hdr - dict.size() - 1, ' ');
+    dict += '\n';
+    size_t hlen = dict.size();
+    std::string out("\x93NUMPY", 6);
+    out += (char)(hdr == 10 ? 1 : 2);
+    out += '\0';
+    for (size_t i = 0; i < hdr - 8; ++i) out += (char)(hlen >> (8 * i) & 0xFF);
+    return out + dict;
+}
+
+// Creates path as a .npy array (or a headerless file if raw) of descr,
+// shape and order, mapped writable; returns the data pointer, nullptr on
+// error.
+inline void* fp16_npy_create(const std::string& path, Fp16Mapped& map, const std::string& descr,
+                             const std::vector<size_t>& shape, bool raw = false, bool fortran = false) {
+    std::string hdr = raw ? "" : fp16_npy_header(descr, shape, fortran);
+    size_t bytes;
+    if (!fp16_npy_bytes(shape, fp16_npy_item(descr), bytes) || bytes > SIZE_MAX - hdr.size()) {
+        std::cerr << "fp16 npy: " << path << ": shape too large\n";
+        return nullptr;
+    }
+    if (!map.create(path, hdr.size() + bytes)) return nullptr;
+    if (map.data()) std::memcpy(map.data(), hdr.data(), hdr.size());
+    static uint64_t empty = 0;
+    return map.data() ? map.data() + hdr.size() : (void*)&empty;
+}
+
+#endif // FP16_NPY_H
@@ -0,0 +1,229 @@
+#ifndef FP16_ORACLE_H
+#define FP16_ORACLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "fp16_common.h"
+
+// ----------------------------------------------------------------------------
+// Exact Oracle: Correctly Rounded FP16 Add / Multiply
+// ----------------------------------------------------------------------------
+// The float TLM (fa + fb, then float_to_fp16) rounds twice: the float sum
+// is rounded to 24 bits before it is truncated to FP16, so it is not a
+// trustworthy reference. Every finite FP16 value is an 11-bit integer times
+// 2^k with k in [-24, 5], hence
+//   a + b : at most 40 significant bits -> exact in double
+//   a * b : at most 22 significant bits -> exact in double
+// The oracle computes the exact value in double and rounds it to FP16 once,
+// in the requested IEEE mode. Results are canonical (NaN = 0x7FFF), flags
+// follow IEEE 754 semantics in the FP16_FLAG_* bits:
+//   OF  : finite operands, result rounded beyond the FP16 range
+//   Z   : result is +-0
+//   NaN : invalid operation or NaN operand
+//   PL  : inexact (result != exact value)
+//   UF  : tiny (|exact| < 2^-14) and inexact
+// The kernels are branch-free and templated on the mode so they vectorize
+// (build with -O3 -march=native).
+
+enum Fp16Round { FP16_ROUND_RZ, FP16_ROUND_RNE, FP16_ROUND_RU, FP16_ROUND_RD };
+
+inline const char* fp16_round_name(Fp16Round m) {
+    static const char* names[] = {"RZ", "RNE", "RU", "RD"};
+    return names[m];
+}
+
+inline uint64_t fp16_sel64(uint64_t c, uint64_t a, uint64_t b) {
+    uint64_t m = 0ull - (c & 1);
+    return (a & m) | (b & ~m);
+}
+
+// Exact conversion of an FP16 bit pattern to double.
+inline double fp16_oracle_to_double(uint32_t h) {
+    uint64_t sign = (uint64_t)(h & 0x8000u) << 48;
+    uint32_t exp = (h >> 10) & 0x1F, frac = h & 0x3FF;
+    double sub = (double)(int32_t)frac * 5.9604644775390625e-8; // frac * 2^-24
+    uint64_t sub_bits;
+    std::memcpy(&sub_bits, &sub, 8);
+    uint64_t e64 = fp16_sel64(exp == 31, 0x7FF, (uint64_t)exp + 1008);
+    uint64_t bits = fp16_sel64(exp == 0, sub_bits, (e64 << 52) | ((uint64_t)frac << 42)) | sign;
+    double d;
+    std::memcpy(&d, &bits, 8);
+    return d;
+}
+
+// Rounds an exact double to FP16. Returns res | flags << 16.
+template <Fp16Round MODE>
+inline uint32_t fp16_oracle_round(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, 8);
+    uint32_t sign = (uint32_t)(bits >> 63);
+    uint32_t e_field = (uint32_t)(bits >> 52) & 0x7FF;
+    uint64_t mant = bits & 0xFFFFFFFFFFFFFull;
+    uint32_t is_nan = (e_field == 0x7FF) & (mant != 0);
+    uint32_t is_inf = (e_field == 0x7FF) & (mant == 0);
+    uint32_t is_zero = (e_field == 0) & (mant == 0); // no double subnormal is reachable
+
+    // x = sig * 2^(E - 52); FP16 keeps bits down to 2^-24 (subnormal) or to
+    // 2^(E - 10) (normal), i.e. drops the low `sh` bits of sig.
+    int32_t E = (int32_t)e_field - 1023;
+    uint64_t sig = mant | (1ull << 52);
+    uint32_t tiny = E < -14;
+    uint64_t sh = fp16_sel64(tiny, (uint64_t)(42 - 14 - E), 42);
+    sh = sh > 55 ? 55 : sh; // sig < 2^53: beyond 55 only the sticky bit matters
+    uint64_t q = sig >> sh;
+    // Dropped bits, left-aligned: the rounding point is at 2^63. (A mask
+    // built as 1 << sh would keep GCC from vectorizing the loop.)
+    uint64_t rem = sig << (64 - sh);
+
+    // Normal: exponent field + 10 fraction bits (the hidden bit is removed by
+    // the -1 in the exponent); subnormal: q is the fraction. A carry from
+    // rounding walks into the exponent, including subnormal -> min normal.
+    uint32_t base = (uint32_t)fp16_sel64(tiny, q, ((uint64_t)(E + 14) << 10) + q);
+    uint32_t inexact = rem != 0;
+    uint32_t inc;
+    if (MODE == FP16_ROUND_RZ) inc = 0;
+    else if (MODE == FP16_ROUND_RNE) inc = (rem > (1ull << 63)) | ((rem == (1ull << 63)) & base);
+    else if (MODE == FP16_ROUND_RU) inc = inexact & (sign ^ 1);
+    else inc = inexact & sign;
+    inc &= 1;
+    uint32_t mag = base + inc;
+
+    // Overflow: infinity when the mode rounds away from zero on this side,
+    // else the largest finite value.
+    uint32_t to_inf = (MODE == FP16_ROUND_RNE) | ((MODE == FP16_ROUND_RU) & (sign ^ 1)) |
+                      ((MODE == FP16_ROUND_RD) & sign);
+    uint32_t of = mag >= 0x7C00;
+    mag = fp16_sel(of, fp16_sel(to_inf, 0x7C00, 0x7BFF), mag);
+
+    uint32_t res = (sign << 15) | mag;
+    uint32_t zero_res = (mag == 0);
+    uint32_t flags = (of * FP16_FLAG_OF) | (zero_res * FP16_FLAG_Z) |
+                     ((inexact | of) * FP16_FLAG_PL) | ((tiny & inexact) * FP16_FLAG_UF);
+
+    res = fp16_sel(is_zero, sign << 15, res);
+    flags = fp16_sel(is_zero, FP16_FLAG_Z, flags);
+    res = fp16_sel(is_inf, (sign << 15) | 0x7C00, res);
+    flags = fp16_sel(is_inf, 0, flags);
+    res = fp16_sel(is_nan, 0x7FFF, res);
+    flags = fp16_sel(is_nan, FP16_FLAG_NAN, flags);
+    return res | (flags << 16);
+}
+
+// ----------------------------------------------------------------------------
+// Scalar Oracle
+// ----------------------------------------------------------------------------
+template <Fp16Round MODE>
+inline uint32_t fp16_oracle_add_packed(fp16_t a, fp16_t b) {
+    double s = fp16_oracle_to_double(a) + fp16_oracle_to_double(b);
+    uint32_t r = fp16_oracle_round<MODE>(s);
+    // An exact zero sum of opposite-signed operands is -0 only under RD
+    // (the double add itself ran in round-to-nearest).
+    uint32_t cancel = ((r & 0x7FFF) == 0) & (((a ^ b) >> 15) & 1) & (((r >> 16) & FP16_FLAG_NAN) == 0);
+    return fp16_sel(cancel, (r & ~0x8000u) | ((uint32_t)(MODE == FP16_ROUND_RD) << 15), r);
+}
+
+template <Fp16Round MODE>
+inline uint32_t fp16_oracle_mul_packed(fp16_t a, fp16_t b) {
+    return fp16_oracle_round<MODE>(fp16_oracle_to_double(a) * fp16_oracle_to_double(b));
+}
+
+inline BitTrueResult fp16_oracle_unpack(uint32_t r) {
+    uint32_t f = r >> 16;
+    BitTrueResult out = {(fp16_t)r, (f & FP16_FLAG_OF) != 0, (f & FP16_FLAG_Z) != 0, (f & FP16_FLAG_NAN) != 0,
+                         (f & FP16_FLAG_PL) != 0, (f & FP16_FLAG_UF) != 0};
+    return out;
+}
+
+inline BitTrueResult fp16_oracle_add(fp16_t a, fp16_t b, Fp16Round mode) {
+    switch (mode) {
+    case FP16_ROUND_RNE: return fp16_oracle_unpack(fp16_oracle_add_packed<FP16_ROUND_RNE>(a, b));
+    case FP16_ROUND_RU:  return fp16_oracle_unpack(fp16_oracle_add_packed<FP16_ROUND_RU>(a, b));
+    case FP16_ROUND_RD:  return fp16_oracle_unpack(fp16_oracle_add_packed<FP16_ROUND_RD>(a, b));
+    default:             return fp16_oracle_unpack(fp16_oracle_add_packed<FP16_ROUND_RZ>(a, b));
+    }
+}
+
+inline BitTrueResult fp16_oracle_mul(fp16_t a, fp16_t b, Fp16Round mode) {
+    switch (mode) {
+    case FP16_ROUND_RNE: return fp16_oracle_unpack(fp16_oracle_mul_packed<FP16_ROUND_RNE>(a, b));
+    case FP16_ROUND_RU:  return fp16_oracle_unpack(fp16_oracle_mul_packed<FP16_ROUND_RU>(a, b));
+    case FP16_ROUND_RD:  return fp16_oracle_unpack(fp16_oracle_mul_packed<FP16_ROUND_RD>(a, b));
+    default:             return fp16_oracle_unpack(fp16_oracle_mul_packed<FP16_ROUND_RZ>(a, b));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Vectorized Oracle
+// ----------------------------------------------------------------------------
+// Same interface as fp16_add_simd / fp16_mul_simd (res[] / flags[]).
+template <Fp16Round MODE>
+inline void fp16_oracle_add_simd(const fp16_t* __restrict a, const fp16_t* __restrict b,
+                                 fp16_t* __restrict res, uint8_t* __restrict flags, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t r = fp16_oracle_add_packed<MODE>(a[i], b[i]);
+        res[i] = (fp16_t)r;
+        flags[i] = (uint8_t)(r >> 16);
+    }
+}
+
+template <Fp16Round MODE>
+inline void fp16_oracle_mul_simd(const fp16_t* __restrict a, const fp16_t* __restrict b,
+                                 fp16_t* __restrict res, uint8_t* __restrict flags, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t r = fp16_oracle_mul_packed<MODE>(a[i], b[i]);
+        res[i] = (fp16_t)r;
+        flags[i] = (uint8_t)(r >> 16);
+    }
+}
+
+inline void fp16_oracle_add_batch(Fp16Round mode, const fp16_t* a, const fp16_t* b,
+                                  fp16_t* res, uint8_t* flags, size_t n) {
+    switch (mode) {
+    case FP16_ROUND_RNE: fp16_oracle_add_simd<FP16_ROUND_RNE>(a, b, res, flags, n); break;
+    case FP16_ROUND_RU:  fp16_oracle_add_simd<FP16_ROUND_RU>(a, b, res, flags, n); break;
+    case FP16_ROUND_RD:  fp16_oracle_add_simd<FP16_ROUND_RD>(a, b, res, flags, n); break;
+    default:             fp16_oracle_add_simd<FP16_ROUND_RZ>(a, b, res, flags, n); break;
+    }
+}
+
+inline void fp16_oracle_mul_batch(Fp16Round mode, const fp16_t* a, const fp16_t* b,
+                                  fp16_t* res, uint8_t* flags, size_t n) {
+    switch (mode) {
+    case FP16_ROUND_RNE: fp16_oracle_mul_simd<FP16_ROUND_RNE>(a, b, res, flags, n); break;
+    case FP16_ROUND_RU:  fp16_oracle_mul_simd<FP16_ROUND_RU>(a, b, res, flags, n); break;
+    case FP16_ROUND_RD:  fp16_oracle_mul_simd<FP16_ROUND_RD>(a, b, res, flags, n); break;
+    default:             fp16_oracle_mul_simd<FP16_ROUND_RZ>(a, b, res, flags, n); break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Classification of a HW result against the exact value
+// ----------------------------------------------------------------------------
+// ref: the oracle in the mode the HW is specified for (RZ for the truncating
+// fpadder / multiplier). rz / rz_flags: the RZ oracle. The two correctly
+// rounded neighbours of the exact value are rz and one step away from zero
+// (what RNE/RU/RD give when they round up in magnitude); a HW result equal
+// to either but not to ref is a rounding difference, anything else a real
+// mismatch.
+enum Fp16Verdict { FP16_VERDICT_MATCH, FP16_VERDICT_ROUNDING, FP16_VERDICT_MISMATCH };
+
+inline Fp16Verdict fp16_oracle_classify(fp16_t hw, uint8_t hw_flags, fp16_t ref, uint8_t ref_flags,
+                                        fp16_t rz, uint8_t rz_flags) {
+    if (hw == ref || ((hw_flags & FP16_FLAG_NAN) && (ref_flags & FP16_FLAG_NAN))) return FP16_VERDICT_MATCH;
+    fp16_t away = (fp16_t)(rz + ((rz_flags & FP16_FLAG_PL) != 0 && (rz & 0x7FFF) < 0x7C00));
+    return (hw == rz || hw == away) ? FP16_VERDICT_ROUNDING : FP16_VERDICT_MISMATCH;
+}
+
+inline bool fp16_round_mode(const std::string& name, Fp16Round& out) {
+    if (name == "rz") out = FP16_ROUND_RZ;
+    else if (name == "rne") out = FP16_ROUND_RNE;
+    else if (name == "ru") out = FP16_ROUND_RU;
+    else if (name == "rd") out = FP16_ROUND_RD;
+    else return false;
+    return true;
+}
+
+#endif // FP16_ORACLE_H
@@ -0,0 +1,139 @@
+#ifndef FP16_PATH_COV_H
+#define FP16_PATH_COV_H
+
+#include <ostream>
+
+// ----------------------------------------------------------------------------
+// Path Coverage Counters (optional)
+// ----------------------------------------------------------------------------
+// Build with -DFP16_PATH_COV to count which branches of fp16_add_bittrue and
+// fp16_mul_bittrue fire. Each thread increments its own shard (plain
+// relaxed load/store, no locked instructions); shards are linked into a
+// lock-free list and summed by fp16_path_cov_merge() at the end of a run.
+// Without FP16_PATH_COV the FP16_PATH_HIT() calls expand to nothing.
+//
+// Only the scalar models are instrumented. The batch kernels call them and
+// are counted as well; the branch-free SIMD kernels have no paths to count.
+
+enum Fp16Path {
+    // Adder
+    FP16_PATH_ADD_CALLS,
+    FP16_PATH_ADD_NAN,
+    FP16_PATH_ADD_INF,
+    FP16_PATH_ADD_EXP_DIFF_GE13,
+    FP16_PATH_ADD_SAME_SIGN,
+    FP16_PATH_ADD_DIFF_SIGN,
+    FP16_PATH_ADD_ZERO_RESULT,
+    FP16_PATH_ADD_CARRY_RENORM,
+    FP16_PATH_ADD_NORM_SHIFT_0, // 11 bins: normalize-loop iterations 0..10
+    FP16_PATH_ADD_NORM_SHIFT_10 = FP16_PATH_ADD_NORM_SHIFT_0 + 10,
+    FP16_PATH_ADD_DENORMAL_PACK,
+    FP16_PATH_ADD_OVERFLOW_PACK,
+    FP16_PATH_ADD_PRECISION_LOST,
+    // Multiplier
+    FP16_PATH_MUL_CALLS,
+    FP16_PATH_MUL_NAN,
+    FP16_PATH_MUL_INF_TIMES_ZERO,
+    FP16_PATH_MUL_INF,
+    FP16_PATH_MUL_ZERO_OPERAND,
+    FP16_PATH_MUL_NORM_SHIFT,
+    FP16_PATH_MUL_OVERFLOW,
+    FP16_PATH_MUL_UNDERFLOW_LT_M10,
+    FP16_PATH_MUL_DENORMAL_PACK,
+    FP16_PATH_MUL_NORMAL_PACK,
+    FP16_PATH_COUNT
+};
+
+inline const char* fp16_path_name(int p) {
+    static const char* names[FP16_PATH_COUNT] = {
+        "add.calls", "add.nan", "add.inf", "add.exp_diff>=13", "add.same_sign",
+        "add.diff_sign", "add.zero_result", "add.carry_renorm",
+        "add.norm_shift=0", "add.norm_shift=1", "add.norm_shift=2", "add.norm_shift=3",
+        "add.norm_shift=4", "add.norm_shift=5", "add.norm_shift=6", "add.norm_shift=7",
+        "add.norm_shift=8", "add.norm_shift=9", "add.norm_shift=10",
+        "add.denormal_pack", "add.overflow_pack", "add.precision_lost",
+        "mul.calls", "mul.nan", "mul.inf*zero", "mul.inf", "mul.zero_operand",
+        "mul.norm_shift", "mul.overflow", "mul.underflow<-10", "mul.denormal_pack",
+        "mul.normal_pack"
+    };
+    return names[p];
+}
+
+#ifdef FP16_PATH_COV
+
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+
+// Cache-line aligned so two threads never share a line.
+struct alignas(64) Fp16PathShard {
+    std::atomic<uint64_t> c[FP16_PATH_COUNT];
+    Fp16PathShard* next;
+};
+
+inline std::atomic<Fp16PathShard*>& fp16_path_shards() {
+    static std::atomic<Fp16PathShard*> head{nullptr};
+    return head;
+}
+
+// Shards are never freed, so counts survive thread exit.
+inline Fp16PathShard* fp16_path_new_shard() {
+    Fp16PathShard* s = new Fp16PathShard();
+    for (int i = 0; i < FP16_PATH_COUNT; ++i) s->c[i].store(0, std::memory_order_relaxed);
+    s->next = fp16_path_shards().load(std::memory_order_relaxed);
+    while (!fp16_path_shards().compare_exchange_weak(s->next, s, std::memory_order_release,
+                                                     std::memory_order_relaxed)) {}
+    return s;
+}
+
+inline Fp16PathShard* fp16_path_shard() {
+    thread_local Fp16PathShard* s = fp16_path_new_shard();
+    return s;
+}
+
+// Owner-only increment: a relaxed load/store pair, not a locked RMW.
+inline void fp16_path_hit(int p) {
+    std::atomic<uint64_t>& c = fp16_path_shard()->c[p];
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+#define FP16_PATH_HIT(p) fp16_path_hit(p)
+
+// Sum of all shards. Safe to call while other threads are still counting;
+// the result is then a consistent-per-counter snapshot.
+inline void fp16_path_cov_merge(uint64_t out[FP16_PATH_COUNT]) {
+    for (int i = 0; i < FP16_PATH_COUNT; ++i) out[i] = 0;
+    for (Fp16PathShard* s = fp16_path_shards().load(std::memory_order_acquire); s; s = s->next)
+        for (int i = 0; i < FP16_PATH_COUNT; ++i) out[i] += s->c[i].load(std::memory_order_relaxed);
+}
+
+inline void fp16_path_cov_report(std::ostream& os) {
+    uint64_t c[FP16_PATH_COUNT];
+    fp16_path_cov_merge(c);
+    std::ios saved(nullptr);
+    saved.copyfmt(os);
+    os << std::dec << std::setfill(' ');
+
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os << " Path Coverage (merged over all threads)\n";
+    os << "--------------------------------------------------------------------------------------------------\n";
+    for (int p = 0; p < FP16_PATH_COUNT; ++p) {
+        uint64_t calls = (p < FP16_PATH_MUL_CALLS) ? c[FP16_PATH_ADD_CALLS] : c[FP16_PATH_MUL_CALLS];
+        if (calls == 0) continue;
+        os << "  " << std::left << std::setw(20) << fp16_path_name(p) << std::right
+           << " | " << std::setw(14) << c[p] << " | " << std::fixed << std::setprecision(3)
+           << std::setw(8) << 100.0 * c[p] / calls << " %" << (c[p] ? "" : "  <-- never hit") << "\n";
+    }
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os.copyfmt(saved);
+}
+
+#else
+
+#define FP16_PATH_HIT(p) ((void)0)
+
+inline void fp16_path_cov_report(std::ostream&) {}
+
+#endif // FP16_PATH_COV
+
+#endif // FP16_PATH_COV_H
@@ -0,0 +1,186 @@
+#ifndef FP16_PERF_H
+#define FP16_PERF_H
+
+#include <ostream>
+
+// ----------------------------------------------------------------------------
+// Hardware Performance Counters (optional)
+// ----------------------------------------------------------------------------
+// Build with -DFP16_PERF to count cycles, instructions, branch-misses and
+// cache-misses around every batch kernel call, per kernel and per thread
+// (Linux perf_event_open). Without FP16_PERF, FP16_PERF_SCOPE expands to
+// nothing and fp16_perf_report() prints nothing.
+//
+//   FP16_PERF_SCOPE(FP16_PERF_ADD_SIMD, n);   // first statement of a kernel
+//   ...
+//   fp16_perf_report(std::cout);              // at the end of the run
+
+enum Fp16PerfKernel {
+    FP16_PERF_ADD_BATCH,
+    FP16_PERF_ADD_SIMD,
+    FP16_PERF_MUL_BATCH,
+    FP16_PERF_MUL_SIMD,
+    FP16_PERF_TO_FLOAT,
+    FP16_PERF_TO_FP16,
+    FP16_PERF_KERNEL_COUNT
+};
+
+#ifdef FP16_PERF
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+enum { FP16_PERF_CYCLES, FP16_PERF_INSNS, FP16_PERF_BRANCH_MISS, FP16_PERF_CACHE_MISS, FP16_PERF_EVENTS };
+
+struct Fp16PerfCounts {
+    uint64_t calls = 0;
+    uint64_t elems = 0;
+    uint64_t ev[FP16_PERF_EVENTS] = {0, 0, 0, 0};
+};
+
+// One record per thread. Records are owned by the registry so the numbers
+// survive thread exit and can be reported at the end of the run.
+struct Fp16PerfThread {
+    int tid = 0;
+    bool ok = false;
+    Fp16PerfCounts k[FP16_PERF_KERNEL_COUNT];
+};
+
+inline std::mutex& fp16_perf_mutex() { static std::mutex m; return m; }
+inline std::vector<Fp16PerfThread*>& fp16_perf_threads() {
+    static std::vector<Fp16PerfThread*> v; return v;
+}
+
+// Per-thread counter group; the leader is the cycle counter.
+class Fp16PerfGroup {
+public:
+    Fp16PerfGroup() {
+        static const uint64_t configs[FP16_PERF_EVENTS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES
+        };
+        rec_ = new Fp16PerfThread();
+        rec_->tid = (int)syscall(SYS_gettid);
+        bool ok = true;
+        for (int e = 0; e < FP16_PERF_EVENTS; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = (e == 0);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            fd_[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, e ? fd_[0] : -1, 0);
+            if (fd_[e] < 0) { ok = false; break; }
+        }
+        if (ok) ioctl(fd_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        rec_->ok = ok;
+        std::lock_guard<std::mutex> lock(fp16_perf_mutex());
+        fp16_perf_threads().push_back(rec_);
+    }
+    ~Fp16PerfGroup() {
+        for (int e = 0; e < FP16_PERF_EVENTS; ++e) if (fd_[e] >= 0) close(fd_[e]);
+    }
+
+    bool read(uint64_t* out) const {
+        if (!rec_->ok) return false;
+        uint64_t buf[1 + FP16_PERF_EVENTS];
+        if (::read(fd_[0], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) return false;
+        std::memcpy(out, buf + 1, sizeof(uint64_t) * FP16_PERF_EVENTS);
+        return true;
+    }
+    Fp16PerfThread* record() { return rec_; }
+
+private:
+    int fd_[FP16_PERF_EVENTS] = {-1, -1, -1, -1};
+    Fp16PerfThread* rec_;
+};
+
+inline Fp16PerfGroup& fp16_perf_group() {
+    thread_local Fp16PerfGroup g;
+    return g;
+}
+
+// RAII scope: counter deltas between construction and destruction are
+// charged to `kernel` on the calling thread.
+class Fp16PerfScope {
+public:
+    Fp16PerfScope(Fp16PerfKernel kernel, size_t n)
+        : group_(fp16_perf_group()), kernel_(kernel), n_(n) {
+        ok_ = group_.read(start_);
+    }
+    ~Fp16PerfScope() {
+        uint64_t end[FP16_PERF_EVENTS];
+        Fp16PerfCounts& c = group_.record()->k[kernel_];
+        c.calls++;
+        c.elems += n_;
+        if (ok_ && group_.read(end))
+            for (int e = 0; e < FP16_PERF_EVENTS; ++e) c.ev[e] += end[e] - start_[e];
+    }
+
+private:
+    Fp16PerfGroup& group_;
+    Fp16PerfKernel kernel_;
+    size_t n_;
+    bool ok_;
+    uint64_t start_[FP16_PERF_EVENTS];
+};
+
+#define FP16_PERF_SCOPE(kernel, n) Fp16PerfScope fp16_perf_scope_((kernel), (n))
+
+inline void fp16_perf_report(std::ostream& os) {
+    static const char* names[FP16_PERF_KERNEL_COUNT] = {
+        "add_batch", "add_simd", "mul_batch", "mul_simd", "to_float", "to_fp16"
+    };
+    std::lock_guard<std::mutex> lock(fp16_perf_mutex());
+    std::ios saved(nullptr);
+    saved.copyfmt(os);
+    os << std::dec << std::setfill(' ');
+
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os << " Hardware Counters per Kernel Batch (per thread)\n";
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os << "  Thread  | Kernel    ||    Calls |      Elems | cyc/elem | insn/elem |  IPC  | br-miss/elem | $-miss/elem\n";
+    os << "--------------------------------------------------------------------------------------------------\n";
+    for (const Fp16PerfThread* t : fp16_perf_threads()) {
+        for (int k = 0; k < FP16_PERF_KERNEL_COUNT; ++k) {
+            const Fp16PerfCounts& c = t->k[k];
+            if (c.calls == 0) continue;
+            os << "  " << std::setw(7) << t->tid << " | " << std::left << std::setw(9) << names[k]
+               << std::right << " || " << std::setw(8) << c.calls << " | " << std::setw(10) << c.elems;
+            if (!t->ok || c.elems == 0) {
+                os << " | (perf_event_open unavailable)\n";
+                continue;
+            }
+            double n = (double)c.elems;
+            double cyc = (double)c.ev[FP16_PERF_CYCLES];
+            os << std::fixed << std::setprecision(3)
+               << " | " << std::setw(8) << cyc / n
+               << " | " << std::setw(9) << c.ev[FP16_PERF_INSNS] / n
+               << " | " << std::setw(5) << (cyc ? c.ev[FP16_PERF_INSNS] / cyc : 0.0)
+               << " | " << std::setw(12) << c.ev[FP16_PERF_BRANCH_MISS] / n
+               << " | " << std::setw(11) << c.ev[FP16_PERF_CACHE_MISS] / n << "\n";
+        }
+    }
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os.copyfmt(saved);
+}
+
+#else
+
+#define FP16_PERF_SCOPE(kernel, n) ((void)0)
+
+inline void fp16_perf_report(std::ostream&) {}
+
+#endif // FP16_PERF
+
+#endif // FP16_PERF_H
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "fp16_oracle.h"
+#include "fp16_pipe.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+#include "fp16_workload.h"
+#include "fpadder_rtl.h"
+
+// ----------------------------------------------------------------------------
+// MAC Pipeline Throughput and Accuracy vs Interleaved Accumulators
+// ----------------------------------------------------------------------------
+// Usage: fp16_pipe [--acc K1,K2,...] [--len N1,N2,...] [--workload NAME] [--outputs M]
+//                  [--add-latency A] [--mul-latency L] [--adder bittrue|rtl] [--seed S] [--threads T]
+//
+// Runs M dot products of each length N (operands from one fp16_workload.h
+// workload, default fc) through the cycle-level MAC pipeline of
+// fp16_pipe.h with K interleaved accumulators, and reports the cycles per
+// dot product, the hazard stall and merge cycles, the achieved MACs per
+// cycle and the error against the exact dot product (FP16 ULPs at the
+// exact result; "CR %" is the share of outputs equal to the correctly
+// rounded RNE result). Every output is seeded from (seed, N, output), so
+// results are identical for any thread count.
+
+struct PipeRow {
+    Fp16PipeStats st;
+    Fp16WorkloadScore err;
+
+    void merge(const PipeRow& o) {
+        st.merge(o.st);
+        err.merge(o.err);
+    }
+};
+
+static bool parse_list(const std::string& list, std::vector<uint64_t>& out) {
+    out.clear();
+    for (size_t pos = 0; pos <= list.size();) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        if (end == pos) return false;
+        uint64_t v;
+        try {
+            v = std::stoull(list.substr(pos, end - pos));
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (v == 0) return false;
+        out.push_back(v);
+        pos = end + 1;
+    }
+    return !out.empty();
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t outputs = 16;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string acc_list = "1,2,4,8", len_list = "16,256,4096,65536,1048576", name = "fc", adder = "bittrue";
+    Fp16PipeConfig base;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--acc" && i + 1 < argc) acc_list = argv[++i];
+        else if (arg == "--len" && i + 1 < argc) len_list = argv[++i];
+        else if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--outputs" && i + 1 < argc) outputs = std::stoull(argv[++i]);
+        else if (arg == "--add-latency" && i + 1 < argc) base.add_latency = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--mul-latency" && i + 1 < argc) base.mul_latency = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--adder" && i + 1 < argc) adder = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--acc K1,K2,...] [--len N1,N2,...] [--workload NAME] [--outputs M]"
+                      << " [--add-latency A] [--mul-latency L] [--adder bittrue|rtl] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+
+    std::vector<uint64_t> accs, lens;
+    if (!parse_list(acc_list, accs) || !parse_list(len_list, lens) || base.add_latency == 0) {
+        std::cerr << "--acc, --len and --add-latency need positive values\n";
+        return 1;
+    }
+    if (adder == "rtl") base.add = fpadder_rtl;
+    else if (adder != "bittrue") {
+        std::cerr << "Unknown adder: " << adder << " (available: bittrue rtl)\n";
+        return 1;
+    }
+    Fp16Workload wl;
+    if (!fp16_workload(name, wl)) {
+        fp16_workload_unknown(name);
+        return 1;
+    }
+
+    Fp16Pool pool(threads ? threads : 1);
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << ", workload " << wl.name << ", "
+              << outputs << " outputs per length, adder " << adder << " (" << base.add_latency
+              << " cycles), multiplier " << base.mul_latency << " cycles, " << pool.size() << " thread(s)\n";
+
+    for (uint64_t len : lens) {
+        std::vector<std::vector<PipeRow>> part(pool.size(), std::vector<PipeRow>(accs.size()));
+        std::vector<std::vector<fp16_t>> a(pool.size()), w(pool.size());
+        pool.parallel_for(0, outputs, 1, [&](uint64_t lo, uint64_t hi, unsigned t) {
+            Fp16Workload wk = wl;
+            wk.k = (uint32_t)len;
+            a[t].resize(len); w[t].resize(len);
+            for (uint64_t o = lo; o < hi; ++o) {
+                Xoshiro256 g(fp16_rng_chunk_seed(seed ^ fp16_mix64(len), o));
+                fp16_workload_fill(wk, g, a[t].data(), w[t].data());
+                double exact = fp16_workload_exact_dot(a[t].data(), w[t].data(), len);
+
+                for (size_t ki = 0; ki < accs.size(); ++ki) {
+                    Fp16PipeConfig cfg = base;
+                    cfg.accumulators = (uint32_t)accs[ki];
+                    Fp16MacPipe pipe(cfg);
+                    PipeRow& r = part[t][ki];
+                    fp16_t out = pipe.dot(a[t].data(), w[t].data(), len, r.st);
+                    fp16_workload_score(r.err, out, exact);
+                }
+            }
+        });
+
+        std::cout << "--------------------------------------------------------------------------------------------------\n"
+                  << " N = " << len << "\n"
+                  << "--------------------------------------------------------------------------------------------------\n"
+                  << "    K | Cycles / dot | Stalls / dot | Merge | MACs/cycle | Mean rel err | Max rel err | Mean |ULP| |    CR %\n"
+                  << "--------------------------------------------------------------------------------------------------\n";
+        for (size_t ki = 0; ki < accs.size(); ++ki) {
+            PipeRow r;
+            for (const std::vector<PipeRow>& p : part) r.merge(p[ki]);
+            double n = (double)r.err.outputs;
+            std::cout << "  " << std::setw(3) << accs[ki] << " | " << std::fixed << std::setprecision(1) << std::setw(12)
+                      << r.st.cycles / n << " | " << std::setw(12) << r.st.hazard_stalls / n << " | " << std::setw(5)
+                      << r.st.merge_cycles / n << " | " << std::setprecision(4) << std::setw(10)
+                      << r.st.macs_per_cycle() << " | " << std::scientific << std::setw(12)
+                      << r.err.mean_rel() << " | " << std::setw(11) << r.err.max_rel << " | " << std::fixed
+                      << std::setw(10) << r.err.mean_ulp() << " | " << std::setprecision(2) << std::setw(7)
+                      << r.err.cr_percent() << "\n";
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------\n";
+    return 0;
+}
@@ -0,0 +1,152 @@
+#ifndef FP16_PIPE_H
+#define FP16_PIPE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_tree.h"
+
+// ----------------------------------------------------------------------------
+// Cycle-Level MAC Pipeline
+// ----------------------------------------------------------------------------
+// One multiplier and one adder, both fully pipelined:
+//   multiplier : mul_latency stages, one operand pair enters per cycle
+//   adder      : add_latency stages (fpadder.v: result_r, then the output
+//                registers = 2), one add issues per cycle
+// Product j is added into accumulator j mod K (round robin over K
+// interleaved partial accumulators, all starting at +0). An accumulator
+// with an add still in flight cannot be read (read-after-write hazard):
+// the product waits at the multiplier output and the whole front end
+// stalls. A result is visible to the issue logic in the cycle it leaves
+// the adder, so one accumulator sustains 1 / add_latency MACs per cycle
+// and K >= add_latency accumulators sustain 1.
+//
+// After the last product the K partials are merged on the same adder along
+// a pairwise fp16_tree.h tree; a merge add issues as soon as both of its
+// operands have left the adder (oldest ready node first).
+
+// Scalar bit-true operation: fp16_add_bittrue, fp16_mul_bittrue,
+// fpadder_rtl, ...
+using Fp16ScalarOp = BitTrueResult (*)(fp16_t, fp16_t);
+
+struct Fp16PipeConfig {
+    uint32_t accumulators = 1;
+    uint32_t mul_latency = 2;
+    uint32_t add_latency = 2;
+    Fp16ScalarOp mul = fp16_mul_bittrue;
+    Fp16ScalarOp add = fp16_add_bittrue;
+};
+
+struct Fp16PipeStats {
+    uint64_t macs = 0;
+    uint64_t cycles = 0;        // first operand in to result out
+    uint64_t hazard_stalls = 0; // cycles a product waited on a busy accumulator
+    uint64_t merge_cycles = 0;  // cycles after the last product issued
+    uint8_t flags = 0;          // OR of all multiplier and adder flags
+
+    double macs_per_cycle() const { return cycles ? (double)macs / cycles : 0.0; }
+
+    void merge(const Fp16PipeStats& o) {
+        macs += o.macs; cycles += o.cycles; hazard_stalls += o.hazard_stalls; merge_cycles += o.merge_cycles;
+        flags |= o.flags;
+    }
+};
+
+class Fp16MacPipe {
+public:
+    explicit Fp16MacPipe(const Fp16PipeConfig& cfg)
+        : cfg_(cfg), tree_(fp16_tree_build(FP16_TREE_PAIRWISE, cfg.accumulators ? cfg.accumulators : 1)) {
+        if (cfg_.accumulators == 0) cfg_.accumulators = 1;
+        if (cfg_.add_latency == 0) cfg_.add_latency = 1;
+        val_.resize(tree_.slots());
+        busy_.resize(tree_.slots());
+        ready_.resize(tree_.slots());
+        pipe_.resize(cfg_.add_latency);
+    }
+
+    // a . b over n pairs, simulated cycle by cycle; stats are added to st.
+    fp16_t dot(const fp16_t* a, const fp16_t* b, size_t n, Fp16PipeStats& st) {
+        const uint32_t K = cfg_.accumulators, M = cfg_.mul_latency;
+        for (uint32_t s = 0; s < tree_.slots(); ++s) { val_[s] = 0; busy_[s] = 0; ready_[s] = s < K; }
+        for (Stage& p : pipe_) p.valid = false;
+        t_ = 0;
+
+        // Accumulate. The multiplier output holds product j from cycle
+        // head_ready on: j + M without stalls, one cycle after the previous
+        // issue once the stalled pipeline is full.
+        uint64_t head_ready = M;
+        uint32_t rr = 0;
+        for (size_t j = 0; j < n; ++t_) {
+            retire();
+            if (t_ < head_ready) continue;
+            if (busy_[rr]) {
+                st.hazard_stalls++;
+                continue;
+            }
+            BitTrueResult p = cfg_.mul(a[j], b[j]);
+            st.flags |= pack_flags(p);
+            issue(rr, val_[rr], p.res, st);
+            rr = rr + 1 == K ? 0 : rr + 1;
+            ++j;
+            head_ready = (j + M > t_ + 1) ? j + M : t_ + 1;
+        }
+        uint64_t acc_end = t_;
+
+        // Merge the partial accumulators
+        std::vector<bool> done(tree_.nodes.size(), false);
+        size_t left = tree_.nodes.size();
+        for (;; ++t_) {
+            retire();
+            if (left == 0 && !busy_[tree_.out]) break;
+            for (size_t i = 0; i < tree_.nodes.size(); ++i) {
+                const Fp16TreeNode& nd = tree_.nodes[i];
+                if (done[i] || busy_[nd.a] || busy_[nd.b] || !ready_[nd.a] || !ready_[nd.b]) continue;
+                issue(nd.dst, val_[nd.a], val_[nd.b], st);
+                done[i] = true;
+                --left;
+                break;
+            }
+        }
+        st.macs += n;
+        st.cycles += t_;
+        st.merge_cycles += t_ - acc_end;
+        return val_[tree_.out];
+    }
+
+private:
+    struct Stage {
+        bool valid;
+        uint32_t dst;
+        fp16_t res;
+    };
+
+    void issue(uint32_t dst, fp16_t x, fp16_t y, Fp16PipeStats& st) {
+        BitTrueResult r = cfg_.add(x, y);
+        st.flags |= pack_flags(r);
+        pipe_[t_ % cfg_.add_latency] = {true, dst, r.res};
+        busy_[dst] = 1;
+    }
+
+    // The add issued add_latency cycles ago leaves the adder.
+    void retire() {
+        Stage& s = pipe_[t_ % cfg_.add_latency];
+        if (!s.valid) return;
+        val_[s.dst] = s.res;
+        busy_[s.dst] = 0;
+        ready_[s.dst] = 1;
+        s.valid = false;
+    }
+
+    Fp16PipeConfig cfg_;
+    Fp16Tree tree_;
+    std::vector<fp16_t> val_;
+    std::vector<uint8_t> busy_, ready_; // ready: holds a value (merge slots once written)
+    std::vector<Stage> pipe_;
+    uint64_t t_ = 0;
+};
+
+#endif // FP16_PIPE_H
@@ -0,0 +1,190 @@
+#ifndef FP16_POOL_H
+#define FP16_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Work-Stealing Thread Pool
+// ----------------------------------------------------------------------------
+// Shared scheduler for the reference tools. Work is an index range split
+// into chunks of at most `grain` indices:
+//   - each worker owns a deque of ranges, seeded with an equal slice
+//   - the owner pops from the back and takes one grain off the low end;
+//     the rest is pushed back, so big ranges stay available to thieves
+//   - an idle worker steals from the front (largest range) of a victim
+// Uneven chunks (NaN/Inf rows that short-circuit, tiles of different size)
+// are thereby balanced without a central queue. The calling thread runs as
+// worker 0; the others sleep between jobs.
+//
+//   Fp16Pool pool(threads);                       // 0 = hardware_concurrency
+//   pool.parallel_for(0, n, 4096, [&](uint64_t lo, uint64_t hi, unsigned w) { ... });
+//   uint64_t s = pool.parallel_reduce<uint64_t>(0, n, 4096, 0,
+//       [&](uint64_t lo, uint64_t hi, uint64_t& acc) { ... },
+//       [](uint64_t& x, const uint64_t& y) { x += y; });
+
+// Default grain for element-wise kernels: large enough to amortize the deque
+// locks, small enough (64 KiB of fp16 per operand) to stay in L2.
+enum { FP16_POOL_GRAIN = 1 << 15 };
+
+class Fp16Pool {
+public:
+    using Body = std::function<void(uint64_t, uint64_t, unsigned)>;
+
+    explicit Fp16Pool(unsigned threads = 0) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        workers_.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) workers_.emplace_back(new Worker());
+        for (unsigned t = 1; t < threads; ++t) threads_.emplace_back([this, t] { loop(t); });
+    }
+
+    ~Fp16Pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            quit_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread& th : threads_) th.join();
+    }
+
+    Fp16Pool(const Fp16Pool&) = delete;
+    Fp16Pool& operator=(const Fp16Pool&) = delete;
+
+    unsigned size() const { return (unsigned)workers_.size(); }
+
+    // body(lo, hi, worker) for disjoint [lo, hi) covering [begin, end).
+    // Returns when every index has been processed. Not reentrant: body must
+    // not call back into the same pool.
+    void parallel_for(uint64_t begin, uint64_t end, uint64_t grain, const Body& body) {
+        if (end <= begin) return;
+        if (grain == 0) grain = 1;
+        unsigned nw = size();
+        if (nw == 1 || end - begin <= grain) { body(begin, end, 0); return; }
+
+        std::lock_guard<std::mutex> job_lock(job_m_); // one job at a time
+        body_ = &body;
+        grain_ = grain;
+        uint64_t n = end - begin;
+        for (unsigned t = 0; t < nw; ++t) {
+            uint64_t lo = begin + n * t / nw, hi = begin + n * (t + 1) / nw;
+            std::lock_guard<std::mutex> lock(workers_[t]->m);
+            if (lo < hi) workers_[t]->dq.push_back({lo, hi});
+        }
+        remaining_.store(n, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            ++generation_;
+        }
+        cv_.notify_all();
+
+        work(0);
+        while (active_.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+        body_ = nullptr;
+    }
+
+    // Each worker folds its chunks into a private accumulator (initialized
+    // to init); the accumulators are then combined in worker order.
+    template <typename T, typename F, typename C>
+    T parallel_reduce(uint64_t begin, uint64_t end, uint64_t grain, const T& init, F body, C combine) {
+        struct alignas(64) Slot { T v; };
+        std::vector<Slot> acc(size(), Slot{init});
+        parallel_for(begin, end, grain, [&](uint64_t lo, uint64_t hi, unsigned w) { body(lo, hi, acc[w].v); });
+        T r = init;
+        for (const Slot& s : acc) combine(r, s.v);
+        return r;
+    }
+
+private:
+    struct Range { uint64_t lo, hi; };
+
+    // Cache-line aligned so two workers never share a line.
+    struct alignas(64) Worker {
+        std::mutex m;
+        std::deque<Range> dq;
+    };
+
+    bool pop(unsigned w, Range& r) {
+        Worker& me = *workers_[w];
+        std::lock_guard<std::mutex> lock(me.m);
+        if (me.dq.empty()) return false;
+        r = me.dq.back();
+        me.dq.pop_back();
+        if (r.hi - r.lo > grain_) { // keep the first grain, offer the rest
+            me.dq.push_back({r.lo + grain_, r.hi});
+            r.hi = r.lo + grain_;
+        }
+        return true;
+    }
+
+    bool steal(unsigned w, Range& r) {
+        unsigned nw = size();
+        for (unsigned k = 1; k < nw; ++k) {
+            Worker& v = *workers_[(w + k) % nw];
+            std::lock_guard<std::mutex> lock(v.m);
+            if (v.dq.empty()) continue;
+            r = v.dq.front();
+            v.dq.pop_front();
+            if (r.hi - r.lo > grain_) { // take half of the victim's largest range
+                uint64_t mid = r.lo + (r.hi - r.lo) / 2;
+                v.dq.push_front({mid, r.hi});
+                r.hi = mid;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void work(unsigned w) {
+        active_.fetch_add(1, std::memory_order_acq_rel);
+        Range r;
+        while (remaining_.load(std::memory_order_acquire) != 0) {
+            if (pop(w, r) || steal(w, r)) {
+                if (r.hi - r.lo > grain_) { // stolen half: split locally
+                    Worker& me = *workers_[w];
+                    std::lock_guard<std::mutex> lock(me.m);
+                    me.dq.push_back(r);
+                    continue;
+                }
+                (*body_)(r.lo, r.hi, w);
+                remaining_.fetch_sub(r.hi - r.lo, std::memory_order_acq_rel);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        active_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void loop(unsigned w) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                cv_.wait(lock, [&] { return quit_ || generation_ != seen; });
+                if (quit_) return;
+                seen = generation_;
+            }
+            work(w);
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::mutex m_, job_m_;
+    std::condition_variable cv_;
+    uint64_t generation_ = 0;
+    bool quit_ = false;
+    const Body* body_ = nullptr;
+    uint64_t grain_ = 1;
+    alignas(64) std::atomic<uint64_t> remaining_{0};
+    alignas(64) std::atomic<unsigned> active_{0};
+};
+
+#endif // FP16_POOL_H
@@ -0,0 +1,142 @@
+#ifndef FP16_REPORT_H
+#define FP16_REPORT_H
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "fp16_common.h"
+
+// ----------------------------------------------------------------------------
+// Bulk Report Writer
+// ----------------------------------------------------------------------------
+// Formats verification rows (Input A, Input B, HW Res, TLM Res, Match, OF,
+// Z, NaN, PL, Note) without iostream manipulators: hex digits come from a
+// 256-entry byte table, fields are appended with memcpy into a reusable
+// FP16_REPORT_BUFFER-byte buffer, and each full buffer is handed to the
+// stream with a single write(). Formats:
+//   table : the fixed-width table of the reference mains (byte-identical)
+//   csv   : one header line, then one line per row
+//   jsonl : one JSON object per row
+// The PL column is optional (the multiplier table has none). Notes are
+// written verbatim and must not contain quotes.
+
+enum { FP16_REPORT_BUFFER = 1 << 20 };
+
+enum Fp16ReportFormat { FP16_REPORT_TABLE, FP16_REPORT_CSV, FP16_REPORT_JSONL };
+
+inline bool fp16_report_format(const std::string& name, Fp16ReportFormat& out) {
+    if (name == "table") out = FP16_REPORT_TABLE;
+    else if (name == "csv") out = FP16_REPORT_CSV;
+    else if (name == "jsonl") out = FP16_REPORT_JSONL;
+    else return false;
+    return true;
+}
+
+struct Fp16HexTable {
+    char d[256][2];
+    constexpr Fp16HexTable() : d() {
+        for (int i = 0; i < 256; ++i) {
+            d[i][0] = "0123456789ABCDEF"[i >> 4];
+            d[i][1] = "0123456789ABCDEF"[i & 15];
+        }
+    }
+};
+
+inline constexpr Fp16HexTable FP16_HEX_TABLE{};
+
+class Fp16ReportWriter {
+public:
+    Fp16ReportWriter(std::ostream& os, Fp16ReportFormat fmt, bool pl_column)
+        : os_(os), fmt_(fmt), pl_(pl_column), buf_(FP16_REPORT_BUFFER), pos_(0) {}
+
+    ~Fp16ReportWriter() { flush(); }
+
+    Fp16ReportWriter(const Fp16ReportWriter&) = delete;
+    Fp16ReportWriter& operator=(const Fp16ReportWriter&) = delete;
+
+    // Table banner and column header, or the CSV header line.
+    void header(const char* title) {
+        if (fmt_ == FP16_REPORT_TABLE) {
+            put(DASHES); put(" "); put(title); put("\n"); put(DASHES);
+            put(pl_ ? "  Input A  |  Input B  || HW Res  | TLM Res | Match? | OF | Z | NaN| PL | Note\n"
+                    : "  Input A  |  Input B  || HW Res  | TLM Res | Match? | OF | Z | NaN| Note\n");
+            put(DASHES);
+        } else if (fmt_ == FP16_REPORT_CSV) {
+            put(pl_ ? "input_a,input_b,hw_res,tlm_res,match,of,z,nan,pl,note\n"
+                    : "input_a,input_b,hw_res,tlm_res,match,of,z,nan,note\n");
+        }
+    }
+
+    void row(fp16_t a, fp16_t b, fp16_t hw, fp16_t tlm, uint8_t flags, bool match, const char* note) {
+        size_t note_len = std::strlen(note);
+        if (pos_ + ROW_MAX + note_len > buf_.size()) flush();
+        char of = '0' + ((flags & FP16_FLAG_OF) != 0), z = '0' + ((flags & FP16_FLAG_Z) != 0);
+        char nan = '0' + ((flags & FP16_FLAG_NAN) != 0), pl = '0' + ((flags & FP16_FLAG_PL) != 0);
+
+        if (fmt_ == FP16_REPORT_TABLE) {
+            put("  0x"); hex4(a); put("   |  0x"); hex4(b);
+            put("   || 0x"); hex4(hw); put("  | 0x"); hex4(tlm);
+            put("  |   "); ch(match ? 'O' : 'X');
+            put("    | "); ch(of); put("  | "); ch(z); put(" | "); ch(nan);
+            if (pl_) { put("  | "); ch(pl); }
+            put("  | ");
+            put(note, note_len);
+            ch('\n');
+        } else if (fmt_ == FP16_REPORT_CSV) {
+            put("0x"); hex4(a); put(",0x"); hex4(b); put(",0x"); hex4(hw); put(",0x"); hex4(tlm);
+            ch(','); ch(match ? '1' : '0');
+            ch(','); ch(of); ch(','); ch(z); ch(','); ch(nan);
+            if (pl_) { ch(','); ch(pl); }
+            put(",\""); put(note, note_len); put("\"\n");
+        } else {
+            put("{\"input_a\":\"0x"); hex4(a); put("\",\"input_b\":\"0x"); hex4(b);
+            put("\",\"hw_res\":\"0x"); hex4(hw); put("\",\"tlm_res\":\"0x"); hex4(tlm);
+            put(match ? "\",\"match\":true" : "\",\"match\":false");
+            put(",\"of\":"); ch(of); put(",\"z\":"); ch(z); put(",\"nan\":"); ch(nan);
+            if (pl_) { put(",\"pl\":"); ch(pl); }
+            put(",\"note\":\""); put(note, note_len); put("\"}\n");
+        }
+    }
+
+    // Closing table rule (nothing for CSV / JSON lines).
+    void footer() {
+        if (fmt_ == FP16_REPORT_TABLE) put(DASHES);
+    }
+
+    void flush() {
+        if (pos_) os_.write(buf_.data(), (std::streamsize)pos_);
+        pos_ = 0;
+        os_.flush();
+    }
+
+private:
+    static constexpr const char* DASHES =
+        "--------------------------------------------------------------------------------------------------\n";
+    static constexpr size_t ROW_MAX = 192; // longest row without its note
+
+    void put(const char* s, size_t n) {
+        if (pos_ + n > buf_.size()) flush();
+        if (n > buf_.size()) { os_.write(s, (std::streamsize)n); return; }
+        std::memcpy(buf_.data() + pos_, s, n);
+        pos_ += n;
+    }
+    // Literals: the length is a compile-time constant after inlining.
+    void put(const char* s) { put(s, std::strlen(s)); }
+    void ch(char c) { buf_[pos_++] = c; }
+    void hex4(fp16_t v) {
+        std::memcpy(buf_.data() + pos_, FP16_HEX_TABLE.d[v >> 8], 2);
+        std::memcpy(buf_.data() + pos_ + 2, FP16_HEX_TABLE.d[v & 0xFF], 2);
+        pos_ += 4;
+    }
+
+    std::ostream& os_;
+    Fp16ReportFormat fmt_;
+    bool pl_;
+    std::vector<char> buf_;
+    size_t pos_;
+};
+
+#endif // FP16_REPORT_H
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#include "fp16_npy.h"
+#include "fp16_pool.h"
+#include "fp16_resdiff.h"
+
+// ----------------------------------------------------------------------------
+// Result-File Diff
+// ----------------------------------------------------------------------------
+// Usage: fp16_resdiff FILE_A FILE_B [--format golden|u16] [--flags] [--zero-sign-equal] [--first K]
+//                     [--threads T]
+//
+// Maps two result dumps (RTL simulation, the C++ models, the FPGA board)
+// and compares them with fp16_resdiff.h:
+//   golden : 4-byte { res, flags, 0 } records (default), as written by
+//            --filter and fp16_vecgen --format bin. --flags also compares
+//            the flag bytes.
+//   u16    : FP16 arrays, raw uint16 or .npy float16 / uint16.
+// NaN equals NaN whatever the bits (golden: by the NaN flag). +0 vs -0 is
+// a mismatch, as in fp16_oracle_classify, unless --zero-sign-equal. Prints
+// the element and mismatch counts, the ULP histogram of the mismatches,
+// the first K (default 10) mismatches with their byte offsets and the scan
+// bandwidth. Files of different length are compared over the shorter one
+// and reported.
+// Exit status: 0 if identical under these rules, 1 otherwise.
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    Fp16ResFormat fmt = FP16_RES_GOLDEN;
+    bool flags = false, zero_sign_equal = false, ok = true;
+    size_t keep = 10;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            std::string f = argv[++i];
+            if (f == "golden") fmt = FP16_RES_GOLDEN;
+            else if (f == "u16") fmt = FP16_RES_U16;
+            else ok = false;
+        }
+        else if (arg == "--flags") flags = true;
+        else if (arg == "--zero-sign-equal") zero_sign_equal = true;
+        else if (arg == "--first" && i + 1 < argc) keep = std::stoull(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else if (arg.compare(0, 2, "--") != 0) files.push_back(arg);
+        else ok = false;
+    }
+    if (!ok || files.size() != 2 || (flags && fmt != FP16_RES_GOLDEN)) {
+        std::cerr << "Usage: " << argv[0] << " FILE_A FILE_B [--format golden|u16] [--flags] [--zero-sign-equal]"
+                  << " [--first K] [--threads T]\n"
+                  << "       (--flags needs --format golden)\n";
+        return 1;
+    }
+
+    Fp16Mapped map[2];
+    const void* data[2];
+    size_t count[2], offset[2] = {0, 0}; // elements, data offset in the file
+    for (int f = 0; f < 2; ++f) {
+        if (fmt == FP16_RES_GOLDEN) {
+            if (!map[f].open_read(files[f])) return 1;
+            if (map[f].size() % 4) {
+                std::cerr << files[f] << ": " << map[f].size() << " bytes is not a whole number of 4-byte records\n";
+                return 1;
+            }
+            data[f] = map[f].data();
+            count[f] = map[f].size() / 4;
+        } else {
+            Fp16NpyArray arr;
+            const fp16_t* p;
+            if (!fp16_npy_open(files[f], map[f], arr, p)) return 1;
+            data[f] = p;
+            count[f] = arr.count();
+            offset[f] = arr.offset;
+        }
+    }
+    size_t n = count[0] < count[1] ? count[0] : count[1];
+
+    Fp16Pool pool(threads ? threads : 1);
+    auto t0 = std::chrono::steady_clock::now();
+    Fp16ResDiffStats st = fp16_resdiff_parallel(pool, fmt, data[0], data[1], n, flags, zero_sign_equal, keep);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double bytes = 2.0 * n * (fmt == FP16_RES_GOLDEN ? 4 : 2);
+
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << " " << files[0] << " vs " << files[1] << " (" << (fmt == FP16_RES_GOLDEN ? "golden" : "u16")
+              << (flags ? ", with flags" : "") << (zero_sign_equal ? ", +0 = -0" : "") << ")\n"
+              << "--------------------------------------------------------------------------------------------------\n"
+              << "  Compared     : " << st.compared << " elements in " << std::fixed << std::setprecision(3) << sec
+              << " s, " << std::setprecision(2) << bytes / sec / 1e9 << " GB/s, " << pool.size() << " thread(s)\n";
+    if (count[0] != count[1]) {
+        std::cout << "  Length       : " << count[0] << " vs " << count[1] << " elements; the last "
+                  << (count[0] > count[1] ? count[0] - count[1] : count[1] - count[0]) << " not compared\n";
+    }
+    std::cout << "  Mismatches   : " << st.mismatches << " (" << std::setprecision(6)
+              << (n ? 100.0 * st.mismatches / n : 0.0) << " %): " << st.nan_vs_num << " NaN vs number, "
+              << st.flags_only << " flags only";
+    if (!zero_sign_equal) std::cout << ", " << st.zero_sign << " +0 vs -0";
+    std::cout << "\n  Equal        : " << st.nan_equal << " NaN pairs with different bits";
+    if (zero_sign_equal) std::cout << ", " << st.zero_sign << " +0 / -0 pairs";
+    std::cout << "\n";
+    if (st.mismatches > st.nan_vs_num + st.flags_only + (zero_sign_equal ? 0 : st.zero_sign)) {
+        std::cout << "  ULP deltas   :";
+        for (size_t b = 0; b < FP16_RESDIFF_BUCKETS; ++b) {
+            std::cout << " " << fp16_resdiff_bucket_name(b) << ": " << st.ulp_hist[b];
+        }
+        std::cout << "; max " << st.max_ulp << "\n";
+    }
+    if (!st.first.empty()) {
+        std::cout << "  First " << st.first.size() << " mismatch(es):\n"
+                  << "  " << std::setw(14) << "index" << std::setw(16) << "offset in A" << std::setw(12) << "A"
+                  << std::setw(12) << "B" << std::setw(10) << "ULPs" << "\n";
+        int w = fmt == FP16_RES_GOLDEN ? 8 : 4;
+        auto hex = [w](uint32_t v) {
+            std::ostringstream os;
+            os << "0x" << std::hex << std::uppercase << std::setw(w) << std::setfill('0') << v;
+            return os.str();
+        };
+        for (const Fp16ResMismatch& m : st.first) {
+            std::cout << "  " << std::setw(14) << m.index << std::setw(16)
+                      << offset[0] + m.index * (fmt == FP16_RES_GOLDEN ? 4 : 2) << std::setw(12) << hex(m.a) << std::setw(12)
+                      << hex(m.b) << std::setw(10) << (m.ulp || ((m.a | m.b) & 0x7FFF) == 0 ? std::to_string(m.ulp) : std::string("-")) << "\n";
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------\n";
+    return st.mismatches || count[0] != count[1] ? 1 : 0;
+}
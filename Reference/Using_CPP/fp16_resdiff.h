@@ -0,0 +1,175 @@
+#ifndef FP16_RESDIFF_H
+#define FP16_RESDIFF_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Result-File Comparison
+// ----------------------------------------------------------------------------
+// Compares two result arrays element by element:
+//   golden : 4-byte records { uint16 res, uint8 flags, uint8 0 } (the
+//            --filter / fp16_vecgen .bin format). A record is NaN when its
+//            FP16_FLAG_NAN bit is set; with `flags` the flag bytes must
+//            match too.
+//   u16    : FP16 bit patterns. NaN is exponent 31 with a non-zero
+//            mantissa.
+// Two NaNs are equal whatever their bits, as in fp16_oracle_classify.
+// +0 vs -0 is a mismatch, as in fp16_oracle_classify and fp16_diff.h,
+// unless zero_sign_equal relaxes it (counted in zero_sign either way).
+// Every other difference is a mismatch; its distance in ULPs is the
+// difference of the values' positions on the ordered FP16 line.
+//
+// Each block of FP16_RESDIFF_BLOCK elements is first checked with a
+// branch-free XOR / OR reduction, which the compiler vectorizes (AVX2 with
+// -march=native); only blocks that differ are walked element by element.
+// fp16_resdiff_parallel splits the arrays into FP16_RESDIFF_CHUNK pieces on
+// the pool and merges them in order, so the counts and the first `keep`
+// mismatches do not depend on the thread count.
+
+enum Fp16ResFormat { FP16_RES_GOLDEN, FP16_RES_U16 };
+
+static const size_t FP16_RESDIFF_BLOCK = 64;
+static const size_t FP16_RESDIFF_CHUNK = 1 << 20;
+static const size_t FP16_RESDIFF_BUCKETS = 7;
+
+// Labels of the ULP histogram buckets (the last is open).
+inline const char* fp16_resdiff_bucket_name(size_t b) {
+    static const char* names[FP16_RESDIFF_BUCKETS] = {"1", "2", "3-4", "5-16", "17-256", "257-4096", ">4096"};
+    return names[b];
+}
+
+struct Fp16ResMismatch {
+    uint64_t index;
+    uint32_t a, b;   // records (golden) or bit patterns (u16)
+    uint32_t ulp;    // 0 when one side is NaN or for +0 vs -0
+};
+
+struct Fp16ResDiffStats {
+    uint64_t compared = 0, mismatches = 0;
+    uint64_t nan_equal = 0;   // NaN pairs with different bits, counted equal
+    uint64_t nan_vs_num = 0;  // NaN on one side only
+    uint64_t flags_only = 0;  // results equal, flags differ (golden with flags)
+    uint64_t zero_sign = 0;   // +0 vs -0 (mismatches unless zero_sign_equal)
+    uint64_t max_ulp = 0;
+    uint64_t ulp_hist[FP16_RESDIFF_BUCKETS] = {};
+    std::vector<Fp16ResMismatch> first;
+
+    // Appends o, which covers the elements after this one's.
+    void merge(const Fp16ResDiffStats& o, size_t keep) {
+        compared += o.compared; mismatches += o.mismatches; nan_equal += o.nan_equal;
+        nan_vs_num += o.nan_vs_num; flags_only += o.flags_only; zero_sign += o.zero_sign;
+        if (o.max_ulp > max_ulp) max_ulp = o.max_ulp;
+        for (size_t b = 0; b < FP16_RESDIFF_BUCKETS; ++b) ulp_hist[b] += o.ulp_hist[b];
+        for (size_t i = 0; i < o.first.size() && first.size() < keep; ++i) first.push_back(o.first[i]);
+    }
+};
+
+// Distance of two non-NaN FP16 values in ULPs.
+inline uint32_t fp16_ulp_distance(fp16_t a, fp16_t b) {
+    int32_t x = (a & 0x8000) ? -(int32_t)(a & 0x7FFF) : (int32_t)a;
+    int32_t y = (b & 0x8000) ? -(int32_t)(b & 0x7FFF) : (int32_t)b;
+    return (uint32_t)(x > y ? x - y : y - x);
+}
+
+inline bool fp16_bits_nan(uint32_t h) { return (h & 0x7C00) == 0x7C00 && (h & 0x3FF) != 0; }
+
+// Classifies one differing element pair.
+inline void fp16_resdiff_element(Fp16ResFormat fmt, bool flags, bool zero_sign_equal, uint64_t index, uint32_t a,
+                                 uint32_t b, size_t keep, Fp16ResDiffStats& st) {
+    bool na = fmt == FP16_RES_GOLDEN ? ((a >> 16) & FP16_FLAG_NAN) != 0 : fp16_bits_nan(a);
+    bool nb = fmt == FP16_RES_GOLDEN ? ((b >> 16) & FP16_FLAG_NAN) != 0 : fp16_bits_nan(b);
+    uint32_t ulp = 0;
+    if (na && nb) {
+        st.nan_equal++;
+        return;
+    } else if (na || nb) {
+        st.nan_vs_num++;
+    } else if ((a & 0xFFFF) != (b & 0xFFFF)) {
+        ulp = fp16_ulp_distance((fp16_t)a, (fp16_t)b);
+        if (ulp == 0) {
+            st.zero_sign++;
+            if (zero_sign_equal) {
+                if (!flags || ((a ^ b) >> 16) == 0) return;
+                st.flags_only++;
+            }
+        } else {
+            size_t bucket = ulp <= 1 ? 0 : ulp <= 2 ? 1 : ulp <= 4 ? 2 : ulp <= 16 ? 3 : ulp <= 256 ? 4
+                          : ulp <= 4096 ? 5 : 6;
+            st.ulp_hist[bucket]++;
+            if (ulp > st.max_ulp) st.max_ulp = ulp;
+        }
+    } else if (flags && ((a ^ b) >> 16) != 0) {
+        st.flags_only++;
+    } else {
+        return; // only bytes outside the compared fields differ
+    }
+    st.mismatches++;
+    if (st.first.size() < keep) st.first.push_back({index, a, b, ulp});
+}
+
+// Golden records [0, n), element indices starting at base.
+inline void fp16_resdiff_golden(const uint32_t* a, const uint32_t* b, uint64_t base, size_t n, bool flags,
+                                bool zero_sign_equal, size_t keep, Fp16ResDiffStats& st) {
+    const uint32_t mask = flags ? 0x00FFFFFFu : 0x0000FFFFu;
+    for (size_t i0 = 0; i0 < n; i0 += FP16_RESDIFF_BLOCK) {
+        size_t m = n - i0 < FP16_RESDIFF_BLOCK ? n - i0 : FP16_RESDIFF_BLOCK;
+        uint32_t diff = 0;
+        for (size_t i = 0; i < m; ++i) diff |= a[i0 + i] ^ b[i0 + i];
+        if ((diff & mask) == 0) continue;
+        for (size_t i = 0; i < m; ++i) {
+            if ((a[i0 + i] ^ b[i0 + i]) & mask) {
+                fp16_resdiff_element(FP16_RES_GOLDEN, flags, zero_sign_equal, base + i0 + i, a[i0 + i], b[i0 + i],
+                                     keep, st);
+            }
+        }
+    }
+    st.compared += n;
+}
+
+inline void fp16_resdiff_u16(const fp16_t* a, const fp16_t* b, uint64_t base, size_t n, bool zero_sign_equal,
+                             size_t keep, Fp16ResDiffStats& st) {
+    for (size_t i0 = 0; i0 < n; i0 += FP16_RESDIFF_BLOCK) {
+        size_t m = n - i0 < FP16_RESDIFF_BLOCK ? n - i0 : FP16_RESDIFF_BLOCK;
+        uint16_t diff = 0;
+        for (size_t i = 0; i < m; ++i) diff |= a[i0 + i] ^ b[i0 + i];
+        if (diff == 0) continue;
+        for (size_t i = 0; i < m; ++i) {
+            if (a[i0 + i] != b[i0 + i]) {
+                fp16_resdiff_element(FP16_RES_U16, false, zero_sign_equal, base + i0 + i, a[i0 + i], b[i0 + i], keep,
+                                     st);
+            }
+        }
+    }
+    st.compared += n;
+}
+
+// Compares n elements of a and b (uint32_t records for golden, fp16_t for
+// u16) on the pool.
+inline Fp16ResDiffStats fp16_resdiff_parallel(Fp16Pool& pool, Fp16ResFormat fmt, const void* a, const void* b,
+                                              size_t n, bool flags, bool zero_sign_equal, size_t keep) {
+    size_t chunks = (n + FP16_RESDIFF_CHUNK - 1) / FP16_RESDIFF_CHUNK;
+    std::vector<Fp16ResDiffStats> part(chunks);
+    pool.parallel_for(0, chunks, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        for (uint64_t c = lo; c < hi; ++c) {
+            size_t first = (size_t)c * FP16_RESDIFF_CHUNK;
+            size_t m = n - first < FP16_RESDIFF_CHUNK ? n - first : FP16_RESDIFF_CHUNK;
+            if (fmt == FP16_RES_GOLDEN) {
+                fp16_resdiff_golden((const uint32_t*)a + first, (const uint32_t*)b + first, first, m, flags,
+                                    zero_sign_equal, keep, part[c]);
+            } else {
+                fp16_resdiff_u16((const fp16_t*)a + first, (const fp16_t*)b + first, first, m, zero_sign_equal, keep,
+                                 part[c]);
+            }
+        }
+    });
+    Fp16ResDiffStats st;
+    for (const Fp16ResDiffStats& p : part) st.merge(p, keep);
+    return st;
+}
+
+#endif // FP16_RESDIFF_H
@@ -0,0 +1,168 @@
+#ifndef FP16_RNG_H
+#define FP16_RNG_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include "fp16_common.h"
+
+// ----------------------------------------------------------------------------
+// Seedable Random Streams
+// ----------------------------------------------------------------------------
+// xoshiro256++ (Blackman & Vigna) with the reference jump polynomials:
+//   jump()      : advance 2^128 steps (independent per-thread streams)
+//   long_jump() : advance 2^192 steps (independent groups of streams)
+// Every random run is reproducible from one 64-bit seed:
+//   fp16_rng_stream(seed, k)     : k-th jump stream of seed
+//   fp16_rng_chunk_seed(seed, c) : seed of work chunk c, so the vectors of a
+//                                  chunk do not depend on which thread or in
+//                                  which order it runs
+// Fp16RngLanes steps FP16_RNG_LANES generators side by side for SIMD bulk
+// fills of operand pairs and rounding words (build with -O3 -march=native).
+
+// splitmix64: seeding and hashing.
+inline uint64_t fp16_mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t fp16_rotl64(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+struct Xoshiro256 {
+    using result_type = uint64_t;
+    uint64_t s[4];
+
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        for (int i = 0; i < 4; ++i) s[i] = fp16_mix64(seed + 0x9E3779B97F4A7C15ull * i);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+    uint64_t next() {
+        uint64_t r = fp16_rotl64(s[0] + s[3], 23) + s[0];
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1];
+        s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = fp16_rotl64(s[3], 45);
+        return r;
+    }
+    uint64_t operator()() { return next(); }
+
+    void jump() {
+        static const uint64_t poly[4] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+        };
+        apply(poly);
+    }
+    void long_jump() {
+        static const uint64_t poly[4] = {
+            0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull
+        };
+        apply(poly);
+    }
+
+private:
+    void apply(const uint64_t poly[4]) {
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; ++i)
+            for (int b = 0; b < 64; ++b) {
+                if (poly[i] & (1ull << b))
+                    for (int k = 0; k < 4; ++k) t[k] ^= s[k];
+                next();
+            }
+        for (int k = 0; k < 4; ++k) s[k] = t[k];
+    }
+};
+
+inline Xoshiro256 fp16_rng_stream(uint64_t seed, uint64_t k) {
+    Xoshiro256 g(seed);
+    for (uint64_t i = 0; i < k; ++i) g.jump();
+    return g;
+}
+
+inline uint64_t fp16_rng_chunk_seed(uint64_t seed, uint64_t chunk) {
+    return fp16_mix64(fp16_mix64(seed) + chunk);
+}
+
+// ----------------------------------------------------------------------------
+// SIMD Bulk Fill
+// ----------------------------------------------------------------------------
+// Lane l is jump stream l of the seed, so lanes never overlap. The state is
+// held in structure-of-arrays form so one vector op steps several lanes.
+enum { FP16_RNG_LANES = 8 };
+
+struct Fp16RngLanes {
+    alignas(64) uint64_t s0[FP16_RNG_LANES], s1[FP16_RNG_LANES];
+    alignas(64) uint64_t s2[FP16_RNG_LANES], s3[FP16_RNG_LANES];
+
+    explicit Fp16RngLanes(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        Xoshiro256 g(seed);
+        for (int l = 0; l < FP16_RNG_LANES; ++l) {
+            s0[l] = g.s[0]; s1[l] = g.s[1]; s2[l] = g.s[2]; s3[l] = g.s[3];
+            g.jump();
+        }
+    }
+
+    // n must be a multiple of FP16_RNG_LANES. The lane loop must stay a
+    // loop: fully unrolled, GCC's SLP cost model rejects it as scalar code.
+    void fill_u64(uint64_t* __restrict out, size_t n) {
+        for (size_t i = 0; i < n; i += FP16_RNG_LANES) {
+#pragma GCC unroll 1
+            for (int l = 0; l < FP16_RNG_LANES; ++l) {
+                out[i + l] = fp16_rotl64(s0[l] + s3[l], 23) + s0[l];
+                uint64_t t = s1[l] << 17;
+                s2[l] ^= s0[l]; s3[l] ^= s1[l];
+                s1[l] ^= s2[l]; s0[l] ^= s3[l];
+                s2[l] ^= t;
+                s3[l] = fp16_rotl64(s3[l], 45);
+            }
+        }
+    }
+
+    // Uniform 16-bit words (stochastic rounding): four per 64-bit word.
+    void fill_u16(uint16_t* __restrict out, size_t n) {
+        const size_t BLK = 512;
+        alignas(64) uint64_t w[BLK];
+        for (size_t off = 0; off < n; off += 4 * BLK) {
+            size_t m = (n - off < 4 * BLK) ? n - off : 4 * BLK;
+            size_t words = ((m + 3) / 4 + FP16_RNG_LANES - 1) & ~(size_t)(FP16_RNG_LANES - 1);
+            fill_u64(w, words);
+            std::memcpy(out + off, w, m * sizeof(uint16_t));
+        }
+    }
+
+    // Uniform operand pairs: every 64-bit word yields two (a, b) pairs.
+    void fill_pairs(fp16_t* __restrict a, fp16_t* __restrict b, size_t n) {
+        const size_t BLK = 512;
+        alignas(64) uint64_t w[BLK];
+        for (size_t off = 0; off < n; off += 2 * BLK) {
+            size_t m = (n - off < 2 * BLK) ? n - off : 2 * BLK;
+            size_t words = ((m + 1) / 2 + FP16_RNG_LANES - 1) & ~(size_t)(FP16_RNG_LANES - 1);
+            fill_u64(w, words);
+            size_t pairs = m / 2;
+            for (size_t i = 0; i < pairs; ++i) {
+                uint64_t r = w[i];
+                a[off + 2 * i]     = (fp16_t)r;
+                b[off + 2 * i]     = (fp16_t)(r >> 16);
+                a[off + 2 * i + 1] = (fp16_t)(r >> 32);
+                b[off + 2 * i + 1] = (fp16_t)(r >> 48);
+            }
+            if (m & 1) {
+                a[off + m - 1] = (fp16_t)w[pairs];
+                b[off + m - 1] = (fp16_t)(w[pairs] >> 16);
+            }
+        }
+    }
+};
+
+#endif // FP16_RNG_H
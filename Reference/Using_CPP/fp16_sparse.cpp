@@ -0,0 +1,155 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_pool.h"
+#include "fp16_sparse.h"
+#include "fp16_workload.h"
+
+// ----------------------------------------------------------------------------
+// Sparse GEMM Benchmark
+// ----------------------------------------------------------------------------
+// Usage: fp16_sparse [--m M] [--k K] [--n N] [--sparsity S1,S2,...] [--workload NAME]
+//                    [--seed S] [--threads T]
+//
+// Prunes the weights of one layer C[M x N] = A[M x K] * W[K x N] (a
+// fp16_workload.h workload, default fc) by magnitude to each sparsity
+// (fraction of zeros per column, default 0.5,0.75,0.9) and to 2:4, and
+// runs the zero-skipping kernels of fp16_sparse.h against the dense chain
+// on the same pruned W. Every result is checked bit for bit against the
+// dense one. "+act" also skips zero activations (ReLU workloads).
+// "issued" is the number of products computed, i.e. the cycles of a
+// one-MAC-per-cycle zero-skipping unit, "saved" its share of the dense
+// M * K * N cycles; "eff GMAC/s" counts the dense MACs per second, so it
+// is the throughput the sparse kernel delivers for the layer.
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    size_t M = 64, K = 1024, N = 256;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string name = "fc";
+    std::vector<double> levels = {0.5, 0.75, 0.9};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--m" && i + 1 < argc) M = std::stoull(argv[++i]);
+        else if (arg == "--k" && i + 1 < argc) K = std::stoull(argv[++i]);
+        else if (arg == "--n" && i + 1 < argc) N = std::stoull(argv[++i]);
+        else if (arg == "--sparsity" && i + 1 < argc) {
+            levels.clear();
+            std::stringstream ss(argv[++i]);
+            for (std::string tok; std::getline(ss, tok, ',');) levels.push_back(std::stod(tok));
+        }
+        else if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--m M] [--k K] [--n N] [--sparsity S1,S2,...]"
+                      << " [--workload NAME] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+    if (M == 0 || K == 0 || N == 0) {
+        std::cerr << "Layer dimensions must be positive\n";
+        return 1;
+    }
+    for (double s : levels) {
+        if (!(s >= 0 && s < 1)) {
+            std::cerr << "Sparsity must be in [0, 1)\n";
+            return 1;
+        }
+    }
+    Fp16Workload wl;
+    if (!fp16_workload(name, wl)) {
+        fp16_workload_unknown(name);
+        return 1;
+    }
+
+    Fp16Pool pool(threads ? threads : 1);
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << ", layer " << M << " x " << K
+              << " x " << N << " (" << wl.name << "), " << pool.size() << " thread(s)\n";
+
+    std::vector<fp16_t> A, W;
+    fp16_workload_gemm_operands(pool, wl, seed, M, K, N, A, W);
+    size_t act_zero = 0;
+    for (fp16_t a : A) act_zero += fp16_is_zero(a);
+
+    const uint64_t dense_macs = (uint64_t)M * K * N;
+    std::vector<fp16_t> ref(M * N), C(M * N);
+    auto timed = [&](auto&& run, uint64_t& issued) {
+        auto t0 = std::chrono::steady_clock::now();
+        issued = run();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    double dense_sec = 0;
+    bool all_exact = true;
+    auto row = [&](const char* fmt, uint64_t issued, double sec, bool exact) {
+        all_exact &= exact;
+        std::cout << "  " << std::left << std::setw(10) << fmt << std::right << std::setw(14) << issued
+                  << std::setprecision(2) << std::setw(10) << 100.0 * (1.0 - (double)issued / dense_macs)
+                  << std::setprecision(4) << std::setw(10) << sec << std::setw(12) << dense_macs / sec / 1e9
+                  << std::setprecision(2) << std::setw(10) << dense_sec / sec << std::setw(8)
+                  << (exact ? "yes" : "NO") << "\n";
+    };
+    auto run_level = [&](const std::string& title, const std::vector<fp16_t>& Wp, bool structured) {
+        size_t nnz = 0;
+        for (fp16_t w : Wp) nnz += !fp16_is_zero(w);
+        std::cout << "--------------------------------------------------------------------------------------------------\n"
+                  << " " << title << ": " << std::fixed << std::setprecision(2) << 100.0 * nnz / (K * N)
+                  << " % of W non-zero, " << 100.0 * act_zero / (M * K) << " % of A zero\n"
+                  << "--------------------------------------------------------------------------------------------------\n"
+                  << "  " << std::left << std::setw(10) << "Format" << std::right << std::setw(14) << "issued"
+                  << std::setw(10) << "saved %" << std::setw(10) << "time s" << std::setw(12) << "eff GMAC/s"
+                  << std::setw(10) << "speedup" << std::setw(8) << "exact" << "\n";
+        uint64_t issued;
+        dense_sec = timed([&] { return fp16_gemm_dense(pool, A.data(), Wp.data(), ref.data(), M, K, N); }, issued);
+        row("dense", issued, dense_sec, true);
+        if (structured) {
+            Fp16Sparse24 s24;
+            if (!fp16_sparse24_from_dense(Wp.data(), K, N, s24)) {
+                std::cerr << "W is not 2:4 sparse\n";
+                return;
+            }
+            double sec = timed([&] { return fp16_gemm_24(pool, A.data(), s24, C.data(), M); }, issued);
+            row("2:4", issued, sec, C == ref);
+        }
+        Fp16Csr csr = fp16_csr_from_dense(Wp.data(), K, N);
+        Fp16Csc csc = fp16_csc_from_dense(Wp.data(), K, N);
+        for (int act = 0; act < 2; ++act) {
+            double sec = timed([&] { return fp16_gemm_csr(pool, A.data(), csr, C.data(), M, act); }, issued);
+            row(act ? "csr+act" : "csr", issued, sec, C == ref);
+            sec = timed([&] { return fp16_gemm_csc(pool, A.data(), csc, C.data(), M, act); }, issued);
+            row(act ? "csc+act" : "csc", issued, sec, C == ref);
+        }
+    };
+
+    // Magnitude pruning: zero the smallest |w| of every column
+    std::vector<fp16_t> Wp(K * N);
+    std::vector<std::pair<uint16_t, uint32_t>> mag(K);
+    for (double s : levels) {
+        Wp = W;
+        size_t cut = (size_t)(s * K + 0.5);
+        for (size_t n = 0; n < N; ++n) {
+            for (size_t k = 0; k < K; ++k) mag[k] = {(uint16_t)(W[k * N + n] & 0x7FFF), (uint32_t)k};
+            std::nth_element(mag.begin(), mag.begin() + cut, mag.end());
+            for (size_t i = 0; i < cut; ++i) Wp[mag[i].second * N + n] = 0;
+        }
+        std::ostringstream title;
+        title << "Unstructured, " << 100.0 * s << " % pruned";
+        run_level(title.str(), Wp, false);
+    }
+    Wp = W;
+    fp16_prune_24(Wp.data(), K, N);
+    run_level("2:4 structured", Wp, true);
+    std::cout << "--------------------------------------------------------------------------------------------------\n"
+              << (all_exact ? "All sparse results bit-identical to the dense chain\n"
+                            : "MISMATCH between sparse and dense results\n");
+    return all_exact ? 0 : 1;
+}
@@ -0,0 +1,287 @@
+#ifndef FP16_SPARSE_H
+#define FP16_SPARSE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Zero-Skipping Sparse GEMM
+// ----------------------------------------------------------------------------
+// C[M x N] = A[M x K] * W[K x N] on the bit-true MAC chain
+// acc = fp16_add_bittrue(acc, fp16_mul_bittrue(a, w)), acc from +0, k in
+// ascending order (fp16_gemm_dense). The sparse kernels issue only the
+// products whose operands are stored (W in CSR, CSC or 2:4 form) and,
+// optionally, whose activation is non-zero, and visit them in the same k
+// order. They are bit-identical to the dense chain because
+//   - a zero operand times a finite one gives +-0 (fp16_mul_bittrue's zero
+//     short-circuit), and acc + +-0 = acc for every acc the chain can hold
+//     (it never holds -0, since it starts at +0), and
+//   - 0 * Inf = NaN is the only skipped product that is not a zero: a row
+//     of A with an Inf or NaN is computed densely, and activation skipping
+//     is disabled if W stores an Inf or NaN.
+// Only the result is modeled; the Z flags of the skipped products are not.
+//
+// Every kernel returns the number of products it issued, i.e. the cycles
+// of a one-MAC-per-cycle unit that skips zero products (dense: M * K * N).
+// Rows of C run in parallel on the pool, so results are the same for any
+// thread count.
+
+inline bool fp16_is_zero(fp16_t h) { return (h & 0x7FFF) == 0; }
+inline bool fp16_is_nonfinite(fp16_t h) { return (h & 0x7C00) == 0x7C00; }
+
+// Row-major compressed rows: row r holds (idx[p], val[p]) for p in
+// [ptr[r], ptr[r + 1]), idx ascending.
+struct Fp16Csr {
+    size_t rows = 0, cols = 0;
+    std::vector<uint32_t> ptr, idx;
+    std::vector<fp16_t> val;
+    bool nonfinite = false; // some stored value is Inf or NaN
+
+    size_t nnz() const { return val.size(); }
+};
+
+// Compressed columns: column c holds (row idx[p], val[p]) for p in
+// [ptr[c], ptr[c + 1]), idx ascending.
+struct Fp16Csc {
+    size_t rows = 0, cols = 0;
+    std::vector<uint32_t> ptr, idx;
+    std::vector<fp16_t> val;
+    bool nonfinite = false;
+
+    size_t nnz() const { return val.size(); }
+};
+
+// 2:4 structured sparsity along k: every group of 4 consecutive k of a
+// column has at most 2 non-zeros. Column n, group g keeps 2 slots
+// (val, pos) at [(n * groups + g) * 2 + s], pos ascending in the group;
+// unused slots hold +0. The hardware issues both slots of every group.
+struct Fp16Sparse24 {
+    size_t rows = 0, cols = 0, groups = 0;
+    std::vector<fp16_t> val;
+    std::vector<uint8_t> pos;
+    bool nonfinite = false;
+};
+
+inline Fp16Csr fp16_csr_from_dense(const fp16_t* d, size_t rows, size_t cols) {
+    Fp16Csr s;
+    s.rows = rows; s.cols = cols;
+    s.ptr.push_back(0);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            fp16_t v = d[r * cols + c];
+            if (fp16_is_zero(v)) continue;
+            s.idx.push_back((uint32_t)c);
+            s.val.push_back(v);
+            s.nonfinite |= fp16_is_nonfinite(v);
+        }
+        s.ptr.push_back((uint32_t)s.val.size());
+    }
+    return s;
+}
+
+inline Fp16Csc fp16_csc_from_dense(const fp16_t* d, size_t rows, size_t cols) {
+    Fp16Csc s;
+    s.rows = rows; s.cols = cols;
+    s.ptr.push_back(0);
+    for (size_t c = 0; c < cols; ++c) {
+        for (size_t r = 0; r < rows; ++r) {
+            fp16_t v = d[r * cols + c];
+            if (fp16_is_zero(v)) continue;
+            s.idx.push_back((uint32_t)r);
+            s.val.push_back(v);
+            s.nonfinite |= fp16_is_nonfinite(v);
+        }
+        s.ptr.push_back((uint32_t)s.val.size());
+    }
+    return s;
+}
+
+// Fails if a group of 4 has more than 2 non-zeros (see fp16_prune_24).
+inline bool fp16_sparse24_from_dense(const fp16_t* d, size_t rows, size_t cols, Fp16Sparse24& s) {
+    s.rows = rows; s.cols = cols; s.groups = (rows + 3) / 4;
+    s.val.assign(cols * s.groups * 2, 0);
+    s.pos.assign(cols * s.groups * 2, 0);
+    s.nonfinite = false;
+    for (size_t c = 0; c < cols; ++c) {
+        for (size_t g = 0; g < s.groups; ++g) {
+            size_t base = (c * s.groups + g) * 2, used = 0;
+            uint8_t nz[2];
+            for (uint8_t p = 0; p < 4 && g * 4 + p < rows; ++p) {
+                if (!fp16_is_zero(d[(g * 4 + p) * cols + c])) {
+                    if (used == 2) return false;
+                    nz[used++] = p;
+                }
+            }
+            // Unused slots take the lowest free positions; pos stays ascending.
+            for (uint8_t p = 0; used < 2; ++p) {
+                if (used == 1 && nz[0] == p) continue;
+                nz[used++] = p;
+            }
+            if (nz[0] > nz[1]) { uint8_t t = nz[0]; nz[0] = nz[1]; nz[1] = t; }
+            for (size_t k = 0; k < 2; ++k) {
+                size_t r = g * 4 + nz[k];
+                fp16_t v = r < rows ? d[r * cols + c] : (fp16_t)0;
+                s.val[base + k] = fp16_is_zero(v) ? (fp16_t)0 : v;
+                s.pos[base + k] = nz[k];
+                s.nonfinite |= fp16_is_nonfinite(v);
+            }
+        }
+    }
+    return true;
+}
+
+// Keeps the 2 largest magnitudes of every group of 4 along k (ties: lower
+// k) and zeroes the rest, in place.
+inline void fp16_prune_24(fp16_t* d, size_t rows, size_t cols) {
+    for (size_t c = 0; c < cols; ++c) {
+        for (size_t g = 0; g * 4 < rows; ++g) {
+            size_t n = rows - g * 4 < 4 ? rows - g * 4 : 4;
+            size_t keep[2] = {4, 4};
+            for (size_t p = 0; p < n; ++p) {
+                uint16_t m = d[(g * 4 + p) * cols + c] & 0x7FFF;
+                for (size_t s = 0; s < 2; ++s) {
+                    if (keep[s] == 4 || m > (d[(g * 4 + keep[s]) * cols + c] & 0x7FFF)) {
+                        if (s == 0) keep[1] = keep[0];
+                        keep[s] = p;
+                        break;
+                    }
+                }
+            }
+            for (size_t p = 0; p < n; ++p) {
+                if (p != keep[0] && p != keep[1]) d[(g * 4 + p) * cols + c] = 0;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Kernels
+// ----------------------------------------------------------------------------
+inline fp16_t fp16_sparse_mac(fp16_t acc, fp16_t a, fp16_t w) {
+    return fp16_add_bittrue(acc, fp16_mul_bittrue(a, w).res).res;
+}
+
+inline bool fp16_row_nonfinite(const fp16_t* a, size_t k) {
+    for (size_t i = 0; i < k; ++i) {
+        if (fp16_is_nonfinite(a[i])) return true;
+    }
+    return false;
+}
+
+// Dense reference chain.
+inline uint64_t fp16_gemm_dense(Fp16Pool& pool, const fp16_t* A, const fp16_t* W, fp16_t* C, size_t M, size_t K,
+                                size_t N) {
+    pool.parallel_for(0, M, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        std::vector<fp16_t> acc(N);
+        for (uint64_t m = lo; m < hi; ++m) {
+            for (size_t n = 0; n < N; ++n) acc[n] = 0;
+            for (size_t k = 0; k < K; ++k) {
+                fp16_t a = A[m * K + k];
+                for (size_t n = 0; n < N; ++n) acc[n] = fp16_sparse_mac(acc[n], a, W[k * N + n]);
+            }
+            for (size_t n = 0; n < N; ++n) C[m * N + n] = acc[n];
+        }
+    });
+    return (uint64_t)M * K * N;
+}
+
+// W in CSR (rows = k): row by row of A, scattering into N accumulators.
+// skip_act also skips zero activations (dynamic zero skipping).
+inline uint64_t fp16_gemm_csr(Fp16Pool& pool, const fp16_t* A, const Fp16Csr& W, fp16_t* C, size_t M,
+                              bool skip_act = false) {
+    const size_t K = W.rows, N = W.cols;
+    skip_act = skip_act && !W.nonfinite;
+    return pool.parallel_reduce<uint64_t>(0, M, 1, 0, [&](uint64_t lo, uint64_t hi, uint64_t& issued) {
+        std::vector<fp16_t> acc(N), wrow(N);
+        for (uint64_t m = lo; m < hi; ++m) {
+            const fp16_t* a = A + m * K;
+            bool dense = fp16_row_nonfinite(a, K);
+            for (size_t n = 0; n < N; ++n) acc[n] = 0;
+            for (size_t k = 0; k < K; ++k) {
+                if (dense) {
+                    for (size_t n = 0; n < N; ++n) wrow[n] = 0;
+                    for (uint32_t p = W.ptr[k]; p < W.ptr[k + 1]; ++p) wrow[W.idx[p]] = W.val[p];
+                    for (size_t n = 0; n < N; ++n) acc[n] = fp16_sparse_mac(acc[n], a[k], wrow[n]);
+                    issued += N;
+                    continue;
+                }
+                if (skip_act && fp16_is_zero(a[k])) continue;
+                for (uint32_t p = W.ptr[k]; p < W.ptr[k + 1]; ++p) {
+                    acc[W.idx[p]] = fp16_sparse_mac(acc[W.idx[p]], a[k], W.val[p]);
+                }
+                issued += W.ptr[k + 1] - W.ptr[k];
+            }
+            for (size_t n = 0; n < N; ++n) C[m * N + n] = acc[n];
+        }
+    }, [](uint64_t& x, const uint64_t& y) { x += y; });
+}
+
+// W in CSC: one output at a time over the stored k of its column.
+inline uint64_t fp16_gemm_csc(Fp16Pool& pool, const fp16_t* A, const Fp16Csc& W, fp16_t* C, size_t M,
+                              bool skip_act = false) {
+    const size_t K = W.rows, N = W.cols;
+    skip_act = skip_act && !W.nonfinite;
+    return pool.parallel_reduce<uint64_t>(0, M, 1, 0, [&](uint64_t lo, uint64_t hi, uint64_t& issued) {
+        std::vector<fp16_t> wcol(K);
+        for (uint64_t m = lo; m < hi; ++m) {
+            const fp16_t* a = A + m * K;
+            bool dense = fp16_row_nonfinite(a, K);
+            for (size_t n = 0; n < N; ++n) {
+                fp16_t acc = 0;
+                if (dense) {
+                    for (size_t k = 0; k < K; ++k) wcol[k] = 0;
+                    for (uint32_t p = W.ptr[n]; p < W.ptr[n + 1]; ++p) wcol[W.idx[p]] = W.val[p];
+                    for (size_t k = 0; k < K; ++k) acc = fp16_sparse_mac(acc, a[k], wcol[k]);
+                    issued += K;
+                } else {
+                    for (uint32_t p = W.ptr[n]; p < W.ptr[n + 1]; ++p) {
+                        fp16_t x = a[W.idx[p]];
+                        if (skip_act && fp16_is_zero(x)) continue;
+                        acc = fp16_sparse_mac(acc, x, W.val[p]);
+                        ++issued;
+                    }
+                }
+                C[m * N + n] = acc;
+            }
+        }
+    }, [](uint64_t& x, const uint64_t& y) { x += y; });
+}
+
+// W in 2:4 form: both slots of every group are issued, as a 2:4 MAC array
+// does (K / 2 products per output, rounded up per group).
+inline uint64_t fp16_gemm_24(Fp16Pool& pool, const fp16_t* A, const Fp16Sparse24& W, fp16_t* C, size_t M) {
+    const size_t K = W.rows, N = W.cols, G = W.groups;
+    return pool.parallel_reduce<uint64_t>(0, M, 1, 0, [&](uint64_t lo, uint64_t hi, uint64_t& issued) {
+        std::vector<fp16_t> wcol(G * 4);
+        for (uint64_t m = lo; m < hi; ++m) {
+            const fp16_t* a = A + m * K;
+            bool dense = fp16_row_nonfinite(a, K);
+            for (size_t n = 0; n < N; ++n) {
+                const fp16_t* v = &W.val[n * G * 2];
+                const uint8_t* p = &W.pos[n * G * 2];
+                fp16_t acc = 0;
+                if (dense) {
+                    for (size_t k = 0; k < G * 4; ++k) wcol[k] = 0;
+                    for (size_t s = 0; s < G * 2; ++s) wcol[(s / 2) * 4 + p[s]] = v[s];
+                    for (size_t k = 0; k < K; ++k) acc = fp16_sparse_mac(acc, a[k], wcol[k]);
+                    issued += K;
+                } else {
+                    for (size_t s = 0; s < G * 2; ++s) {
+                        size_t k = (s / 2) * 4 + p[s];
+                        if (k < K) acc = fp16_sparse_mac(acc, a[k], v[s]);
+                    }
+                    issued += G * 2;
+                }
+                C[m * N + n] = acc;
+            }
+        }
+    }, [](uint64_t& x, const uint64_t& y) { x += y; });
+}
+
+#endif // FP16_SPARSE_H
@@ -0,0 +1,399 @@
+#ifndef FP16_SR_H
+#define FP16_SR_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "fp16_common.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+
+// ----------------------------------------------------------------------------
+// Stochastic Rounding Variants of the Bit-True Models
+// ----------------------------------------------------------------------------
+// Same datapaths as fp16_add_bittrue / fp16_mul_bittrue, but the bits that
+// the truncating models drop are kept as a 16-bit fraction of the result
+// LSB (frac, with a sticky bit in its LSB for anything shifted out further)
+// and the result is rounded up in magnitude when rnd < frac, i.e. with
+// probability frac / 2^16, for a uniform 16-bit random word rnd per lane:
+//   adder      : the alignment shift-out (bits_lost), also across the carry
+//                and cancellation shifts; effective subtraction borrows from
+//                the kept bits so the rounding is relative to the exact value
+//   multiplier : the low bits of mant_mult below the packed 10 fraction bits
+// rnd = 0xFFFF never rounds up (RZ of the exact value), rnd = 0 always
+// rounds an inexact result away from zero. Special values, the multiplier's
+// denormal handling and the flags follow the bit-true models; the adder's
+// PL flag is set when the fraction is non-zero.
+//
+// The batch kernels draw rnd from an Fp16RngLanes stream; the parallel
+// ones seed it per FP16_SR_CHUNK elements from one seed, so results do not
+// depend on the thread count.
+
+// ----------------------------------------------------------------------------
+// Scalar Models
+// ----------------------------------------------------------------------------
+inline BitTrueResult fp16_add_bittrue_sr(fp16_t n1, fp16_t n2, uint16_t rnd) {
+    BitTrueResult ret = {0, false, false, false, false, false};
+
+    // 1. Decode inputs
+    uint16_t s1 = (n1 >> 15) & 1;
+    uint16_t e1 = (n1 >> 10) & 0x1F;
+    uint16_t f1 = n1 & 0x3FF;
+
+    uint16_t s2 = (n2 >> 15) & 1;
+    uint16_t e2 = (n2 >> 10) & 0x1F;
+    uint16_t f2 = n2 & 0x3FF;
+
+    // 2. Check Special Values
+    bool n1_is_inf = (e1 == 31) && (f1 == 0);
+    bool n2_is_inf = (e2 == 31) && (f2 == 0);
+    bool n1_is_nan = (e1 == 31) && (f1 != 0);
+    bool n2_is_nan = (e2 == 31) && (f2 != 0);
+
+    if (n1_is_nan || n2_is_nan || (n1_is_inf && n2_is_inf && (s1 != s2))) {
+        ret.res = 0x7FFF; ret.nan = true; return ret;
+    }
+    if (n1_is_inf || n2_is_inf) {
+        ret.overflow = true;
+        ret.res = n1_is_inf ? n1 : n2;
+        return ret;
+    }
+
+    // 3. Align (Big/Small)
+    int32_t  exp1 = (e1 == 0) ? 1 : e1;
+    int32_t  exp2 = (e2 == 0) ? 1 : e2;
+    uint32_t mant1 = (e1 == 0) ? f1 : (f1 | 1024);
+    uint32_t mant2 = (e2 == 0) ? f2 : (f2 | 1024);
+
+    bool swap = (exp1 < exp2) || (exp1 == exp2 && mant1 < mant2);
+    uint16_t sign_big = swap ? s2 : s1;
+    int32_t  exp_big  = swap ? exp2 : exp1;
+    uint32_t mant_big = swap ? mant2 : mant1;
+    uint16_t sign_sml = swap ? s1 : s2;
+    int32_t  exp_sml  = swap ? exp1 : exp2;
+    uint32_t mant_sml = swap ? mant1 : mant2;
+    int32_t  exp_diff = exp_big - exp_sml; // <= 29
+
+    // 4. Shift Small Mantissa, keeping the lost bits as a 16-bit fraction
+    uint32_t mant_sml_shifted = mant_sml >> exp_diff;
+    uint32_t ext  = mant_sml << 16;
+    uint32_t frac = (ext >> exp_diff) & 0xFFFF;
+    if (ext & ((1u << exp_diff) - 1)) frac |= 1; // sticky
+
+    // 5. Add/Sub (subtraction borrows one LSB to make the fraction positive)
+    uint32_t mant;
+    if (sign_big == sign_sml) {
+        mant = mant_big + mant_sml_shifted;
+    } else {
+        mant = mant_big - mant_sml_shifted;
+        if (frac) { mant--; frac = 0x10000 - frac; }
+    }
+
+    if (mant == 0 && frac == 0) {
+        ret.res = (sign_big == sign_sml && sign_big == 1) ? 0x8000 : 0;
+        ret.zero = true;
+        return ret;
+    }
+
+    // 6. Normalize, moving bits between mantissa and fraction
+    int32_t final_exp = exp_big;
+    if (mant >= 2048) {
+        frac = ((mant & 1) << 15) | (frac >> 1) | (frac & 1);
+        mant >>= 1;
+        final_exp++;
+    } else {
+        while (mant < 1024 && final_exp > 1) {
+            mant = (mant << 1) | (frac >> 15);
+            frac = (frac << 1) & 0xFFFF;
+            final_exp--;
+        }
+    }
+
+    // 7. Stochastic rounding. (exp - 1) << 10 + mant packs normal and
+    // denormal results alike, and a carry walks into the exponent.
+    uint32_t mag = ((uint32_t)(final_exp - 1) << 10) + mant;
+    if (rnd < frac) mag++;
+    if (frac) ret.precision_lost = true;
+
+    // 8. Pack Result
+    if (mag >= 0x7C00) {
+        ret.overflow = true;
+        ret.res = (sign_big << 15) | 0x7C00;
+    } else {
+        ret.res = (fp16_t)((sign_big << 15) | mag);
+    }
+    if ((ret.res & 0x7FFF) == 0) ret.zero = true;
+    return ret;
+}
+
+inline BitTrueResult fp16_mul_bittrue_sr(fp16_t n1, fp16_t n2, uint16_t rnd) {
+    BitTrueResult ret = {0, false, false, false, false, false};
+
+    // 1. Decode inputs
+    uint16_t s1 = (n1 >> 15) & 1;
+    uint16_t e1 = (n1 >> 10) & 0x1F;
+    uint16_t f1 = n1 & 0x3FF;
+
+    uint16_t s2 = (n2 >> 15) & 1;
+    uint16_t e2 = (n2 >> 10) & 0x1F;
+    uint16_t f2 = n2 & 0x3FF;
+
+    // 2. Check Special Values
+    bool n1_is_inf  = (e1 == 31) && (f1 == 0);
+    bool n2_is_inf  = (e2 == 31) && (f2 == 0);
+    bool n1_is_nan  = (e1 == 31) && (f1 != 0);
+    bool n2_is_nan  = (e2 == 31) && (f2 != 0);
+    bool n1_is_zero = (e1 == 0) && (f1 == 0);
+    bool n2_is_zero = (e2 == 0) && (f2 == 0);
+    uint16_t s_res = s1 ^ s2;
+
+    if (n1_is_nan || n2_is_nan || (n1_is_inf && n2_is_zero) || (n2_is_inf && n1_is_zero)) {
+        ret.res = 0x7FFF; ret.nan = true; return ret;
+    }
+    if (n1_is_inf || n2_is_inf) {
+        ret.overflow = true;
+        ret.res = (s_res << 15) | 0x7C00;
+        return ret;
+    }
+    if (n1_is_zero || n2_is_zero) {
+        ret.zero = true;
+        ret.res = (s_res << 15);
+        return ret;
+    }
+
+    // 3. - 5. Exponent and 22-bit mantissa product
+    int32_t  exp_res   = ((e1 == 0) ? 1 : e1) + ((e2 == 0) ? 1 : e2) - 15;
+    uint32_t mant_mult = ((e1 == 0) ? f1 : (f1 | 1024)) * ((e2 == 0) ? f2 : (f2 | 1024));
+
+    // 6. Normalization: count the shift instead of dropping the bit
+    uint32_t drop = 10;
+    if (mant_mult & 0x200000) {
+        drop++;
+        exp_res++;
+    }
+
+    // 7. Overflow / underflow as the bit-true model
+    if (exp_res >= 31) {
+        ret.overflow = true;
+        ret.res = (s_res << 15) | 0x7C00;
+        return ret;
+    }
+    if (exp_res < -10) {
+        ret.underflow = true;
+        ret.zero = true;
+        ret.res = (s_res << 15);
+        return ret;
+    }
+    if (exp_res <= 0) { // Denormalize
+        drop += 1 - exp_res;
+        exp_res = 0;
+    }
+
+    // 8. Stochastic rounding of the dropped bits
+    uint64_t ext  = (uint64_t)mant_mult << 16;
+    uint32_t frac = (uint32_t)(ext >> drop) & 0xFFFF;
+    if (ext & ((1ull << drop) - 1)) frac |= 1; // sticky
+    uint32_t mag = ((uint32_t)exp_res << 10) + ((mant_mult >> drop) & 0x3FF);
+    if (rnd < frac) mag++;
+
+    if (mag >= 0x7C00) {
+        ret.overflow = true;
+        ret.res = (s_res << 15) | 0x7C00;
+    } else {
+        ret.res = (fp16_t)((s_res << 15) | mag);
+    }
+    if ((ret.res & 0x7FFF) == 0) ret.zero = true;
+    return ret;
+}
+
+// ----------------------------------------------------------------------------
+// Vectorized Kernels
+// ----------------------------------------------------------------------------
+// Branch-free forms, bit-identical to the scalar models with rnd[i].
+inline void fp16_add_sr_simd(const fp16_t* __restrict a, const fp16_t* __restrict b,
+                             const uint16_t* __restrict rnd, fp16_t* __restrict res,
+                             uint8_t* __restrict flags, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t n1 = a[i], n2 = b[i];
+        uint32_t s1 = n1 >> 15, e1 = (n1 >> 10) & 0x1F, f1 = n1 & 0x3FF;
+        uint32_t s2 = n2 >> 15, e2 = (n2 >> 10) & 0x1F, f2 = n2 & 0x3FF;
+
+        uint32_t n1_is_inf = (e1 == 31) & (f1 == 0);
+        uint32_t n2_is_inf = (e2 == 31) & (f2 == 0);
+        uint32_t is_nan = ((e1 == 31) & (f1 != 0)) | ((e2 == 31) & (f2 != 0)) |
+                          (n1_is_inf & n2_is_inf & (s1 ^ s2));
+        uint32_t is_inf = n1_is_inf | n2_is_inf;
+
+        uint32_t key1 = ((e1 | (e1 == 0)) << 11) | f1 | ((e1 != 0) << 10);
+        uint32_t key2 = ((e2 | (e2 == 0)) << 11) | f2 | ((e2 != 0) << 10);
+        uint32_t swap = key1 < key2;
+        uint32_t key_big = fp16_sel(swap, key2, key1);
+        uint32_t key_sml = fp16_sel(swap, key1, key2);
+
+        uint32_t sign_big = fp16_sel(swap, s2, s1);
+        uint32_t exp_big  = key_big >> 11;
+        uint32_t mant_big = key_big & 0x7FF;
+        uint32_t mant_sml = key_sml & 0x7FF;
+
+        uint32_t exp_diff = exp_big - (key_sml >> 11);
+        uint32_t shifted  = mant_sml >> exp_diff;
+        uint32_t ext      = mant_sml << 16;
+        uint32_t frac     = ((ext >> exp_diff) & 0xFFFF) | ((ext & ((1u << exp_diff) - 1)) != 0);
+
+        uint32_t same   = s1 == s2;
+        uint32_t borrow = fp16_sel(same, 0, frac != 0); // (a select: the & form stops GCC 12 vectorizing)
+        uint32_t sum    = fp16_sel(same, mant_big + shifted, mant_big - shifted - borrow);
+        frac = fp16_sel(borrow, 0x10000 - frac, frac);
+
+        // Mantissa and fraction as one 27-bit word: the carry shifts it right
+        // (keeping the sticky bit), a borrow left by min(lz, exp_big - 1)
+        uint32_t w     = (sum << 16) | frac;
+        uint32_t carry = sum >= 2048;
+        uint32_t x  = w << 5; // bit 26 -> 31 (garbage on carry, not used)
+        uint32_t lz = 0;
+        uint32_t c;
+        c = x < 0x00010000u; lz += c << 4; x = fp16_sel(c, x << 16, x);
+        c = x < 0x01000000u; lz += c << 3; x = fp16_sel(c, x << 8, x);
+        c = x < 0x10000000u; lz += c << 2; x = fp16_sel(c, x << 4, x);
+        c = x < 0x40000000u; lz += c << 1; x = fp16_sel(c, x << 2, x);
+        c = x < 0x80000000u; lz += c;
+        uint32_t lim = exp_big - 1;
+        uint32_t lsh = fp16_sel(carry, 0, fp16_sel(lz < lim, lz, lim));
+
+        w = fp16_sel(carry, (w >> 1) | (w & 1), w << lsh);
+        uint32_t exp  = fp16_sel(carry, exp_big + 1, exp_big - lsh);
+        uint32_t mant = w >> 16;
+        frac = w & 0xFFFF;
+
+        uint32_t mag = ((exp - 1) << 10) + mant + (rnd[i] < frac);
+        uint32_t zero_sum = w == 0;
+        uint32_t of = (mag >= 0x7C00) & !zero_sum;
+        uint32_t r  = fp16_sel(of, (sign_big << 15) | 0x7C00, (sign_big << 15) | mag);
+        r = fp16_sel(zero_sum, (same & sign_big) << 15, r);
+
+        uint32_t fl = fp16_sel(of, FP16_FLAG_OF, 0) |
+                      fp16_sel((r & 0x7FFF) == 0, FP16_FLAG_Z, 0) |
+                      fp16_sel(frac != 0, FP16_FLAG_PL, 0);
+
+        r  = fp16_sel(is_inf, fp16_sel(n1_is_inf, n1, n2), r);
+        fl = fp16_sel(is_inf, FP16_FLAG_OF, fl);
+        r  = fp16_sel(is_nan, 0x7FFF, r);
+        fl = fp16_sel(is_nan, FP16_FLAG_NAN, fl);
+
+        res[i]   = (fp16_t)r;
+        flags[i] = (uint8_t)fl;
+    }
+}
+
+inline void fp16_mul_sr_simd(const fp16_t* __restrict a, const fp16_t* __restrict b,
+                             const uint16_t* __restrict rnd, fp16_t* __restrict res,
+                             uint8_t* __restrict flags, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t n1 = a[i], n2 = b[i];
+        uint32_t s1 = n1 >> 15, e1 = (n1 >> 10) & 0x1F, f1 = n1 & 0x3FF;
+        uint32_t s2 = n2 >> 15, e2 = (n2 >> 10) & 0x1F, f2 = n2 & 0x3FF;
+        uint32_t sign = (s1 ^ s2) << 15;
+
+        uint32_t n1_is_inf  = (e1 == 31) & (f1 == 0);
+        uint32_t n2_is_inf  = (e2 == 31) & (f2 == 0);
+        uint32_t n1_is_zero = (e1 == 0) & (f1 == 0);
+        uint32_t n2_is_zero = (e2 == 0) & (f2 == 0);
+        uint32_t is_nan  = ((e1 == 31) & (f1 != 0)) | ((e2 == 31) & (f2 != 0)) |
+                           (n1_is_inf & n2_is_zero) | (n2_is_inf & n1_is_zero);
+        uint32_t is_inf  = n1_is_inf | n2_is_inf;
+        uint32_t is_zero = n1_is_zero | n2_is_zero;
+
+        int32_t  exp_res = (int32_t)(e1 | (e1 == 0)) + (int32_t)(e2 | (e2 == 0)) - 15;
+        uint32_t mant    = (f1 | ((e1 != 0) << 10)) * (f2 | ((e2 != 0) << 10));
+
+        uint32_t norm = (mant >> 21) & 1;
+        exp_res += norm;
+
+        uint32_t of  = exp_res >= 31;
+        uint32_t uf  = exp_res < -10;
+        uint32_t den = (exp_res <= 0) & !uf;
+
+        // Dropped low bits of the 22-bit product: 10 (+1 after the
+        // normalize shift, + 1 - exp_res for a denormal result), <= 22.
+        // Shifted to the top of a word, their upper 16 bits are the
+        // fraction and the rest the sticky bit.
+        uint32_t drop = 10 + norm + fp16_sel(den, (uint32_t)(1 - exp_res), 0);
+        uint32_t top  = mant << (32 - drop);
+        uint32_t frac = (top >> 16) | ((top & 0xFFFF) != 0);
+
+        uint32_t field = fp16_sel(den, 0, (uint32_t)exp_res << 10);
+        uint32_t mag = field + ((mant >> drop) & 0x3FF) + (rnd[i] < frac);
+        uint32_t ovf = of | (mag >= 0x7C00);
+        uint32_t r = fp16_sel(ovf, sign | 0x7C00, sign | mag);
+        r = fp16_sel(uf, sign, r);
+
+        uint32_t fl = fp16_sel(ovf & !uf, FP16_FLAG_OF, 0) |
+                      fp16_sel((r & 0x7FFF) == 0, FP16_FLAG_Z, 0) |
+                      fp16_sel(uf, FP16_FLAG_UF, 0);
+
+        r  = fp16_sel(is_zero, sign, r);
+        fl = fp16_sel(is_zero, FP16_FLAG_Z, fl);
+        r  = fp16_sel(is_inf, sign | 0x7C00, r);
+        fl = fp16_sel(is_inf, FP16_FLAG_OF, fl);
+        r  = fp16_sel(is_nan, 0x7FFF, r);
+        fl = fp16_sel(is_nan, FP16_FLAG_NAN, fl);
+
+        res[i]   = (fp16_t)r;
+        flags[i] = (uint8_t)fl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Batch Kernels
+// ----------------------------------------------------------------------------
+// SR with random words from rng, generated block by block into L1.
+static const size_t FP16_SR_BLOCK = 2048;    // random words per refill
+static const size_t FP16_SR_CHUNK = 1 << 16; // elements per seeded stream (parallel)
+
+inline void fp16_add_sr_batch(Fp16RngLanes& rng, const fp16_t* a, const fp16_t* b,
+                              fp16_t* res, uint8_t* flags, size_t n) {
+    alignas(64) uint16_t rnd[FP16_SR_BLOCK];
+    for (size_t off = 0; off < n; off += FP16_SR_BLOCK) {
+        size_t m = (n - off < FP16_SR_BLOCK) ? n - off : FP16_SR_BLOCK;
+        rng.fill_u16(rnd, m);
+        fp16_add_sr_simd(a + off, b + off, rnd, res + off, flags + off, m);
+    }
+}
+
+inline void fp16_mul_sr_batch(Fp16RngLanes& rng, const fp16_t* a, const fp16_t* b,
+                              fp16_t* res, uint8_t* flags, size_t n) {
+    alignas(64) uint16_t rnd[FP16_SR_BLOCK];
+    for (size_t off = 0; off < n; off += FP16_SR_BLOCK) {
+        size_t m = (n - off < FP16_SR_BLOCK) ? n - off : FP16_SR_BLOCK;
+        rng.fill_u16(rnd, m);
+        fp16_mul_sr_simd(a + off, b + off, rnd, res + off, flags + off, m);
+    }
+}
+
+// SR batch over [0, n) on a work-stealing pool. Chunk c of FP16_SR_CHUNK
+// elements uses the stream fp16_rng_chunk_seed(seed, c).
+inline void fp16_add_sr_parallel(Fp16Pool& pool, uint64_t seed, const fp16_t* a, const fp16_t* b,
+                                 fp16_t* res, uint8_t* flags, size_t n) {
+    pool.parallel_for(0, (n + FP16_SR_CHUNK - 1) / FP16_SR_CHUNK, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        for (uint64_t c = lo; c < hi; ++c) {
+            size_t off = (size_t)c * FP16_SR_CHUNK;
+            size_t m = (n - off < FP16_SR_CHUNK) ? n - off : FP16_SR_CHUNK;
+            Fp16RngLanes rng(fp16_rng_chunk_seed(seed, c));
+            fp16_add_sr_batch(rng, a + off, b + off, res + off, flags + off, m);
+        }
+    });
+}
+
+inline void fp16_mul_sr_parallel(Fp16Pool& pool, uint64_t seed, const fp16_t* a, const fp16_t* b,
+                                 fp16_t* res, uint8_t* flags, size_t n) {
+    pool.parallel_for(0, (n + FP16_SR_CHUNK - 1) / FP16_SR_CHUNK, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        for (uint64_t c = lo; c < hi; ++c) {
+            size_t off = (size_t)c * FP16_SR_CHUNK;
+            size_t m = (n - off < FP16_SR_CHUNK) ? n - off : FP16_SR_CHUNK;
+            Fp16RngLanes rng(fp16_rng_chunk_seed(seed, c));
+            fp16_mul_sr_batch(rng, a + off, b + off, res + off, flags + off, m);
+        }
+    });
+}
+
+#endif // FP16_SR_H
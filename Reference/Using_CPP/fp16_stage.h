@@ -0,0 +1,359 @@
+#ifndef FP16_STAGE_H
+#define FP16_STAGE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "fp16_common.h"
+
+// ----------------------------------------------------------------------------
+// Staged Bit-True Models
+// ----------------------------------------------------------------------------
+// fp16_add_bittrue and fp16_mul_bittrue (IEEE denormal policy) split into
+// the four named steps of theory/README.md, each a function on a state
+// struct that holds everything a pipeline register would carry:
+//   adder      : align (decode, specials, swap, shift) | add (mantissa
+//                add / sub) | normalize (carry, leading zeros, denormal) |
+//                pack (PL, overflow, fields)
+//   multiplier : exponent (decode, specials, sign, E1 + E2 - 15) |
+//                multiply (11 x 11 significands) | normalize (product
+//                >= 2) | pack (overflow, underflow, denormal, fields)
+// Special values and zero results set `done` early; later stages pass the
+// state on unchanged. Running all four stages is bit-identical to the
+// unstaged model (checked over all 2^32 pairs).
+//
+// A stage cut is a bit mask over the three inner stage boundaries: bit i
+// puts a pipeline register after stage i (a register always follows the
+// last stage). Cut 0 is the single-stage unit, cut 7 the four-stage one.
+// Fp16StagePipe simulates a cut cycle by cycle on an operand stream, and
+// fp16_cut_timing derives its clock from per-stage delay estimates.
+
+static const uint32_t FP16_STAGES = 4;
+static const uint32_t FP16_STAGE_CUTS = 1u << (FP16_STAGES - 1);
+
+struct Fp16AddState {
+    fp16_t n1, n2;
+    BitTrueResult ret;
+    bool done;
+    uint16_t sign_big, sign_sml;
+    int32_t exp;       // exp_big, then the result exponent
+    uint32_t mant_big;
+    uint32_t mant_sml; // aligned (shifted) small mantissa
+    uint32_t bits_lost;
+    uint32_t mant;     // sum, then the normalized mantissa
+};
+
+struct Fp16MulState {
+    fp16_t n1, n2;
+    BitTrueResult ret;
+    bool done;
+    uint16_t sign;
+    int32_t exp;
+    uint32_t mant1, mant2;
+    uint32_t mant; // significand product
+};
+
+template <typename S>
+struct Fp16StageDef {
+    const char* name;
+    void (*run)(S&);
+    double delay_ns; // combinational delay estimate
+};
+
+// ----------------------------------------------------------------------------
+// Adder Stages
+// ----------------------------------------------------------------------------
+inline void fp16_add_stage_align(Fp16AddState& s) {
+    s.ret = {0, false, false, false, false, false};
+    s.done = false;
+    uint16_t s1 = (s.n1 >> 15) & 1, e1 = (s.n1 >> 10) & 0x1F, f1 = s.n1 & 0x3FF;
+    uint16_t s2 = (s.n2 >> 15) & 1, e2 = (s.n2 >> 10) & 0x1F, f2 = s.n2 & 0x3FF;
+
+    bool n1_is_inf = (e1 == 31) && (f1 == 0);
+    bool n2_is_inf = (e2 == 31) && (f2 == 0);
+    bool n1_is_nan = (e1 == 31) && (f1 != 0);
+    bool n2_is_nan = (e2 == 31) && (f2 != 0);
+    if (n1_is_nan || n2_is_nan || (n1_is_inf && n2_is_inf && (s1 != s2))) {
+        s.ret.res = 0x7FFF; s.ret.nan = true; s.done = true; return;
+    }
+    if (n1_is_inf || n2_is_inf) {
+        s.ret.overflow = true;
+        s.ret.res = n1_is_inf ? s.n1 : s.n2;
+        s.done = true;
+        return;
+    }
+
+    int32_t exp1 = (e1 == 0) ? 1 : e1, exp2 = (e2 == 0) ? 1 : e2;
+    uint32_t mant1 = (e1 == 0) ? f1 : (f1 | 1024u), mant2 = (e2 == 0) ? f2 : (f2 | 1024u);
+    bool swap = exp1 < exp2 || (exp1 == exp2 && mant1 < mant2);
+    s.sign_big = swap ? s2 : s1;
+    s.sign_sml = swap ? s1 : s2;
+    s.exp = swap ? exp2 : exp1;
+    s.mant_big = swap ? mant2 : mant1;
+    uint32_t mant_sml = swap ? mant1 : mant2;
+    int32_t exp_diff = s.exp - (swap ? exp1 : exp2);
+
+    if (exp_diff >= 11 + 2) {
+        s.mant_sml = 0;
+        s.bits_lost = mant_sml != 0;
+    } else {
+        s.mant_sml = mant_sml >> exp_diff;
+        s.bits_lost = mant_sml & ((1u << exp_diff) - 1);
+    }
+}
+
+inline void fp16_add_stage_add(Fp16AddState& s) {
+    if (s.done) return;
+    s.mant = (s.sign_big == s.sign_sml) ? s.mant_big + s.mant_sml : s.mant_big - s.mant_sml;
+}
+
+inline void fp16_add_stage_normalize(Fp16AddState& s) {
+    if (s.done) return;
+    if (s.mant == 0) {
+        s.ret.res = (s.sign_big == s.sign_sml && s.sign_big == 1) ? 0x8000 : 0;
+        s.ret.zero = true;
+        s.ret.precision_lost = s.bits_lost != 0;
+        s.done = true;
+        return;
+    }
+    if (s.mant >= 2048) {
+        if (s.mant & 1) s.bits_lost = 1;
+        s.mant >>= 1;
+        s.exp++;
+    } else {
+        while (s.mant < 1024 && s.exp > 1) {
+            s.mant <<= 1;
+            s.exp--;
+        }
+        if (s.mant < 1024 && s.exp == 1) s.exp = 0;
+    }
+}
+
+inline void fp16_add_stage_pack(Fp16AddState& s) {
+    if (s.done) return;
+    if (s.bits_lost) s.ret.precision_lost = true;
+    if (s.exp >= 31) {
+        s.ret.overflow = true;
+        s.ret.res = (fp16_t)((s.sign_big << 15) | 0x7C00);
+    } else {
+        s.ret.res = (fp16_t)((s.sign_big << 15) | (s.exp << 10) | (s.mant & 0x3FF));
+    }
+    if ((s.ret.res & 0x7FFF) == 0) s.ret.zero = true;
+}
+
+// Default delays (ns) are estimates for the current fpadder.v split, which
+// closes at 250 MHz as one combinational stage; replace them with
+// post-synthesis numbers per stage.
+inline const Fp16StageDef<Fp16AddState>* fp16_add_stages() {
+    static const Fp16StageDef<Fp16AddState> s[FP16_STAGES] = {
+        {"align",     fp16_add_stage_align,     1.20},
+        {"add",       fp16_add_stage_add,       0.80},
+        {"normalize", fp16_add_stage_normalize, 1.15},
+        {"pack",      fp16_add_stage_pack,      0.40},
+    };
+    return s;
+}
+
+// ----------------------------------------------------------------------------
+// Multiplier Stages
+// ----------------------------------------------------------------------------
+inline void fp16_mul_stage_exponent(Fp16MulState& s) {
+    s.ret = {0, false, false, false, false, false};
+    s.done = false;
+    uint16_t s1 = (s.n1 >> 15) & 1, e1 = (s.n1 >> 10) & 0x1F, f1 = s.n1 & 0x3FF;
+    uint16_t s2 = (s.n2 >> 15) & 1, e2 = (s.n2 >> 10) & 0x1F, f2 = s.n2 & 0x3FF;
+    s.sign = s1 ^ s2;
+
+    bool n1_is_inf = (e1 == 31) && (f1 == 0), n2_is_inf = (e2 == 31) && (f2 == 0);
+    bool n1_is_nan = (e1 == 31) && (f1 != 0), n2_is_nan = (e2 == 31) && (f2 != 0);
+    bool n1_is_zero = (e1 == 0) && (f1 == 0), n2_is_zero = (e2 == 0) && (f2 == 0);
+    if (n1_is_nan || n2_is_nan || (n1_is_inf && n2_is_zero) || (n2_is_inf && n1_is_zero)) {
+        s.ret.res = 0x7FFF; s.ret.nan = true; s.done = true; return;
+    }
+    if (n1_is_inf || n2_is_inf) {
+        s.ret.overflow = true;
+        s.ret.res = (fp16_t)((s.sign << 15) | 0x7C00);
+        s.done = true;
+        return;
+    }
+    if (n1_is_zero || n2_is_zero) {
+        s.ret.zero = true;
+        s.ret.res = (fp16_t)(s.sign << 15);
+        s.done = true;
+        return;
+    }
+
+    s.exp = ((e1 == 0) ? 1 : e1) + ((e2 == 0) ? 1 : e2) - 15;
+    s.mant1 = (e1 == 0) ? f1 : (f1 | 1024u);
+    s.mant2 = (e2 == 0) ? f2 : (f2 | 1024u);
+}
+
+inline void fp16_mul_stage_multiply(Fp16MulState& s) {
+    if (s.done) return;
+    s.mant = s.mant1 * s.mant2;
+}
+
+inline void fp16_mul_stage_normalize(Fp16MulState& s) {
+    if (s.done) return;
+    if (s.mant & 0x200000) {
+        s.mant >>= 1;
+        s.exp++;
+    }
+}
+
+inline void fp16_mul_stage_pack(Fp16MulState& s) {
+    if (s.done) return;
+    if (s.exp >= 31) {
+        s.ret.overflow = true;
+        s.ret.res = (fp16_t)((s.sign << 15) | 0x7C00);
+    } else if (s.exp < -10) {
+        s.ret.underflow = true;
+        s.ret.zero = true;
+        s.ret.res = (fp16_t)(s.sign << 15);
+    } else {
+        uint32_t mant = s.mant;
+        int32_t exp = s.exp;
+        if (exp <= 0) { // denormal
+            mant >>= 1 - exp;
+            exp = 0;
+            if (mant == 0) s.ret.zero = true;
+        }
+        s.ret.res = (fp16_t)((s.sign << 15) | (exp << 10) | ((mant >> 10) & 0x3FF));
+    }
+    if ((s.ret.res & 0x7FFF) == 0) s.ret.zero = true;
+}
+
+// Estimates for a pipelined multiplier that is not written yet (11 x 11
+// significand product in one DSP or LUT array).
+inline const Fp16StageDef<Fp16MulState>* fp16_mul_stages() {
+    static const Fp16StageDef<Fp16MulState> s[FP16_STAGES] = {
+        {"exponent",  fp16_mul_stage_exponent,  0.55},
+        {"multiply",  fp16_mul_stage_multiply,  2.10},
+        {"normalize", fp16_mul_stage_normalize, 0.35},
+        {"pack",      fp16_mul_stage_pack,      0.75},
+    };
+    return s;
+}
+
+// All four stages back to back.
+inline BitTrueResult fp16_add_staged(fp16_t a, fp16_t b) {
+    Fp16AddState s;
+    s.n1 = a; s.n2 = b;
+    for (uint32_t i = 0; i < FP16_STAGES; ++i) fp16_add_stages()[i].run(s);
+    return s.ret;
+}
+
+inline BitTrueResult fp16_mul_staged(fp16_t a, fp16_t b) {
+    Fp16MulState s;
+    s.n1 = a; s.n2 = b;
+    for (uint32_t i = 0; i < FP16_STAGES; ++i) fp16_mul_stages()[i].run(s);
+    return s.ret;
+}
+
+// ----------------------------------------------------------------------------
+// Stage Cuts
+// ----------------------------------------------------------------------------
+inline uint32_t fp16_cut_depth(uint32_t cut) {
+    uint32_t d = 1;
+    for (uint32_t i = 0; i + 1 < FP16_STAGES; ++i) d += (cut >> i) & 1;
+    return d;
+}
+
+// "align+add | normalize+pack"
+template <typename S>
+inline std::string fp16_cut_name(const Fp16StageDef<S>* stages, uint32_t cut) {
+    std::string n = stages[0].name;
+    for (uint32_t i = 1; i < FP16_STAGES; ++i) {
+        n += ((cut >> (i - 1)) & 1) ? " | " : "+";
+        n += stages[i].name;
+    }
+    return n;
+}
+
+struct Fp16CutTiming {
+    uint32_t depth;
+    double period_ns; // slowest pipeline stage plus register overhead
+    double fmax_mhz;
+};
+
+template <typename S>
+inline Fp16CutTiming fp16_cut_timing(const Fp16StageDef<S>* stages, uint32_t cut, double reg_ns) {
+    double worst = 0, cur = 0;
+    for (uint32_t i = 0; i < FP16_STAGES; ++i) {
+        cur += stages[i].delay_ns;
+        if (i + 1 == FP16_STAGES || ((cut >> i) & 1)) {
+            if (cur > worst) worst = cur;
+            cur = 0;
+        }
+    }
+    Fp16CutTiming t;
+    t.depth = fp16_cut_depth(cut);
+    t.period_ns = worst + reg_ns;
+    t.fmax_mhz = 1000.0 / t.period_ns;
+    return t;
+}
+
+// ----------------------------------------------------------------------------
+// Cycle-Level Pipeline of a Cut
+// ----------------------------------------------------------------------------
+// One operand pair enters per cycle; register g holds the state after the
+// stages of pipeline stage g. A result leaves depth cycles after its
+// operands entered.
+template <typename S>
+class Fp16StagePipe {
+public:
+    Fp16StagePipe(const Fp16StageDef<S>* stages, uint32_t cut) : stages_(stages) {
+        first_.push_back(0);
+        for (uint32_t i = 0; i + 1 < FP16_STAGES; ++i) {
+            if ((cut >> i) & 1) first_.push_back(i + 1);
+        }
+        first_.push_back(FP16_STAGES);
+        regs_.resize(depth());
+        valid_.resize(depth());
+    }
+
+    uint32_t depth() const { return (uint32_t)first_.size() - 1; }
+
+    // Streams n pairs through the pipeline; returns the cycles until the
+    // last result has left it.
+    uint64_t run(const fp16_t* a, const fp16_t* b, size_t n, fp16_t* res, uint8_t* flags) {
+        const uint32_t P = depth();
+        for (uint32_t g = 0; g < P; ++g) valid_[g] = 0;
+        size_t in = 0, out = 0;
+        uint64_t t = 0;
+        for (; out < n; ++t) {
+            if (valid_[P - 1]) {
+                res[out] = regs_[P - 1].ret.res;
+                flags[out] = pack_flags(regs_[P - 1].ret);
+                ++out;
+            }
+            for (uint32_t g = P - 1; g > 0; --g) {
+                regs_[g] = regs_[g - 1];
+                valid_[g] = valid_[g - 1];
+                if (valid_[g]) eval(g, regs_[g]);
+            }
+            valid_[0] = in < n;
+            if (valid_[0]) {
+                regs_[0].n1 = a[in];
+                regs_[0].n2 = b[in];
+                ++in;
+                eval(0, regs_[0]);
+            }
+        }
+        return t;
+    }
+
+private:
+    void eval(uint32_t g, S& s) const {
+        for (uint32_t i = first_[g]; i < first_[g + 1]; ++i) stages_[i].run(s);
+    }
+
+    const Fp16StageDef<S>* stages_;
+    std::vector<uint32_t> first_; // first stage of each pipeline stage, then FP16_STAGES
+    std::vector<S> regs_;
+    std::vector<uint8_t> valid_;
+};
+
+#endif // FP16_STAGE_H
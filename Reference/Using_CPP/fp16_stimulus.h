@@ -0,0 +1,239 @@
+#ifndef FP16_STIMULUS_H
+#define FP16_STIMULUS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "fp16_common.h"
+#include "fp16_rng.h"
+
+// ----------------------------------------------------------------------------
+// Coverage-Directed Stimulus Generator
+// ----------------------------------------------------------------------------
+// Uniform 16-bit operands almost never hit the interesting corners of the
+// adder and multiplier (exact cancellation, exponent gaps around the 11-13
+// alignment limit, the denormal boundary, products that underflow or land
+// on the overflow edge). Fp16Stimulus draws operand pairs from weighted
+// classes that target those corners directly.
+//
+// The class is picked once per block of FP16_STIM_BLOCK pairs; every block
+// is then filled by a branch-free, auto-vectorized kernel for that class,
+// fed with one 64-bit word per pair from Fp16RngLanes (fp16_rng.h).
+// Build with -O3 -march=native for full throughput.
+//
+//   Fp16Stimulus stim(seed, fp16_stim_weights("add"));
+//   stim.fill(a, b, n);
+
+enum Fp16StimClass {
+    FP16_STIM_UNIFORM,      // raw 16-bit patterns
+    FP16_STIM_CANCEL,       // opposite sign, |b| = |a| +- 0..15 ulp (incl. exact)
+    FP16_STIM_EXP_GAP,      // exponent difference 0..15, both operand orders
+    FP16_STIM_DENORM_EDGE,  // pairs around 0x0400 / 0x0000 (denormal boundary)
+    FP16_STIM_MUL_DENORM,   // e1 + e2 in 3..16: product denormal or underflow
+    FP16_STIM_ADD_OVERFLOW, // same sign, exponents 28..30
+    FP16_STIM_MUL_OVERFLOW, // e1 + e2 in 28..33: product around the max exponent
+    FP16_STIM_SPECIAL,      // zeros, Inf, NaN, max, min normal/denormal
+    FP16_STIM_CLASS_COUNT
+};
+
+enum { FP16_STIM_BLOCK = 256 };
+
+inline const char* fp16_stim_class_name(int c) {
+    static const char* names[FP16_STIM_CLASS_COUNT] = {
+        "uniform", "cancel", "exp_gap", "denorm_edge", "mul_denorm",
+        "add_overflow", "mul_overflow", "special"
+    };
+    return names[c];
+}
+
+// Relative class weights (any scale; 0 disables a class).
+struct Fp16StimWeights {
+    uint32_t w[FP16_STIM_CLASS_COUNT];
+};
+
+// Presets: "uniform" (raw patterns only), "add" and "mul" (directed at the
+// adder / multiplier corners) and "mixed" (both).
+inline bool fp16_stim_weights(const std::string& name, Fp16StimWeights& out) {
+    //                                  uni can gap den mde aov mov spc
+    static const Fp16StimWeights uni = {{ 1,  0,  0,  0,  0,  0,  0,  0}};
+    static const Fp16StimWeights add = {{ 2,  4,  6,  2,  0,  2,  0,  1}};
+    static const Fp16StimWeights mul = {{ 2,  0,  1,  2,  5,  0,  5,  1}};
+    static const Fp16StimWeights mix = {{ 2,  3,  4,  2,  3,  1,  3,  1}};
+    if (name == "uniform") out = uni;
+    else if (name == "add") out = add;
+    else if (name == "mul") out = mul;
+    else if (name == "mixed") out = mix;
+    else return false;
+    return true;
+}
+
+inline Fp16StimWeights fp16_stim_weights(const std::string& name) {
+    Fp16StimWeights w;
+    if (!fp16_stim_weights(name, w)) fp16_stim_weights("mixed", w);
+    return w;
+}
+
+// Uniform integer in [0, n) from the low 16 bits of r (n <= 65536).
+inline uint32_t fp16_stim_range(uint32_t r, uint32_t n) { return ((r & 0xFFFF) * n) >> 16; }
+
+inline uint32_t fp16_stim_pack(uint32_t s, uint32_t e, uint32_t f) {
+    return ((s & 1) << 15) | ((e & 0x1F) << 10) | (f & 0x3FF);
+}
+
+// ----------------------------------------------------------------------------
+// Class Kernels
+// ----------------------------------------------------------------------------
+// Every kernel turns one random word per pair, split into two 32-bit
+// halves (w0, w1), into (a, b).
+template <typename F>
+inline void fp16_stim_block(fp16_t* __restrict a, fp16_t* __restrict b, size_t n,
+                            const uint64_t* __restrict w, F make) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t x, y;
+        make((uint32_t)w[i], (uint32_t)(w[i] >> 32), x, y);
+        a[i] = (fp16_t)x;
+        b[i] = (fp16_t)y;
+    }
+}
+
+inline void fp16_stim_class(int cls, fp16_t* a, fp16_t* b, size_t n, const uint64_t* w) {
+    switch (cls) {
+    case FP16_STIM_UNIFORM:
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t, uint32_t& x, uint32_t& y) {
+            x = w0; y = w0 >> 16;
+        });
+        break;
+    case FP16_STIM_CANCEL:
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t w1, uint32_t& x, uint32_t& y) {
+            // FP16 magnitudes are ordered like integers, so +-delta on the
+            // 15-bit magnitude moves by ulps and crosses exponent boundaries.
+            uint32_t s   = w0 & 1;
+            uint32_t mag = fp16_stim_pack(0, fp16_stim_range(w0 >> 16, 31), w0 >> 1);
+            uint32_t d   = (w1 & 0xF) >> ((w1 >> 4) & 3);
+            uint32_t bm  = fp16_sel((w1 >> 6) & 1, mag + d, mag - d);
+            bm = fp16_sel(bm > 0x7BFF, mag, bm);
+            x = (s << 15) | mag;
+            y = ((s ^ 1) << 15) | bm;
+        });
+        break;
+    case FP16_STIM_EXP_GAP:
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t w1, uint32_t& x, uint32_t& y) {
+            uint32_t g  = fp16_stim_range(w1, 16);
+            uint32_t e2 = fp16_stim_range(w1 >> 16, 31 - g);
+            uint32_t p  = fp16_stim_pack(w0, e2 + g, w0 >> 1);
+            uint32_t q  = fp16_stim_pack(w0 >> 11, e2, w0 >> 12);
+            uint32_t sw = (w0 >> 22) & 1;
+            x = fp16_sel(sw, q, p);
+            y = fp16_sel(sw, p, q);
+        });
+        break;
+    case FP16_STIM_DENORM_EDGE:
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t w1, uint32_t& x, uint32_t& y) {
+            // Magnitudes 0x03E0..0x041F (denormal/normal edge) or 0x0000..0x003F.
+            uint32_t base_a = fp16_sel(w1 & 1, 0x0000, 0x03E0);
+            uint32_t base_b = fp16_sel((w1 >> 1) & 1, 0x0000, 0x03E0);
+            x = (((w0 >> 12) & 1) << 15) | (base_a + (w0 & 63));
+            y = (((w0 >> 13) & 1) << 15) | (base_b + ((w0 >> 6) & 63));
+        });
+        break;
+    case FP16_STIM_MUL_DENORM:
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t w1, uint32_t& x, uint32_t& y) {
+            uint32_t t  = 3 + fp16_stim_range(w1 >> 16, 14);  // e1 + e2
+            uint32_t e1 = 1 + fp16_stim_range(w1, t - 1);
+            x = fp16_stim_pack(w0, e1, w0 >> 1);
+            y = fp16_stim_pack(w0 >> 11, t - e1, w0 >> 12);
+        });
+        break;
+    case FP16_STIM_ADD_OVERFLOW:
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t w1, uint32_t& x, uint32_t& y) {
+            uint32_t s = w0 & 1;
+            x = fp16_stim_pack(s, 28 + fp16_stim_range(w1, 3), w0 >> 1);
+            y = fp16_stim_pack(s, 28 + fp16_stim_range(w1 >> 16, 3), w0 >> 11);
+        });
+        break;
+    case FP16_STIM_MUL_OVERFLOW:
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t w1, uint32_t& x, uint32_t& y) {
+            uint32_t t  = 28 + fp16_stim_range(w1 >> 16, 6);  // e1 + e2
+            uint32_t lo = fp16_sel(t > 31, t - 30, 1);
+            uint32_t hi = fp16_sel(t > 31, 30, t - 1);
+            uint32_t e1 = lo + fp16_stim_range(w1, hi - lo + 1);
+            x = fp16_stim_pack(w0, e1, w0 >> 1);
+            y = fp16_stim_pack(w0 >> 11, t - e1, w0 >> 12);
+        });
+        break;
+    default: // FP16_STIM_SPECIAL
+        fp16_stim_block(a, b, n, w, [](uint32_t w0, uint32_t w1, uint32_t& x, uint32_t& y) {
+            // Magnitude index 0..7: 0, Inf, qNaN, sNaN, max, min normal,
+            // max denormal, min denormal. Exponents and fraction codes are
+            // packed into constants and picked with variable shifts.
+            const uint32_t E_LO = 0 | (31 << 5) | (31 << 10) | (31 << 15);
+            const uint32_t E_HI = 30 | (1 << 5) | (0 << 10) | (0 << 15);
+            const uint32_t F_CODE = (0 << 0) | (0 << 2) | (2 << 4) | (1 << 6) |
+                                    (3 << 8) | (0 << 10) | (3 << 12) | (1 << 14);
+            uint32_t m[2];
+            for (int k = 0; k < 2; ++k) {
+                uint32_t idx  = (w0 >> (3 * k)) & 7;
+                uint32_t e    = (fp16_sel(idx & 4, E_HI, E_LO) >> (5 * (idx & 3))) & 31;
+                uint32_t code = (F_CODE >> (2 * idx)) & 3;
+                uint32_t f    = (code & 1) | ((code >> 1) << 9) | (((code + 1) >> 2) * 0x1FF);
+                m[k] = fp16_stim_pack(w0 >> (6 + k), e, f);
+            }
+            x = fp16_sel(w1 & 1, m[0], w0 >> 16);
+            y = fp16_sel((w1 >> 1) & 1, m[1], w1 >> 16);
+        });
+        break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Generator
+// ----------------------------------------------------------------------------
+class Fp16Stimulus {
+public:
+    explicit Fp16Stimulus(uint64_t seed, const Fp16StimWeights& w = fp16_stim_weights("mixed"))
+        : words_(seed), block_key_(fp16_mix64(seed)), block_(0) {
+        set_weights(w);
+    }
+
+    // Builds a 256-entry class table; weights are scaled to 256 slots with
+    // every enabled class getting at least one.
+    void set_weights(const Fp16StimWeights& w) {
+        uint64_t sum = 0;
+        for (int c = 0; c < FP16_STIM_CLASS_COUNT; ++c) sum += w.w[c];
+        if (sum == 0) { for (int i = 0; i < 256; ++i) lut_[i] = FP16_STIM_UNIFORM; return; }
+        int slot = 0;
+        uint64_t acc = 0;
+        for (int c = 0; c < FP16_STIM_CLASS_COUNT; ++c) {
+            if (!w.w[c]) continue;
+            acc += w.w[c];
+            int end = (int)((acc * 256 + sum - 1) / sum);
+            if (end <= slot) end = slot + 1;
+            if (end > 256) end = 256;
+            for (; slot < end; ++slot) lut_[slot] = (uint8_t)c;
+        }
+        for (; slot < 256; ++slot) lut_[slot] = lut_[slot - 1];
+    }
+
+    void fill(fp16_t* a, fp16_t* b, size_t n) {
+        for (size_t off = 0; off < n; off += FP16_STIM_BLOCK) {
+            size_t m = (n - off < (size_t)FP16_STIM_BLOCK) ? n - off : (size_t)FP16_STIM_BLOCK;
+            int cls = lut_[fp16_mix64(block_key_ + block_++) >> 56];
+            words_.fill_u64(buf_, FP16_STIM_BLOCK);
+            fp16_stim_class(cls, a + off, b + off, m, buf_);
+            class_count_[cls] += m;
+        }
+    }
+
+    uint64_t generated(int cls) const { return class_count_[cls]; }
+
+private:
+    Fp16RngLanes words_;
+    uint64_t block_key_;
+    uint64_t block_;
+    alignas(64) uint64_t buf_[FP16_STIM_BLOCK];
+    uint8_t lut_[256];
+    uint64_t class_count_[FP16_STIM_CLASS_COUNT] = {0};
+};
+
+#endif // FP16_STIMULUS_H
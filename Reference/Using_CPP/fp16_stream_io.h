@@ -0,0 +1,138 @@
+#ifndef FP16_STREAM_IO_H
+#define FP16_STREAM_IO_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <unistd.h>
+
+#include "fp16_common.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Binary Stream Filter
+// ----------------------------------------------------------------------------
+// Record formats (little-endian, no header):
+//   input  : 4 bytes per vector   { uint16 a, uint16 b }
+//   output : 4 bytes per result   { uint16 res, uint8 flags, uint8 0 }
+// flags uses the FP16_FLAG_* bits of fp16_common.h. Input is read with
+// read(2) into 64-byte aligned blocks of up to FP16_STREAM_BLOCK records;
+// the whole records of each read are unpacked, run through a SIMD kernel and
+// repacked in FP16_POOL_GRAIN slices on the work-stealing pool, then
+// written with write(2) before the next read, so a co-simulation driver
+// that writes a batch and waits for its results does not deadlock. A
+// partial record is carried over to the next read. Output order matches
+// input order. A trailing partial record at EOF is an error.
+
+enum { FP16_STREAM_BLOCK = 1 << 20 }; // records per block (4 MiB in, 4 MiB out)
+
+struct Fp16AlignedFree {
+    void operator()(void* p) const { std::free(p); }
+};
+
+// 64-byte aligned array of n uint32_t records.
+inline std::unique_ptr<uint32_t[], Fp16AlignedFree> fp16_stream_alloc(size_t n) {
+    size_t bytes = (n * sizeof(uint32_t) + 63) & ~(size_t)63;
+    return std::unique_ptr<uint32_t[], Fp16AlignedFree>((uint32_t*)std::aligned_alloc(64, bytes));
+}
+
+// Records are stored little-endian; a no-op on x86 and ARM.
+inline uint32_t fp16_stream_le32(uint32_t w) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap32(w);
+#else
+    return w;
+#endif
+}
+
+// One read(2) of up to `bytes`, retried on EINTR. Returns bytes read (0 at
+// EOF), or -1 on error.
+inline ssize_t fp16_stream_read(int fd, void* buf, size_t bytes) {
+    for (;;) {
+        ssize_t r = ::read(fd, buf, bytes);
+        if (r >= 0 || errno != EINTR) return r;
+    }
+}
+
+inline bool fp16_stream_write(int fd, const void* buf, size_t bytes) {
+    size_t put = 0;
+    while (put < bytes) {
+        ssize_t r = ::write(fd, (const char*)buf + put, bytes - put);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        put += (size_t)r;
+    }
+    return true;
+}
+
+// Unpack, compute and repack records [0, n) of one block.
+inline void fp16_stream_block(Fp16Pool& pool, Fp16BinaryKernel kernel, const uint32_t* in,
+                              uint32_t* out, size_t n, std::vector<std::vector<fp16_t>>& scratch,
+                              std::vector<std::vector<uint8_t>>& fscratch) {
+    pool.parallel_for(0, n, FP16_POOL_GRAIN, [&](uint64_t lo, uint64_t hi, unsigned w) {
+        std::vector<fp16_t>& s = scratch[w];
+        std::vector<uint8_t>& f = fscratch[w];
+        if (s.empty()) { s.resize(3 * FP16_POOL_GRAIN); f.resize(FP16_POOL_GRAIN); }
+        fp16_t* __restrict a = s.data();
+        fp16_t* __restrict b = a + FP16_POOL_GRAIN;
+        fp16_t* __restrict res = b + FP16_POOL_GRAIN;
+        uint8_t* __restrict flags = f.data();
+
+        for (uint64_t off = lo; off < hi; off += FP16_POOL_GRAIN) {
+            size_t m = (hi - off < FP16_POOL_GRAIN) ? (size_t)(hi - off) : (size_t)FP16_POOL_GRAIN;
+            const uint32_t* __restrict src = in + off;
+            uint32_t* __restrict dst = out + off;
+            for (size_t i = 0; i < m; ++i) {
+                uint32_t v = fp16_stream_le32(src[i]);
+                a[i] = (fp16_t)v;
+                b[i] = (fp16_t)(v >> 16);
+            }
+            kernel(a, b, res, flags, m);
+            for (size_t i = 0; i < m; ++i) dst[i] = fp16_stream_le32((uint32_t)res[i] | ((uint32_t)flags[i] << 16));
+        }
+    });
+}
+
+// Filters in_fd to out_fd until EOF. Errors are reported on std::cerr.
+inline bool fp16_stream_filter(Fp16BinaryKernel kernel, unsigned threads, int in_fd = 0, int out_fd = 1) {
+    Fp16Pool pool(threads);
+    auto in = fp16_stream_alloc(FP16_STREAM_BLOCK);
+    auto out = fp16_stream_alloc(FP16_STREAM_BLOCK);
+    if (!in || !out) {
+        std::cerr << "fp16 filter: out of memory\n";
+        return false;
+    }
+    std::vector<std::vector<fp16_t>> scratch(pool.size());
+    std::vector<std::vector<uint8_t>> fscratch(pool.size());
+
+    size_t carry = 0; // bytes of a partial record at the start of in
+    for (;;) {
+        ssize_t got = fp16_stream_read(in_fd, (char*)in.get() + carry, (size_t)FP16_STREAM_BLOCK * 4 - carry);
+        if (got < 0) {
+            std::cerr << "fp16 filter: read failed: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        if (got == 0) {
+            if (carry == 0) return true;
+            std::cerr << "fp16 filter: trailing partial record (" << carry << " bytes)\n";
+            return false;
+        }
+        size_t have = carry + (size_t)got;
+        size_t n = have / 4;
+        fp16_stream_block(pool, kernel, in.get(), out.get(), n, scratch, fscratch);
+        if (n && !fp16_stream_write(out_fd, out.get(), n * 4)) {
+            std::cerr << "fp16 filter: write failed: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        carry = have % 4;
+        std::memmove(in.get(), (char*)in.get() + n * 4, carry);
+    }
+}
+
+#endif // FP16_STREAM_IO_H
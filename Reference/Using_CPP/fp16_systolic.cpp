@@ -0,0 +1,155 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_systolic.h"
+#include "fp16_workload.h"
+
+// ----------------------------------------------------------------------------
+// Systolic-Array Layer Simulation
+// ----------------------------------------------------------------------------
+// Usage: fp16_systolic [--array N | --rows R --cols C] [--dataflow os|ws|all] [--m M] [--k K] [--n N]
+//                      [--workload NAME] [--pe-csv FILE] [--seed S] [--threads T]
+//
+// Runs one layer C[M x N] = A[M x K] * W[K x N] on an R x C array of bit-true
+// MAC cells (fp16_systolic.h) with each dataflow. A holds the activations
+// and W the weights of a fp16_workload.h workload (default fc); row m of A
+// and column n of W are seeded from (seed, m) and (seed, n), so results do
+// not depend on the thread count. Reports cycles, tiles, utilization and
+// simulation speed, the error of C against the exact products (FP16 ULPs
+// at the exact result, "CR %" = share equal to the RNE result) and the PE
+// flag events with the busiest PE. --pe-csv writes the flag counts of
+// every PE.
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint32_t rows = 128, cols = 128;
+    size_t M = 256, K = 1024, N = 512;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string flow_name = "all", name = "fc", pe_csv;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--array" && i + 1 < argc) rows = cols = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--rows" && i + 1 < argc) rows = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--cols" && i + 1 < argc) cols = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--dataflow" && i + 1 < argc) flow_name = argv[++i];
+        else if (arg == "--m" && i + 1 < argc) M = std::stoull(argv[++i]);
+        else if (arg == "--k" && i + 1 < argc) K = std::stoull(argv[++i]);
+        else if (arg == "--n" && i + 1 < argc) N = std::stoull(argv[++i]);
+        else if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--pe-csv" && i + 1 < argc) pe_csv = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--array N | --rows R --cols C] [--dataflow os|ws|all]"
+                      << " [--m M] [--k K] [--n N] [--workload NAME] [--pe-csv FILE] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+    if (rows == 0 || cols == 0 || M == 0 || K == 0 || N == 0) {
+        std::cerr << "Array and layer dimensions must be positive\n";
+        return 1;
+    }
+    std::vector<Fp16Dataflow> flows;
+    if (flow_name == "all") flows = {FP16_DATAFLOW_OS, FP16_DATAFLOW_WS};
+    else if (flow_name == "os") flows = {FP16_DATAFLOW_OS};
+    else if (flow_name == "ws") flows = {FP16_DATAFLOW_WS};
+    else {
+        std::cerr << "Unknown dataflow: " << flow_name << " (available: os ws all)\n";
+        return 1;
+    }
+    Fp16Workload wl;
+    if (!fp16_workload(name, wl)) {
+        fp16_workload_unknown(name);
+        return 1;
+    }
+
+    Fp16Pool pool(threads ? threads : 1);
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << ", " << rows << " x " << cols
+              << " array, layer " << M << " x " << K << " x " << N << " (" << wl.name << "), " << pool.size()
+              << " thread(s)\n";
+
+    std::vector<fp16_t> A, W, C(M * N);
+    fp16_workload_gemm_operands(pool, wl, seed, M, K, N, A, W);
+    std::vector<double> exact(M * N);
+    pool.parallel_for(0, M, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        std::vector<double> acc(N);
+        for (uint64_t m = lo; m < hi; ++m) {
+            for (size_t n = 0; n < N; ++n) acc[n] = 0;
+            for (size_t k = 0; k < K; ++k) {
+                double a = fp16_oracle_to_double(A[m * K + k]);
+                for (size_t n = 0; n < N; ++n) acc[n] += a * fp16_oracle_to_double(W[k * N + n]);
+            }
+            for (size_t n = 0; n < N; ++n) exact[m * N + n] = acc[n];
+        }
+    });
+
+    std::ofstream csv;
+    if (!pe_csv.empty()) {
+        csv.open(pe_csv);
+        if (!csv) {
+            std::cerr << "Cannot write " << pe_csv << "\n";
+            return 1;
+        }
+        csv << "dataflow,row,col,macs,overflow,underflow,precision_lost,nan\n";
+    }
+
+    for (Fp16Dataflow flow : flows) {
+        Fp16Systolic array(rows, cols, flow);
+        Fp16SystolicStats st;
+        auto t0 = std::chrono::steady_clock::now();
+        array.matmul(pool, A.data(), W.data(), C.data(), M, K, N, st);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        Fp16WorkloadScore err;
+        for (size_t i = 0; i < M * N; ++i) fp16_workload_score(err, C[i], exact[i]);
+
+        Fp16PeStats total;
+        size_t busiest = 0;
+        uint64_t pe_with_of = 0;
+        for (size_t p = 0; p < st.pe.size(); ++p) {
+            const Fp16PeStats& s = st.pe[p];
+            total.macs += s.macs; total.overflow += s.overflow; total.underflow += s.underflow;
+            total.precision_lost += s.precision_lost; total.nan += s.nan;
+            pe_with_of += s.overflow != 0;
+            const Fp16PeStats& b = st.pe[busiest];
+            if (s.precision_lost + s.underflow > b.precision_lost + b.underflow) busiest = p;
+            if (csv) {
+                csv << fp16_dataflow_name(flow) << "," << p / cols << "," << p % cols << "," << s.macs << ","
+                    << s.overflow << "," << s.underflow << "," << s.precision_lost << "," << s.nan << "\n";
+            }
+        }
+        double pe_macs = total.macs ? (double)total.macs : 1.0;
+
+        std::cout << "--------------------------------------------------------------------------------------------------\n"
+                  << " " << (flow == FP16_DATAFLOW_OS ? "Output stationary" : "Weight stationary") << "\n"
+                  << "--------------------------------------------------------------------------------------------------\n"
+                  << std::fixed << std::setprecision(2)
+                  << "  Cycles       : " << st.cycles << " (" << st.tiles << " tiles), utilization "
+                  << 100.0 * st.utilization() << " %\n"
+                  << "  Simulation   : " << sec << " s, " << st.macs / sec / 1e6 << " M MAC/s\n"
+                  << "  Error        : mean rel " << std::scientific << std::setprecision(4)
+                  << err.mean_rel() << ", max rel " << err.max_rel << std::fixed << ", mean |ULP| "
+                  << err.mean_ulp() << ", CR " << std::setprecision(2) << err.cr_percent() << " %\n"
+                  << "  PE flags     : OF " << 100.0 * total.overflow / pe_macs << " %, UF "
+                  << 100.0 * total.underflow / pe_macs << " %, PL " << 100.0 * total.precision_lost / pe_macs
+                  << " %, NaN " << 100.0 * total.nan / pe_macs << " % of PE MACs; " << pe_with_of
+                  << " PE(s) overflowed\n"
+                  << "  Busiest PE   : (" << busiest / cols << ", " << busiest % cols << "), "
+                  << st.pe[busiest].precision_lost << " PL + " << st.pe[busiest].underflow << " UF in "
+                  << st.pe[busiest].macs << " MACs\n";
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------\n";
+    if (csv) std::cout << "Per-PE flags written to " << pe_csv << "\n";
+    return 0;
+}
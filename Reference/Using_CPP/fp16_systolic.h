@@ -0,0 +1,153 @@
+#ifndef FP16_SYSTOLIC_H
+#define FP16_SYSTOLIC_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Systolic Array of Bit-True MAC Cells
+// ----------------------------------------------------------------------------
+// C[M x N] = A[M x K] * W[K x N] (row-major FP16) on an R x C array of
+// processing elements, each one fp16_mul_bittrue and one fp16_add_bittrue.
+// Operands enter skewed, so PE (i, j) works on index t - i - j in cycle t.
+//   output stationary (os) : tiles of R x C outputs. A rows enter from the
+//       left, W columns from the top, PE (i, j) accumulates
+//       C[m0 + i][n0 + j] over k = 0 .. K-1 in order (the serial MAC
+//       chain). Tile: K + R + C - 2 compute cycles, then R cycles to shift
+//       the outputs out.
+//   weight stationary (ws) : tiles of R x C weights W[k0 + i][n0 + j],
+//       loaded in R cycles. A rows stream in from the left and partial
+//       sums flow down each column from +0; the bottom of column j adds
+//       each finished partial sum into an output buffer with the same
+//       adder (the first k tile is stored). Tile: R + M + R + C - 2 cycles.
+// Tiles run back to back without overlap. The simulation steps every PE
+// cycle by cycle; independent PE lines run on the pool (array rows for
+// os, array columns for ws, where partial sums couple the rows), so the
+// results and flag counts do not depend on the thread count.
+
+enum Fp16Dataflow { FP16_DATAFLOW_OS, FP16_DATAFLOW_WS };
+
+inline const char* fp16_dataflow_name(Fp16Dataflow d) { return d == FP16_DATAFLOW_OS ? "os" : "ws"; }
+
+// Flag events of one PE (multiplier and adder results).
+struct Fp16PeStats {
+    uint64_t macs = 0, overflow = 0, underflow = 0, precision_lost = 0, nan = 0;
+
+    void count(const BitTrueResult& mul, const BitTrueResult& add) {
+        macs++;
+        overflow += mul.overflow | add.overflow;
+        underflow += mul.underflow;
+        precision_lost += add.precision_lost;
+        nan += mul.nan | add.nan;
+    }
+};
+
+struct Fp16SystolicStats {
+    uint32_t rows = 0, cols = 0;
+    uint64_t cycles = 0, tiles = 0, macs = 0;
+    std::vector<Fp16PeStats> pe; // rows * cols, row-major
+
+    double utilization() const { return cycles ? (double)macs / ((double)cycles * rows * cols) : 0.0; }
+};
+
+class Fp16Systolic {
+public:
+    Fp16Systolic(uint32_t rows, uint32_t cols, Fp16Dataflow flow) : rows_(rows), cols_(cols), flow_(flow) {}
+
+    void matmul(Fp16Pool& pool, const fp16_t* A, const fp16_t* W, fp16_t* C, size_t M, size_t K, size_t N,
+                Fp16SystolicStats& st) const {
+        st.rows = rows_;
+        st.cols = cols_;
+        st.pe.assign((size_t)rows_ * cols_, Fp16PeStats());
+        // Empty products: C is all zeros and no tile runs (the per-tile
+        // cycle bounds below assume M, K and N of at least one).
+        if (M == 0 || K == 0 || N == 0) {
+            for (size_t i = 0; i < M * N; ++i) C[i] = 0;
+            st.macs = 0;
+            return;
+        }
+        if (flow_ == FP16_DATAFLOW_OS) {
+            for (size_t m0 = 0; m0 < M; m0 += rows_) {
+                for (size_t n0 = 0; n0 < N; n0 += cols_) {
+                    pool.parallel_for(0, rows_, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+                        for (uint64_t i = lo; i < hi; ++i) os_row((uint32_t)i, A, W, C, M, K, N, m0, n0, st);
+                    });
+                    st.cycles += K + 2 * (uint64_t)rows_ + cols_ - 2;
+                    st.tiles++;
+                }
+            }
+        } else {
+            for (size_t k0 = 0; k0 < K; k0 += rows_) {
+                for (size_t n0 = 0; n0 < N; n0 += cols_) {
+                    pool.parallel_for(0, cols_, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+                        for (uint64_t j = lo; j < hi; ++j) ws_col((uint32_t)j, A, W, C, M, K, N, k0, n0, st);
+                    });
+                    st.cycles += M + 2 * (uint64_t)rows_ + cols_ - 2;
+                    st.tiles++;
+                }
+            }
+        }
+        st.macs = (uint64_t)M * K * N;
+    }
+
+private:
+    // Array row i of an os tile, cycle by cycle.
+    void os_row(uint32_t i, const fp16_t* A, const fp16_t* W, fp16_t* C, size_t M, size_t K, size_t N, size_t m0,
+                size_t n0, Fp16SystolicStats& st) const {
+        size_t m = m0 + i;
+        if (m >= M) return;
+        uint32_t nc = (uint32_t)(N - n0 < cols_ ? N - n0 : cols_);
+        std::vector<fp16_t> acc(nc, 0);
+        Fp16PeStats* pe = &st.pe[(size_t)i * cols_];
+        const fp16_t* a = A + m * K;
+        uint64_t last = K + i + nc - 2; // cycle of the last MAC in this row
+        for (uint64_t t = i; t <= last; ++t) {
+            uint64_t jlo = t - i >= K ? t - i - (K - 1) : 0;
+            uint64_t jhi = t - i < nc - 1 ? t - i : nc - 1;
+            for (uint64_t j = jlo; j <= jhi; ++j) {
+                size_t k = t - i - j;
+                BitTrueResult p = fp16_mul_bittrue(a[k], W[k * N + n0 + j]);
+                BitTrueResult s = fp16_add_bittrue(acc[j], p.res);
+                pe[j].count(p, s);
+                acc[j] = s.res;
+            }
+        }
+        for (uint32_t j = 0; j < nc; ++j) C[m * N + n0 + j] = acc[j];
+    }
+
+    // Array column j of a ws tile, cycle by cycle. Rows are updated bottom
+    // up so psum[i - 1] still holds the previous cycle's value.
+    void ws_col(uint32_t j, const fp16_t* A, const fp16_t* W, fp16_t* C, size_t M, size_t K, size_t N, size_t k0,
+                size_t n0, Fp16SystolicStats& st) const {
+        size_t n = n0 + j;
+        if (n >= N) return;
+        uint32_t kt = (uint32_t)(K - k0 < rows_ ? K - k0 : rows_);
+        std::vector<fp16_t> psum(kt, 0);
+        uint64_t last = M + kt + j - 2;
+        for (uint64_t t = j; t <= last; ++t) {
+            for (uint32_t i = kt; i-- > 0;) {
+                if (t < (uint64_t)i + j || t - i - j >= M) continue;
+                size_t m = t - i - j;
+                BitTrueResult p = fp16_mul_bittrue(A[m * K + k0 + i], W[(k0 + i) * N + n]);
+                BitTrueResult s = fp16_add_bittrue(i ? psum[i - 1] : (fp16_t)0, p.res);
+                st.pe[(size_t)i * cols_ + j].count(p, s);
+                psum[i] = s.res;
+                if (i == kt - 1) {
+                    fp16_t& out = C[m * N + n];
+                    out = k0 ? fp16_add_bittrue(out, s.res).res : s.res;
+                }
+            }
+        }
+    }
+
+    uint32_t rows_, cols_;
+    Fp16Dataflow flow_;
+};
+
+#endif // FP16_SYSTOLIC_H
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <iomanip>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#include "fp16_adder.h"
+#include "fp16_mac.h"
+#include "fp16_mul.h"
+#include "fp16_npy.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Tensor Files Through the Reference Kernels
+// ----------------------------------------------------------------------------
+// Usage: fp16_tensor --op add|mul|mac --a FILE --b FILE --out FILE [--flags FILE] [--k K]
+//                    [--round rz|rne|ru|rd] [--fp32] [--raw] [--threads T]
+//
+// Maps two FP16 tensors (.npy float16 / uint16, or raw uint16 files; see
+// fp16_npy.h) and runs them through the bit-true kernels straight from
+// the mappings, writing the result into a mapped .npy (--raw: headerless
+// uint16) file:
+//   add, mul : element-wise fp16_add_simd / fp16_mul_simd; a and b have the
+//              same shape and order (raw files: the same element count),
+//              the output takes that shape and order.
+//              --flags also writes the FP16_FLAG_* bits as a uint8 .npy.
+//   mac      : dot products over the last axis (fp16_mac.h, FP32
+//              accumulation in --round mode, default rne): a and b both of
+//              C-order shape (..., K), output (...). Raw inputs need --k;
+//              for .npy inputs --k, if given, must equal K.
+//              The output is the accumulator rounded to FP16, or with
+//              --fp32 the accumulator itself as float32.
+// --out and --flags must not name either input: they are truncated before
+// the kernels read the inputs through their mappings.
+// Prints the element count, time and bandwidth over input + output bytes.
+
+int main(int argc, char** argv) {
+    std::string op, a_path, b_path, out_path, flags_path;
+    size_t k = 0;
+    Fp16Round round = FP16_ROUND_RNE;
+    bool fp32 = false, raw = false;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--op" && i + 1 < argc) op = argv[++i];
+        else if (arg == "--a" && i + 1 < argc) a_path = argv[++i];
+        else if (arg == "--b" && i + 1 < argc) b_path = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) out_path = argv[++i];
+        else if (arg == "--flags" && i + 1 < argc) flags_path = argv[++i];
+        else if (arg == "--k" && i + 1 < argc) k = std::stoull(argv[++i]);
+        else if (arg == "--round" && i + 1 < argc && fp16_round_mode(argv[i + 1], round)) ++i;
+        else if (arg == "--fp32") fp32 = true;
+        else if (arg == "--raw") raw = true;
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            op.clear();
+            break;
+        }
+    }
+    if ((op != "add" && op != "mul" && op != "mac") || a_path.empty() || b_path.empty() || out_path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --op add|mul|mac --a FILE --b FILE --out FILE [--flags FILE] [--k K]\n"
+                  << "       [--round rz|rne|ru|rd] [--fp32] [--raw] [--threads T]\n";
+        return 1;
+    }
+    bool mac = op == "mac";
+    if (!mac && fp32) {
+        std::cerr << "--fp32 only applies to --op mac\n";
+        return 1;
+    }
+    if (mac && !flags_path.empty()) {
+        std::cerr << "--flags only applies to --op add|mul (the MAC does not model flags)\n";
+        return 1;
+    }
+
+    Fp16Mapped ma, mb, mo, mf;
+    Fp16NpyArray aa, ab;
+    const fp16_t *a, *b;
+    if (!fp16_npy_open(a_path, ma, aa, a) || !fp16_npy_open(b_path, mb, ab, b)) return 1;
+    // Elements pair up in memory order: .npy operands must agree in shape
+    // and order (a raw file is a flat array and only needs the count).
+    bool raw_a = aa.descr == "raw", raw_b = ab.descr == "raw";
+    if (!raw_a && !raw_b && (aa.shape != ab.shape || aa.fortran != ab.fortran)) {
+        std::cerr << "Shapes or orders of --a and --b differ\n";
+        return 1;
+    }
+    if (aa.count() != ab.count()) {
+        std::cerr << "Element counts differ: " << aa.count() << " vs " << ab.count() << "\n";
+        return 1;
+    }
+    const size_t n = aa.count();
+
+    const Fp16NpyArray& like = raw_a ? ab : aa; // output shape and order
+    std::vector<size_t> shape = like.shape;
+    bool fortran = like.fortran;
+    size_t outputs = n;
+    if (mac) {
+        if (fortran) {
+            std::cerr << "--op mac needs C-order arrays\n";
+            return 1;
+        }
+        if (like.descr != "raw") {
+            size_t last = shape.empty() ? 1 : shape.back();
+            if (k && k != last) {
+                std::cerr << "--k " << k << " does not match the last axis (" << last << ") of the .npy inputs\n";
+                return 1;
+            }
+            k = last;
+        }
+        if (k == 0 || n % k) {
+            std::cerr << "Dot length K = " << k << " does not divide " << n << " elements"
+                      << (like.descr == "raw" ? " (raw inputs need --k)" : "") << "\n";
+            return 1;
+        }
+        outputs = n / k;
+        if (like.descr == "raw") shape = {outputs};
+        else if (!shape.empty()) shape.pop_back();
+    }
+    for (const std::string& o : {out_path, flags_path}) {
+        if (!o.empty() && (fp16_same_file(o, a_path) || fp16_same_file(o, b_path))) {
+            std::cerr << o << " is also an input; write the result to another file\n";
+            return 1;
+        }
+    }
+    void* out = fp16_npy_create(out_path, mo, fp32 ? "<f4" : "<f2", shape, raw, fortran);
+    uint8_t* flags_out = nullptr;
+    if (!out) return 1;
+    if (!flags_path.empty() && !(flags_out = (uint8_t*)fp16_npy_create(flags_path, mf, "|u1", shape, raw, fortran))) return 1;
+
+    Fp16Pool pool(threads ? threads : 1);
+    auto t0 = std::chrono::steady_clock::now();
+    // Flag counts (OF, Z, NaN, PL, UF) of add / mul
+    typedef std::array<uint64_t, 5> Counts;
+    Counts counts{};
+    if (!mac) {
+        Fp16BinaryKernel kernel = op == "add" ? fp16_add_simd : fp16_mul_simd;
+        fp16_t* res = (fp16_t*)out;
+        counts = pool.parallel_reduce<Counts>(0, n, FP16_POOL_GRAIN, Counts{},
+            [&](uint64_t lo, uint64_t hi, Counts& c) {
+                std::vector<uint8_t> scratch;
+                uint8_t* fl = flags_out ? flags_out + lo : (scratch.resize(hi - lo), scratch.data());
+                kernel(a + lo, b + lo, res + lo, fl, (size_t)(hi - lo));
+                for (uint64_t i = 0; i < hi - lo; ++i) {
+                    for (int f = 0; f < 5; ++f) c[f] += (fl[i] >> f) & 1;
+                }
+            },
+            [](Counts& x, const Counts& y) { for (int f = 0; f < 5; ++f) x[f] += y[f]; });
+    } else if (fp32) {
+        fp16_mac_dot_parallel(pool, round, a, b, k, outputs, (uint32_t*)out);
+    } else {
+        fp16_t* res = (fp16_t*)out;
+        uint64_t blocks = (outputs + FP16_MAC_LANES - 1) / FP16_MAC_LANES;
+        pool.parallel_for(0, blocks, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+            uint32_t acc[FP16_MAC_LANES];
+            for (uint64_t blk = lo; blk < hi; ++blk) {
+                size_t first = (size_t)blk * FP16_MAC_LANES;
+                size_t m = outputs - first < FP16_MAC_LANES ? outputs - first : FP16_MAC_LANES;
+                fp16_mac_dot_batch(round, a + first * k, b + first * k, k, m, acc);
+                for (size_t i = 0; i < m; ++i) {
+                    switch (round) {
+                    case FP16_ROUND_RNE: res[first + i] = (fp16_t)fp16_mac_to_fp16<FP16_ROUND_RNE>(acc[i]); break;
+                    case FP16_ROUND_RU:  res[first + i] = (fp16_t)fp16_mac_to_fp16<FP16_ROUND_RU>(acc[i]); break;
+                    case FP16_ROUND_RD:  res[first + i] = (fp16_t)fp16_mac_to_fp16<FP16_ROUND_RD>(acc[i]); break;
+                    default:             res[first + i] = (fp16_t)fp16_mac_to_fp16<FP16_ROUND_RZ>(acc[i]); break;
+                    }
+                }
+            }
+        });
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    double bytes = 4.0 * n + (double)mo.size() + (double)mf.size();
+    std::cout << "Wrote " << out_path << ": " << outputs << " " << (fp32 ? "float32" : "float16") << " outputs ("
+              << n << " " << op << " input pairs) in " << std::fixed << std::setprecision(3) << sec << " s, "
+              << std::setprecision(2) << (mac ? (double)n : (double)outputs) / sec / 1e6 << " M "
+              << (mac ? "MAC" : "op") << "/s, " << bytes / sec / 1e9 << " GB/s, " << pool.size() << " thread(s)\n";
+    if (!mac) {
+        std::cout << "Flags: OF " << counts[0] << ", Z " << counts[1] << ", NaN " << counts[2] << ", PL "
+                  << counts[3] << ", UF " << counts[4] << "\n";
+        if (flags_out) std::cout << "Flags written to " << flags_path << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_diff.h"
+#include "fp16_mul.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+#include "fp16_tree.h"
+#include "fp16_workload.h"
+
+// ----------------------------------------------------------------------------
+// Adder-Tree Shape Exploration on Layer Workloads
+// ----------------------------------------------------------------------------
+// Usage: fp16_tree [--width W] [--shape NAME|all] [--adder NAME] [--workload NAME|all]
+//                  [--rows M] [--latency L] [--seed S] [--threads T]
+//
+// Every row is W products a * w of one workload (fp16_workload.h, bit-true
+// multiplier) that a tree of --adder nodes (any adder model of fp16_diff,
+// default bittrue) reduces to one FP16 value. Per tree shape (fp16_tree.h)
+// it reports the adder levels, the pipeline latency at L cycles per adder
+// (default 2, fpadder.v), the adder count, the delay registers, the error
+// against the exact sum of the products (FP16 ULPs at the exact result),
+// the share of correctly rounded (RNE) rows and the model time per row.
+// Rows are generated in chunks seeded from (seed, workload, chunk), so
+// results are identical for any thread count.
+
+static const uint64_t CHUNK = 256;
+
+int main(int argc, char** argv) {
+    uint64_t seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t rows = 65536;
+    uint32_t width = 16, latency = 2;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string name = "all", shape_name = "all", adder_name = "bittrue";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--width" && i + 1 < argc) width = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--shape" && i + 1 < argc) shape_name = argv[++i];
+        else if (arg == "--adder" && i + 1 < argc) adder_name = argv[++i];
+        else if (arg == "--workload" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--rows" && i + 1 < argc) rows = std::stoull(argv[++i]);
+        else if (arg == "--latency" && i + 1 < argc) latency = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--width W] [--shape NAME|all] [--adder NAME] [--workload NAME|all]"
+                      << " [--rows M] [--latency L] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+    if (width == 0) {
+        std::cerr << "--width must be at least 1\n";
+        return 1;
+    }
+
+    std::vector<Fp16TreeShape> shapes;
+    Fp16TreeShape sh;
+    if (shape_name == "all") shapes = {FP16_TREE_LINEAR, FP16_TREE_PAIRWISE, FP16_TREE_WALLACE};
+    else if (fp16_tree_shape(shape_name, sh)) shapes = {sh};
+    else {
+        std::cerr << "Unknown shape: " << shape_name << " (available: linear pairwise wallace)\n";
+        return 1;
+    }
+
+    Fp16DiffModel adder;
+    if (!fp16_diff_model("add", adder_name, adder)) {
+        std::cerr << "Unknown adder: " << adder_name << " (available:";
+        for (const Fp16DiffModel& m : fp16_diff_models("add")) std::cerr << " " << m.name;
+        std::cerr << ")\n";
+        return 1;
+    }
+
+    size_t count;
+    const Fp16Workload* all = fp16_workloads(count);
+    std::vector<size_t> run;
+    if (!fp16_workload_select(name, run)) return 1;
+
+    Fp16Pool pool(threads ? threads : 1);
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << seed << std::dec << ", " << rows << " rows of " << width
+              << " products per workload, adder " << adder.name << " (" << latency << " cycles), " << pool.size()
+              << " thread(s)\n";
+
+    std::vector<Fp16Tree> trees;
+    for (Fp16TreeShape s : shapes) trees.push_back(fp16_tree_build(s, width));
+
+    std::vector<fp16_t> prod(rows * width), out(rows);
+    std::vector<double> exact(rows);
+    for (size_t wi : run) {
+        Fp16Workload wl = all[wi];
+        wl.k = width;
+        uint64_t chunks = (rows + CHUNK - 1) / CHUNK;
+        std::vector<std::vector<fp16_t>> a(pool.size()), w(pool.size());
+        std::vector<std::vector<uint8_t>> fl(pool.size());
+        pool.parallel_for(0, chunks, 1, [&](uint64_t lo, uint64_t hi, unsigned t) {
+            a[t].resize(width); w[t].resize(width); fl[t].resize(width);
+            for (uint64_t c = lo; c < hi; ++c) {
+                Xoshiro256 g(fp16_rng_chunk_seed(seed ^ fp16_mix64(wi + 1), c));
+                uint64_t end = (c + 1) * CHUNK < rows ? (c + 1) * CHUNK : rows;
+                for (uint64_t r = c * CHUNK; r < end; ++r) {
+                    fp16_t* p = prod.data() + r * width;
+                    fp16_workload_fill(wl, g, a[t].data(), w[t].data());
+                    fp16_mul_batch(a[t].data(), w[t].data(), p, fl[t].data(), width);
+                    double sum = 0;
+                    for (uint32_t j = 0; j < width; ++j) sum += fp16_oracle_to_double(p[j]);
+                    exact[r] = sum;
+                }
+            }
+        });
+
+        std::cout << "--------------------------------------------------------------------------------------------------\n"
+                  << " " << wl.name << ": " << wl.what << "\n"
+                  << "--------------------------------------------------------------------------------------------------\n"
+                  << "  Shape    | Depth | Cycles | Adders | Delay regs | Mean rel err | Max rel err | Mean |ULP| |    CR % | ns / row\n"
+                  << "--------------------------------------------------------------------------------------------------\n";
+        for (const Fp16Tree& tree : trees) {
+            auto t0 = std::chrono::steady_clock::now();
+            fp16_tree_reduce_parallel(pool, tree, adder.kernel, prod.data(), rows, out.data());
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+            Fp16WorkloadScore s;
+            for (uint64_t r = 0; r < rows; ++r) fp16_workload_score(s, out[r], exact[r]);
+            std::cout << "  " << std::left << std::setw(8) << fp16_tree_shape_name(tree.shape) << std::right << " | "
+                      << std::setw(5) << tree.depth << " | " << std::setw(6) << tree.depth * latency << " | "
+                      << std::setw(6) << tree.nodes.size() << " | " << std::setw(10) << tree.delay_regs(latency)
+                      << " | " << std::scientific << std::setprecision(4) << std::setw(12)
+                      << s.mean_rel() << " | " << std::setw(11) << s.max_rel << " | " << std::fixed << std::setw(10)
+                      << s.mean_ulp() << " | " << std::setprecision(2) << std::setw(7) << s.cr_percent() << " | "
+                      << std::setw(8) << ns / rows << "\n";
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------\n";
+    return 0;
+}
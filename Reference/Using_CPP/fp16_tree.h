@@ -0,0 +1,152 @@
+#ifndef FP16_TREE_H
+#define FP16_TREE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// Adder-Tree Reduction
+// ----------------------------------------------------------------------------
+// Reduces W values per cycle with a tree of W - 1 two-input FP16 adders, as
+// a MAC that sums W products per cycle would. The tree shape fixes the
+// association order:
+//   linear   : ((x0 + x1) + x2) + ...     (unrolled serial accumulator)
+//   pairwise : sum(x[0, h)) + sum(x[h, W)), h = ceil(W / 2), recursively
+//   wallace  : level by level, adjacent pairs are added and an odd
+//              leftover joins the front of the next level (Wallace / Dadda
+//              style scheduling)
+// For W a power of two pairwise and wallace build the same tree.
+//
+// Every node runs the same adder, any Fp16BinaryKernel (fp16_add_batch,
+// fp16_add_simd, fpadder_rtl_batch, an oracle mode, ...). Rows are reduced
+// in blocks of FP16_TREE_LANES, one kernel call per node, so the per-node
+// work is the adder's own batch / SIMD loop.
+//
+// Latency model for a fully pipelined tree of adders with L cycles each:
+// the result is ready after depth * L cycles, and an operand that skips
+// levels on its way to a node needs L 16-bit delay registers per level.
+
+enum Fp16TreeShape { FP16_TREE_LINEAR, FP16_TREE_PAIRWISE, FP16_TREE_WALLACE };
+
+inline const char* fp16_tree_shape_name(Fp16TreeShape s) {
+    static const char* n[] = {"linear", "pairwise", "wallace"};
+    return n[s];
+}
+
+inline bool fp16_tree_shape(const std::string& name, Fp16TreeShape& out) {
+    for (int s = FP16_TREE_LINEAR; s <= FP16_TREE_WALLACE; ++s) {
+        if (name == fp16_tree_shape_name((Fp16TreeShape)s)) { out = (Fp16TreeShape)s; return true; }
+    }
+    return false;
+}
+
+// Node: slot dst = slot a + slot b. Slots 0 .. W-1 are the inputs, node i
+// writes slot W + i, and nodes are stored in evaluation order.
+struct Fp16TreeNode {
+    uint32_t a, b, dst, level;
+};
+
+struct Fp16Tree {
+    Fp16TreeShape shape = FP16_TREE_PAIRWISE;
+    uint32_t width = 0;
+    uint32_t out = 0;   // result slot
+    uint32_t depth = 0; // adder levels on the longest path
+    std::vector<Fp16TreeNode> nodes;
+    std::vector<uint32_t> level; // level at which each slot is ready (inputs: 0)
+
+    uint32_t slots() const { return (uint32_t)level.size(); }
+
+    uint32_t add(uint32_t a, uint32_t b) {
+        uint32_t l = (level[a] > level[b] ? level[a] : level[b]) + 1;
+        uint32_t dst = slots();
+        nodes.push_back({a, b, dst, l});
+        level.push_back(l);
+        if (l > depth) depth = l;
+        return dst;
+    }
+
+    // 16-bit registers that hold operands skipping levels, at L cycles per
+    // adder.
+    uint64_t delay_regs(uint32_t latency) const {
+        uint64_t r = 0;
+        for (const Fp16TreeNode& n : nodes) r += (uint64_t)(2 * (n.level - 1) - level[n.a] - level[n.b]) * latency;
+        return r;
+    }
+};
+
+inline uint32_t fp16_tree_pairwise(Fp16Tree& t, uint32_t lo, uint32_t hi) {
+    if (hi - lo == 1) return lo;
+    uint32_t mid = lo + (hi - lo + 1) / 2;
+    uint32_t a = fp16_tree_pairwise(t, lo, mid);
+    uint32_t b = fp16_tree_pairwise(t, mid, hi);
+    return t.add(a, b);
+}
+
+// width must be at least 1.
+inline Fp16Tree fp16_tree_build(Fp16TreeShape shape, uint32_t width) {
+    Fp16Tree t;
+    t.shape = shape;
+    t.width = width;
+    t.level.assign(width, 0);
+    if (shape == FP16_TREE_LINEAR) {
+        t.out = 0;
+        for (uint32_t j = 1; j < width; ++j) t.out = t.add(t.out, j);
+    } else if (shape == FP16_TREE_PAIRWISE) {
+        t.out = fp16_tree_pairwise(t, 0, width);
+    } else {
+        std::vector<uint32_t> cur(width), next;
+        for (uint32_t j = 0; j < width; ++j) cur[j] = j;
+        while (cur.size() > 1) {
+            next.clear();
+            if (cur.size() & 1) next.push_back(cur.back());
+            for (size_t i = 0; i + 1 < cur.size(); i += 2) next.push_back(t.add(cur[i], cur[i + 1]));
+            cur.swap(next);
+        }
+        t.out = cur[0];
+    }
+    return t;
+}
+
+// ----------------------------------------------------------------------------
+// Batch Reduction
+// ----------------------------------------------------------------------------
+static const size_t FP16_TREE_LANES = 256; // rows per block
+
+// n rows of t.width values: out[i] = tree(x + i * t.width), every node
+// evaluated with add.
+inline void fp16_tree_reduce(const Fp16Tree& t, Fp16BinaryKernel add, const fp16_t* x, size_t n, fp16_t* out) {
+    const size_t L = FP16_TREE_LANES;
+    const uint32_t w = t.width;
+    std::vector<fp16_t> buf((size_t)t.slots() * L);
+    std::vector<uint8_t> flags(L);
+    for (size_t i0 = 0; i0 < n; i0 += L) {
+        size_t m = n - i0 < L ? n - i0 : L;
+        for (size_t i = 0; i < m; ++i) {
+            const fp16_t* row = x + (i0 + i) * w;
+            for (uint32_t j = 0; j < w; ++j) buf[j * L + i] = row[j];
+        }
+        for (const Fp16TreeNode& nd : t.nodes) {
+            add(&buf[nd.a * L], &buf[nd.b * L], &buf[nd.dst * L], flags.data(), m);
+        }
+        for (size_t i = 0; i < m; ++i) out[i0 + i] = buf[t.out * L + i];
+    }
+}
+
+// fp16_tree_reduce over n rows in blocks of FP16_TREE_LANES on a
+// work-stealing pool.
+inline void fp16_tree_reduce_parallel(Fp16Pool& pool, const Fp16Tree& t, Fp16BinaryKernel add, const fp16_t* x,
+                                      size_t n, fp16_t* out) {
+    uint64_t blocks = (n + FP16_TREE_LANES - 1) / FP16_TREE_LANES;
+    pool.parallel_for(0, blocks, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        size_t first = (size_t)lo * FP16_TREE_LANES;
+        size_t last = (size_t)hi * FP16_TREE_LANES < n ? (size_t)hi * FP16_TREE_LANES : n;
+        fp16_tree_reduce(t, add, x + first * t.width, last - first, out + first);
+    });
+}
+
+#endif // FP16_TREE_H
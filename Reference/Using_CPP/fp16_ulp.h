@@ -0,0 +1,266 @@
+#ifndef FP16_ULP_H
+#define FP16_ULP_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+
+// ----------------------------------------------------------------------------
+// ULP / Relative Error Analysis
+// ----------------------------------------------------------------------------
+// Measures how far a model's results are from the exact sum or product. For
+// every operand pair with finite operands and a finite exact result x
+// (computed exactly in double, see fp16_oracle.h) and a finite HW result h:
+//   ulp error      u = (h - x) / ulp(x), ulp(x) = 2^(max(e(x), -14) - 10)
+//   relative error r = (h - x) / x        (x != 0)
+// Both are signed in the direction of |x|: negative means the result is
+// smaller in magnitude than the exact value, so a truncating datapath shows
+// a negative bias. Errors are binned into |u| and |r| histograms and
+// summarized per exponent region of x and per operand class pair. Pairs
+// with NaN/Inf operands, exact results beyond the FP16 range (|x| > 65504)
+// and non-finite HW results for an in-range x (overflow) are counted
+// separately and not measured.
+//
+// The full 2^32 space is split into one task per operand row a; workers
+// keep their own Fp16UlpAnalysis and the parts are merged at the end.
+
+enum {
+    FP16_ULP_BINS = 15,      // 0, (0, 0.5), [0.5, 1), [1, 2), ..., >= 2048
+    FP16_REL_BINS = 32,      // 0, >= 1, [2^-k, 2^-k+1) for k = 1..29, < 2^-29
+    FP16_ULP_REGIONS = 32,   // zero, denormal, 2^-14 .. 2^15
+    FP16_ULP_CLASSES = 12    // operand class pairs (x2 for effective subtraction)
+};
+
+enum Fp16UlpOp { FP16_ULP_ADD, FP16_ULP_MUL };
+
+struct Fp16ErrorStats {
+    uint64_t count = 0, exact = 0, rel_count = 0;
+    double sum_ulp = 0, sum_abs_ulp = 0, max_abs_ulp = 0;
+    double sum_rel = 0, max_abs_rel = 0;
+
+    void add(double u, double r, bool has_rel) {
+        double au = std::fabs(u);
+        count++;
+        exact += (u == 0);
+        sum_ulp += u;
+        sum_abs_ulp += au;
+        if (au > max_abs_ulp) max_abs_ulp = au;
+        if (has_rel) {
+            rel_count++;
+            sum_rel += r;
+            if (std::fabs(r) > max_abs_rel) max_abs_rel = std::fabs(r);
+        }
+    }
+
+    void merge(const Fp16ErrorStats& o) {
+        count += o.count; exact += o.exact; rel_count += o.rel_count;
+        sum_ulp += o.sum_ulp; sum_abs_ulp += o.sum_abs_ulp;
+        sum_rel += o.sum_rel;
+        if (o.max_abs_ulp > max_abs_ulp) max_abs_ulp = o.max_abs_ulp;
+        if (o.max_abs_rel > max_abs_rel) max_abs_rel = o.max_abs_rel;
+    }
+};
+
+struct Fp16UlpAnalysis {
+    uint64_t pairs = 0;     // pairs visited
+    uint64_t special = 0;   // NaN/Inf operand or non-finite exact result
+    uint64_t range = 0;     // |exact| > 65504
+    uint64_t overflow = 0;  // finite exact result, HW returned Inf/NaN
+    Fp16ErrorStats total;
+    Fp16ErrorStats region[FP16_ULP_REGIONS];
+    Fp16ErrorStats cls[FP16_ULP_CLASSES];
+    uint64_t ulp_hist[FP16_ULP_BINS] = {0};
+    uint64_t rel_hist[FP16_REL_BINS] = {0};
+
+    void merge(const Fp16UlpAnalysis& o) {
+        pairs += o.pairs; special += o.special; range += o.range; overflow += o.overflow;
+        total.merge(o.total);
+        for (int k = 0; k < FP16_ULP_REGIONS; ++k) region[k].merge(o.region[k]);
+        for (int k = 0; k < FP16_ULP_CLASSES; ++k) cls[k].merge(o.cls[k]);
+        for (int k = 0; k < FP16_ULP_BINS; ++k) ulp_hist[k] += o.ulp_hist[k];
+        for (int k = 0; k < FP16_REL_BINS; ++k) rel_hist[k] += o.rel_hist[k];
+    }
+};
+
+inline int fp16_ulp_exp(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, 8);
+    return (int)((bits >> 52) & 0x7FF) - 1023;
+}
+
+inline int fp16_ulp_bin(double au) {
+    if (au == 0) return 0;
+    int e = fp16_ulp_exp(au) + 3;
+    return e < 1 ? 1 : (e > FP16_ULP_BINS - 1 ? FP16_ULP_BINS - 1 : e);
+}
+
+inline int fp16_rel_bin(double ar) {
+    if (ar == 0) return 0;
+    int k = -fp16_ulp_exp(ar);
+    return 1 + (k < 0 ? 0 : (k > FP16_REL_BINS - 2 ? FP16_REL_BINS - 2 : k));
+}
+
+inline int fp16_ulp_region(double x) {
+    if (x == 0) return 0;
+    int e = fp16_ulp_exp(std::fabs(x));
+    return e < -14 ? 1 : e + 16;
+}
+
+// 0 zero, 1 denormal, 2 normal (finite operands only).
+inline int fp16_ulp_operand_class(fp16_t h) {
+    if ((h & 0x7FFF) == 0) return 0;
+    return (h & 0x7C00) ? 2 : 1;
+}
+
+inline int fp16_ulp_class(Fp16UlpOp op, fp16_t a, fp16_t b) {
+    static const int pair[3][3] = {{5, 4, 2}, {4, 3, 1}, {2, 1, 0}};
+    int c = pair[fp16_ulp_operand_class(a)][fp16_ulp_operand_class(b)];
+    return (op == FP16_ULP_ADD && ((a ^ b) & 0x8000)) ? c + 6 : c;
+}
+
+inline const char* fp16_ulp_class_name(Fp16UlpOp op, int c) {
+    static const char* add[FP16_ULP_CLASSES] = {
+        "norm+norm", "norm+den", "norm+zero", "den+den", "den+zero", "zero+zero",
+        "norm-norm", "norm-den", "norm-zero", "den-den", "den-zero", "zero-zero"};
+    static const char* mul[FP16_ULP_CLASSES] = {
+        "norm*norm", "norm*den", "norm*zero", "den*den", "den*zero", "zero*zero",
+        "", "", "", "", "", ""};
+    return op == FP16_ULP_ADD ? add[c] : mul[c];
+}
+
+// Row a against every b. dtab maps each FP16 pattern to its exact double.
+inline void fp16_ulp_row(Fp16UlpOp op, Fp16BinaryKernel kernel, fp16_t a, const double* dtab,
+                         const fp16_t* b, fp16_t* arow, fp16_t* res, uint8_t* flags, Fp16UlpAnalysis& s) {
+    for (uint32_t j = 0; j < 65536; ++j) arow[j] = a;
+    kernel(arow, b, res, flags, 65536);
+    s.pairs += 65536;
+
+    double da = dtab[a];
+    for (uint32_t j = 0; j < 65536; ++j) {
+        double x = (op == FP16_ULP_ADD) ? da + dtab[j] : da * dtab[j];
+        if (!std::isfinite(x) || !std::isfinite(da) || !std::isfinite(dtab[j])) { s.special++; continue; }
+        if (std::fabs(x) > 65504.0) { s.range++; continue; }
+        double h = dtab[res[j]];
+        if (!std::isfinite(h)) { s.overflow++; continue; }
+
+        int e = fp16_ulp_exp(x);
+        if (x == 0 || e < -14) e = -14;
+        double u = std::ldexp(h - x, 10 - e);
+        double r = 0;
+        if (x < 0) u = -u;
+        else if (x == 0) u = std::fabs(u);
+        if (x != 0) r = (h - x) / x;
+
+        s.total.add(u, r, x != 0);
+        s.region[fp16_ulp_region(x)].add(u, r, x != 0);
+        s.cls[fp16_ulp_class(op, a, (fp16_t)j)].add(u, r, x != 0);
+        s.ulp_hist[fp16_ulp_bin(std::fabs(u))]++;
+        if (x != 0) s.rel_hist[fp16_rel_bin(std::fabs(r))]++;
+    }
+}
+
+// Every row a with a % step == 0 (step 1 covers all 2^32 pairs).
+inline Fp16UlpAnalysis fp16_ulp_analyze(Fp16Pool& pool, Fp16UlpOp op, Fp16BinaryKernel kernel, uint32_t step) {
+    std::vector<double> dtab(65536);
+    std::vector<fp16_t> b(65536);
+    for (uint32_t i = 0; i < 65536; ++i) {
+        dtab[i] = fp16_oracle_to_double(i);
+        b[i] = (fp16_t)i;
+    }
+    if (step == 0) step = 1;
+    uint64_t rows = (65536 + step - 1) / step;
+
+    std::vector<Fp16UlpAnalysis> part(pool.size());
+    std::vector<std::vector<fp16_t>> arow(pool.size()), res(pool.size());
+    std::vector<std::vector<uint8_t>> flags(pool.size());
+    pool.parallel_for(0, rows, 1, [&](uint64_t lo, uint64_t hi, unsigned t) {
+        arow[t].resize(65536); res[t].resize(65536); flags[t].resize(65536);
+        for (uint64_t r = lo; r < hi; ++r) {
+            fp16_ulp_row(op, kernel, (fp16_t)(r * step), dtab.data(), b.data(), arow[t].data(),
+                         res[t].data(), flags[t].data(), part[t]);
+        }
+    });
+
+    Fp16UlpAnalysis total;
+    for (const Fp16UlpAnalysis& p : part) total.merge(p);
+    return total;
+}
+
+inline void fp16_ulp_stats_row(std::ostream& os, const char* name, const Fp16ErrorStats& s) {
+    os << "  " << std::left << std::setw(12) << name << std::right << " | " << std::setw(11) << s.count
+       << " | " << std::fixed << std::setprecision(2) << std::setw(7) << 100.0 * s.exact / s.count
+       << " | " << std::setprecision(4) << std::setw(10) << s.sum_abs_ulp / s.count
+       << " | " << std::setw(9) << s.sum_ulp / s.count
+       << " | " << std::setw(10) << s.max_abs_ulp
+       << " | " << std::scientific << std::setprecision(3) << std::setw(10)
+       << (s.rel_count ? s.sum_rel / s.rel_count : 0.0) << "\n";
+}
+
+inline void fp16_ulp_report(std::ostream& os, const Fp16UlpAnalysis& s, Fp16UlpOp op, const char* model) {
+    std::ios saved(nullptr);
+    saved.copyfmt(os);
+    const char* rule = "--------------------------------------------------------------------------------------------------\n";
+    const char* head = "               |       Count | Exact % | Mean |ULP| |  Bias ULP |  Max |ULP| |   Bias rel\n";
+    const Fp16ErrorStats& t = s.total;
+    uint64_t n = t.count ? t.count : 1;
+
+    os << std::dec << std::setfill(' ');
+    os << rule << " ULP Error: " << model << (op == FP16_ULP_ADD ? " add" : " mul") << " vs exact ("
+       << s.pairs << " pairs)\n" << rule;
+    os << "  Measured   : " << t.count << " (skipped " << s.special << " NaN/Inf, " << s.range
+       << " exact beyond 65504, " << s.overflow << " HW Inf/NaN for an in-range result)\n";
+    os << std::fixed << std::setprecision(4);
+    os << "  Exact      : " << t.exact << " (" << 100.0 * t.exact / n << " %)\n";
+    os << "  Mean |ULP| : " << t.sum_abs_ulp / n << ", max " << t.max_abs_ulp << "\n";
+    os << "  Bias       : " << std::showpos << t.sum_ulp / n << std::noshowpos
+       << " ULP (negative = toward zero), relative " << std::scientific << std::setprecision(3)
+       << (t.rel_count ? t.sum_rel / t.rel_count : 0.0) << "\n";
+
+    os << rule << "  |ULP error|      |       Count |      %\n" << rule;
+    static const char* ulp_label[FP16_ULP_BINS] = {
+        "0", "(0, 0.5)", "[0.5, 1)", "[1, 2)", "[2, 4)", "[4, 8)", "[8, 16)", "[16, 32)", "[32, 64)",
+        "[64, 128)", "[128, 256)", "[256, 512)", "[512, 1024)", "[1024, 2048)", ">= 2048"};
+    for (int k = 0; k < FP16_ULP_BINS; ++k) {
+        if (!s.ulp_hist[k]) continue;
+        os << "  " << std::left << std::setw(16) << ulp_label[k] << std::right << " | " << std::setw(11)
+           << s.ulp_hist[k] << " | " << std::fixed << std::setprecision(4) << std::setw(8)
+           << 100.0 * s.ulp_hist[k] / n << "\n";
+    }
+
+    os << rule << "  |Relative error| |       Count |      %\n" << rule;
+    uint64_t nr = t.rel_count ? t.rel_count : 1;
+    for (int k = 0; k < FP16_REL_BINS; ++k) {
+        if (!s.rel_hist[k]) continue;
+        std::string label = k == 0 ? "0" : k == 1 ? ">= 1"
+                          : k == FP16_REL_BINS - 1 ? "< 2^-" + std::to_string(k - 2)
+                          : "[2^-" + std::to_string(k - 1) + ", 2^-" + std::to_string(k - 2) + ")";
+        if (k == 2) label = "[2^-1, 1)";
+        os << "  " << std::left << std::setw(16) << label << std::right << " | " << std::setw(11)
+           << s.rel_hist[k] << " | " << std::fixed << std::setprecision(4) << std::setw(8)
+           << 100.0 * s.rel_hist[k] / nr << "\n";
+    }
+
+    os << rule << "  Exact region" << (head + 14) << rule;
+    for (int k = 0; k < FP16_ULP_REGIONS; ++k) {
+        if (!s.region[k].count) continue;
+        std::string name = k == 0 ? "zero" : k == 1 ? "denormal" : "2^" + std::to_string(k - 16);
+        fp16_ulp_stats_row(os, name.c_str(), s.region[k]);
+    }
+
+    os << rule << "  Operands    " << (head + 14) << rule;
+    for (int k = 0; k < FP16_ULP_CLASSES; ++k) {
+        if (s.cls[k].count) fp16_ulp_stats_row(os, fp16_ulp_class_name(op, k), s.cls[k]);
+    }
+    os << rule;
+    os.copyfmt(saved);
+}
+
+#endif // FP16_ULP_H
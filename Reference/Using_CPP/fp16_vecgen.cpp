@@ -0,0 +1,203 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include "fp16_adder.h"
+#include "fp16_mul.h"
+#include "fp16_pool.h"
+#include "fp16_report.h"
+#include "fp16_stimulus.h"
+#include "fpadder_rtl.h"
+
+// ----------------------------------------------------------------------------
+// Stimulus / Expected-Result File Generator for RTL Testbenches
+// ----------------------------------------------------------------------------
+// Usage: fp16_vecgen [--out PREFIX] [--vectors N] [--shards K] [--format hex|bin]
+//                    [--op add|mul] [--model bittrue|rtl] [--stim PRESET]
+//                    [--seed S] [--threads T]
+//
+// Writes, for every shard k, PREFIX_k.stim.<ext> and PREFIX_k.exp.<ext> with
+// one 32-bit word per vector:
+//   hex (ext "hex", $readmemh / $fscanf("%h"), one word per line)
+//     stim : {a[15:0], b[15:0]}            e.g. C0B01CC0
+//     exp  : {8'h00, flags[7:0], res[15:0]} e.g. 0008C0AE
+//   bin (ext "bin", $fread; little-endian, the --filter record format)
+//     stim : bytes a[7:0] a[15:8] b[7:0] b[15:8]
+//     exp  : bytes res[7:0] res[15:8] flags 0
+// flags uses the FP16_FLAG_* bits (OF=1, Z=2, NaN=4, PL=8, UF=16).
+//
+// Vectors come from fp16_stimulus.h in chunks of CHUNK; chunk c is seeded
+// from fp16_rng_chunk_seed(seed, c) and shard k holds a contiguous run of
+// chunks, so concatenating the shards gives the same vector sequence for
+// any shard or thread count. Shards are written in parallel on the
+// work-stealing pool (use at least as many shards as threads).
+//
+// --model rtl (adder only) takes the expected values from fpadder_rtl.h, the
+// signal-level translation of fpadder.v, so an RTL regression passes with
+// zero mismatches; --model bittrue uses fp16_add_simd / fp16_mul_simd.
+
+static const size_t CHUNK = 1 << 16;
+
+struct VecgenConfig {
+    std::string prefix = "fpadder";
+    bool hex = true;
+    bool mul = false;
+    bool rtl = false;
+    uint64_t seed = 0;
+    uint64_t vectors = 1 << 20;
+    Fp16StimWeights weights;
+};
+
+struct ShardBuffers {
+    std::vector<fp16_t> a, b, res;
+    std::vector<uint8_t> flags;
+    std::vector<char> stim, exp;
+
+    ShardBuffers() : a(CHUNK), b(CHUNK), res(CHUNK), flags(CHUNK), stim(CHUNK * 9), exp(CHUNK * 9) {}
+};
+
+static inline char* put_hex4(char* p, uint32_t v) {
+    std::memcpy(p, FP16_HEX_TABLE.d[(v >> 8) & 0xFF], 2);
+    std::memcpy(p + 2, FP16_HEX_TABLE.d[v & 0xFF], 2);
+    return p + 4;
+}
+
+static inline char* put_le16(char* p, uint32_t v) {
+    p[0] = (char)(v & 0xFF);
+    p[1] = (char)(v >> 8);
+    return p + 2;
+}
+
+// Generates chunk c (m vectors) and appends it to both files.
+static bool write_chunk(const VecgenConfig& cfg, uint64_t c, size_t m, ShardBuffers& buf,
+                        std::FILE* fs, std::FILE* fe) {
+    Fp16Stimulus stim(fp16_rng_chunk_seed(cfg.seed, c), cfg.weights);
+    stim.fill(buf.a.data(), buf.b.data(), m);
+
+    if (cfg.rtl) {
+        for (size_t i = 0; i < m; ++i) {
+            BitTrueResult r = fpadder_rtl(buf.a[i], buf.b[i]);
+            buf.res[i] = r.res;
+            buf.flags[i] = pack_flags(r);
+        }
+    } else if (cfg.mul) {
+        fp16_mul_simd(buf.a.data(), buf.b.data(), buf.res.data(), buf.flags.data(), m);
+    } else {
+        fp16_add_simd(buf.a.data(), buf.b.data(), buf.res.data(), buf.flags.data(), m);
+    }
+
+    char* ps = buf.stim.data();
+    char* pe = buf.exp.data();
+    for (size_t i = 0; i < m; ++i) {
+        if (cfg.hex) {
+            ps = put_hex4(put_hex4(ps, buf.a[i]), buf.b[i]);
+            *ps++ = '\n';
+            *pe++ = '0'; *pe++ = '0';
+            std::memcpy(pe, FP16_HEX_TABLE.d[buf.flags[i]], 2);
+            pe = put_hex4(pe + 2, buf.res[i]);
+            *pe++ = '\n';
+        } else {
+            ps = put_le16(put_le16(ps, buf.a[i]), buf.b[i]);
+            pe = put_le16(pe, buf.res[i]);
+            *pe++ = (char)buf.flags[i];
+            *pe++ = 0;
+        }
+    }
+    size_t ns = (size_t)(ps - buf.stim.data()), ne = (size_t)(pe - buf.exp.data());
+    return std::fwrite(buf.stim.data(), 1, ns, fs) == ns && std::fwrite(buf.exp.data(), 1, ne, fe) == ne;
+}
+
+// ----------------------------------------------------------------------------
+// Main: Vector Generation
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    VecgenConfig cfg;
+    cfg.seed = ((uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    uint64_t shards = 1;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string stim_name, model = "bittrue", op = "add", format = "hex";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) cfg.prefix = argv[++i];
+        else if (arg == "--vectors" && i + 1 < argc) cfg.vectors = std::stoull(argv[++i]);
+        else if (arg == "--shards" && i + 1 < argc) shards = std::stoull(argv[++i]);
+        else if (arg == "--format" && i + 1 < argc) format = argv[++i];
+        else if (arg == "--op" && i + 1 < argc) op = argv[++i];
+        else if (arg == "--model" && i + 1 < argc) model = argv[++i];
+        else if (arg == "--stim" && i + 1 < argc) stim_name = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) cfg.seed = std::stoull(argv[++i], nullptr, 0);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--out PREFIX] [--vectors N] [--shards K] [--format hex|bin]\n"
+                      << "       [--op add|mul] [--model bittrue|rtl] [--stim PRESET] [--seed S] [--threads T]\n";
+            return 1;
+        }
+    }
+    if ((format != "hex" && format != "bin") || (op != "add" && op != "mul") ||
+        (model != "bittrue" && model != "rtl")) {
+        std::cerr << "Invalid --format, --op or --model\n";
+        return 1;
+    }
+    cfg.hex = format == "hex";
+    cfg.mul = op == "mul";
+    cfg.rtl = model == "rtl";
+    if (cfg.mul && cfg.rtl) {
+        std::cerr << "--model rtl is only available for --op add (fpadder.v)\n";
+        return 1;
+    }
+    if (stim_name.empty()) stim_name = op;
+    if (!fp16_stim_weights(stim_name, cfg.weights)) {
+        std::cerr << "Unknown stimulus preset: " << stim_name << "\n";
+        return 1;
+    }
+
+    uint64_t chunks = (cfg.vectors + CHUNK - 1) / CHUNK;
+    if (shards == 0) shards = 1;
+    if (shards > chunks && chunks) shards = chunks;
+
+    Fp16Pool pool(threads ? threads : 1);
+    std::vector<ShardBuffers> buf(pool.size());
+    std::vector<uint64_t> shard_vectors(shards, 0);
+    std::vector<int> shard_ok(shards, 1);
+    auto name = [&](uint64_t k, const char* kind) {
+        return cfg.prefix + "_" + std::to_string(k) + "." + kind + "." + format;
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallel_for(0, shards, 1, [&](uint64_t lo, uint64_t hi, unsigned w) {
+        for (uint64_t k = lo; k < hi; ++k) {
+            std::FILE* fs = std::fopen(name(k, "stim").c_str(), "wb");
+            std::FILE* fe = std::fopen(name(k, "exp").c_str(), "wb");
+            bool ok = fs && fe;
+            for (uint64_t c = chunks * k / shards; ok && c < chunks * (k + 1) / shards; ++c) {
+                uint64_t left = cfg.vectors - c * CHUNK;
+                size_t m = (left < CHUNK) ? (size_t)left : CHUNK;
+                ok = write_chunk(cfg, c, m, buf[w], fs, fe);
+                shard_vectors[k] += m;
+            }
+            if (fs && std::fclose(fs) != 0) ok = false;
+            if (fe && std::fclose(fe) != 0) ok = false;
+            shard_ok[k] = ok;
+        }
+    });
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    int failed = 0;
+    std::cout << "Seed: 0x" << std::hex << std::uppercase << cfg.seed << std::dec << ", op " << op
+              << ", model " << model << ", stim " << stim_name << ", " << cfg.vectors << " vectors in "
+              << shards << " shard(s), " << std::fixed << std::setprecision(2) << sec << " s\n";
+    for (uint64_t k = 0; k < shards; ++k) {
+        std::cout << "  " << name(k, "stim") << ", " << name(k, "exp") << " : " << shard_vectors[k]
+                  << " vectors" << (shard_ok[k] ? "" : "  [WRITE FAILED]") << "\n";
+        failed += !shard_ok[k];
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+#ifndef FP16_WORKLOAD_H
+#define FP16_WORKLOAD_H
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "fp16_common.h"
+#include "fp16_oracle.h"
+#include "fp16_pool.h"
+#include "fp16_rng.h"
+
+// ----------------------------------------------------------------------------
+// Synthetic Layer Workloads
+// ----------------------------------------------------------------------------
+// Operand distributions of typical MAC workloads: every output is a dot
+// product of K activation / weight pairs drawn as
+//   activation : N(0, act_sigma), optionally through ReLU
+//   weight     : N(0, w_sigma)
+// and rounded to FP16 with RNE (fp16_oracle_round). The small-sigma presets
+// put a large share of operands and products into the FP16 denormal range
+// (below 2^-14 = 6.1e-5), which is where FTZ/DAZ and truncation differ.
+
+struct Fp16Workload {
+    const char* name;
+    uint32_t k;          // dot-product length
+    double act_sigma;
+    bool act_relu;
+    double w_sigma;
+    const char* what;
+};
+
+inline const Fp16Workload* fp16_workloads(size_t& count) {
+    static const Fp16Workload w[] = {
+        {"fc",     1024, 1.0,  true,  0.02, "fully connected, ReLU activations"},
+        {"conv",    576, 0.5,  true,  0.05, "3x3x64 convolution window"},
+        {"attn",     64, 1.0,  false, 1.0,  "attention scores q.k"},
+        {"lowact",  512, 1e-3, false, 0.01, "small activations (late layers, LayerNorm-free)"},
+        {"grad",    256, 1.0,  true,  1e-4, "weight gradient, activations x errors"},
+    };
+    count = sizeof(w) / sizeof(w[0]);
+    return w;
+}
+
+inline bool fp16_workload(const std::string& name, Fp16Workload& out) {
+    size_t n;
+    const Fp16Workload* w = fp16_workloads(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (name == w[i].name) { out = w[i]; return true; }
+    }
+    return false;
+}
+
+// Reports an unknown --workload name with the available ones on std::cerr.
+inline void fp16_workload_unknown(const std::string& name) {
+    size_t n;
+    const Fp16Workload* w = fp16_workloads(n);
+    std::cerr << "Unknown workload: " << name << " (available:";
+    for (size_t i = 0; i < n; ++i) std::cerr << " " << w[i].name;
+    std::cerr << ")\n";
+}
+
+// Registry indices selected by a --workload NAME|all argument, in registry
+// order; the index also selects a workload's seed stream, so a workload
+// draws the same operands whether run alone or with "all". Reports an
+// unknown name (fp16_workload_unknown) and returns false.
+inline bool fp16_workload_select(const std::string& name, std::vector<size_t>& run) {
+    size_t n;
+    const Fp16Workload* w = fp16_workloads(n);
+    run.clear();
+    for (size_t i = 0; i < n; ++i) {
+        if (name == "all" || name == w[i].name) run.push_back(i);
+    }
+    if (run.empty()) {
+        fp16_workload_unknown(name);
+        return false;
+    }
+    return true;
+}
+
+// Standard normal sample (Box-Muller, one value per call).
+inline double fp16_gaussian(Xoshiro256& g) {
+    double u1 = ((g() >> 11) + 1) * 0x1.0p-53; // (0, 1]
+    double u2 = (g() >> 11) * 0x1.0p-53;
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+// One output's operands: act[k], w[k] for k < wl.k.
+inline void fp16_workload_fill(const Fp16Workload& wl, Xoshiro256& g, fp16_t* act, fp16_t* w) {
+    for (uint32_t k = 0; k < wl.k; ++k) {
+        double x = wl.act_sigma * fp16_gaussian(g);
+        if (wl.act_relu && x < 0) x = 0;
+        act[k] = (fp16_t)fp16_oracle_round<FP16_ROUND_RNE>(x);
+        w[k] = (fp16_t)fp16_oracle_round<FP16_ROUND_RNE>(wl.w_sigma * fp16_gaussian(g));
+    }
+}
+
+// Operands of an M x K by K x N layer: A (M x K, row-major) takes the
+// activations and W (K x N, row-major) the weights of the workload with
+// dot length K. Row m of A and column n of W each draw from their own
+// stream (fp16_rng_chunk_seed), so the operands are identical for any
+// thread count.
+inline void fp16_workload_gemm_operands(Fp16Pool& pool, const Fp16Workload& wl, uint64_t seed, size_t M,
+                                        size_t K, size_t N, std::vector<fp16_t>& A, std::vector<fp16_t>& W) {
+    A.resize(M * K);
+    W.resize(K * N);
+    Fp16Workload wk = wl;
+    wk.k = (uint32_t)K;
+    pool.parallel_for(0, M + N, 1, [&](uint64_t lo, uint64_t hi, unsigned) {
+        std::vector<fp16_t> act(K), w(K);
+        for (uint64_t r = lo; r < hi; ++r) {
+            Xoshiro256 g(fp16_rng_chunk_seed(seed ^ fp16_mix64(r < M ? 1 : 2), r < M ? r : r - M));
+            fp16_workload_fill(wk, g, act.data(), w.data());
+            if (r < M) {
+                for (size_t k = 0; k < K; ++k) A[r * K + k] = act[k];
+            } else {
+                for (size_t k = 0; k < K; ++k) W[k * N + (r - M)] = w[k];
+            }
+        }
+    });
+}
+
+// Exact dot product of k FP16 pairs: every product is exact in double and
+// the sum is accurate well beyond FP16 / FP32 for the workload lengths.
+inline double fp16_workload_exact_dot(const fp16_t* a, const fp16_t* w, uint64_t k) {
+    double exact = 0;
+    for (uint64_t j = 0; j < k; ++j) exact += fp16_oracle_to_double(a[j]) * fp16_oracle_to_double(w[j]);
+    return exact;
+}
+
+// Error of results against the exact dot products: relative error over
+// non-zero exact results, |ULP| in FP16 ULPs at the exact result (2^-24
+// below the normal range) and, for FP16 results, the share equal to the
+// correctly rounded RNE result. +0 and -0 count as the same result there:
+// a zero sum's sign depends on the order of the signed zero products.
+struct Fp16WorkloadScore {
+    uint64_t outputs = 0, rel_count = 0, cr = 0;
+    double sum_rel = 0, max_rel = 0, sum_ulp = 0;
+
+    void merge(const Fp16WorkloadScore& o) {
+        outputs += o.outputs; rel_count += o.rel_count; cr += o.cr;
+        sum_rel += o.sum_rel; sum_ulp += o.sum_ulp;
+        if (o.max_rel > max_rel) max_rel = o.max_rel;
+    }
+    double mean_rel() const { return rel_count ? sum_rel / rel_count : 0.0; }
+    double mean_ulp() const { return outputs ? sum_ulp / outputs : 0.0; }
+    double cr_percent() const { return outputs ? 100.0 * cr / outputs : 0.0; }
+};
+
+// Scores a result of value h (FP16 or wider) against exact.
+inline void fp16_workload_score_value(Fp16WorkloadScore& s, double h, double exact) {
+    s.outputs++;
+    if (!std::isfinite(h) || !std::isfinite(exact)) return;
+    int e = exact == 0 ? -14 : std::ilogb(exact);
+    if (e < -14) e = -14;
+    s.sum_ulp += std::fabs(std::ldexp(h - exact, 10 - e));
+    if (exact != 0) {
+        double rel = std::fabs((h - exact) / exact);
+        s.rel_count++;
+        s.sum_rel += rel;
+        if (rel > s.max_rel) s.max_rel = rel;
+    }
+}
+
+// Scores an FP16 result, including the correctly-rounded check.
+inline void fp16_workload_score(Fp16WorkloadScore& s, fp16_t out, double exact) {
+    fp16_t cr = (fp16_t)fp16_oracle_round<FP16_ROUND_RNE>(exact);
+    s.cr += out == cr || ((out | cr) & 0x7FFF) == 0;
+    fp16_workload_score_value(s, fp16_oracle_to_double(out), exact);
+}
+
+#endif // FP16_WORKLOAD_H
@@ -0,0 +1,190 @@
+#ifndef FPADDER_COV_H
+#define FPADDER_COV_H
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#include "fpadder_rtl.h"
+
+// ----------------------------------------------------------------------------
+// Functional Coverage Model for fpadder.v
+// ----------------------------------------------------------------------------
+// Coverage points (RTL signal names):
+//   ex_diff   : 0..31
+//   shift_am  : 0..10
+//   sameSign  : 0/1
+//   sum_carry : 0/1
+// Every sample increments one bin of the full cross
+//   key = {ex_diff[4:0], sameSign, sum_carry, shift_am[3:0]}  (11 bits)
+// stored as a dense count array. Marginals and partial crosses are derived
+// from it at report time, so sampling costs one increment per vector.
+
+enum { FPADDER_COV_BINS = 1 << 11 };
+
+inline uint32_t fpadder_cov_key(uint32_t ex_diff, uint32_t same_sign, uint32_t sum_carry,
+                                uint32_t shift_am) {
+    return (ex_diff << 6) | (same_sign << 5) | (sum_carry << 4) | shift_am;
+}
+
+inline uint32_t fpadder_cov_key(const FpadderSignals& s) {
+    return fpadder_cov_key(s.ex_diff, s.sameSign, s.sum_carry, s.shift_am);
+}
+
+// Branch-free computation of the coverage key for a batch of operand pairs.
+// Only the signals feeding the coverage points are evaluated; they match
+// fpadder_rtl_eval() bit for bit.
+inline void fpadder_cov_keys(const fp16_t* __restrict a, const fp16_t* __restrict b,
+                             uint16_t* __restrict keys, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t n1 = a[i], n2 = b[i];
+        uint32_t m1 = n1 & 0x7FFF, m2 = n2 & 0x7FFF;
+        uint32_t pick1 = m1 >= m2; // {e, f} compare == e1 > e2 | (e1 == e2 & f1 >= f2)
+        uint32_t big = fp16_sel(pick1, m1, m2);
+        uint32_t sml = fp16_sel(pick1, m2, m1);
+
+        uint32_t big_e = big >> 10, sml_e = sml >> 10;
+        uint32_t big_float   = (big & 0x3FF) | ((big_e != 0) << 10);
+        uint32_t small_float = (sml & 0x3FF) | ((sml_e != 0) << 10);
+        uint32_t ex_diff  = (big_e | (big_e == 0)) - (sml_e | (sml_e == 0));
+        uint32_t sameSign = ((n1 ^ n2) >> 15) ^ 1;
+
+        uint32_t ssf     = fp16_sel(sameSign, small_float, (0u - small_float) & 0x7FF);
+        uint32_t full    = big_float + (ssf >> ex_diff);
+        uint32_t carry   = (full >> 11) & 1;
+        uint32_t sum     = full & 0x7FF;
+
+        uint32_t x  = sum << 5;
+        uint32_t lz = 0;
+        uint32_t c;
+        c = x < 0x0100; lz += c << 3; x = fp16_sel(c, x << 8, x);
+        c = x < 0x1000; lz += c << 2; x = fp16_sel(c, x << 4, x);
+        c = x < 0x4000; lz += c << 1; x = fp16_sel(c, x << 2, x);
+        c = x < 0x8000; lz += c;
+        uint32_t shift_am = fp16_sel(lz > 10, 10, lz);
+
+        keys[i] = (uint16_t)fpadder_cov_key(ex_diff, sameSign, carry, shift_am);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Reachability
+// ----------------------------------------------------------------------------
+// Derived from the datapath and confirmed by an exhaustive 2^32 sweep
+// (fpadder_cov --exhaustive). 214 of the 2048 cross bins are reachable:
+//   - shift_am > 10 is not an encoding of the casex; ex_diff == 31 needs
+//     sml_ex == 0, which the denormal adjust (+1 for e == 0) rules out
+//   - ex_diff == 0: every (sameSign, sum_carry, shift_am) combination
+//   - ex_diff >= 1, no carry: big_ex > 1 so big_float has its hidden bit
+//     and sum >= 1024, i.e. shift_am == 0
+//   - ex_diff >= 1, carry: shifted_small_float < 2^(11 - ex_diff) (zero
+//     filled, also for the negated operand), so sum < 2^(11 - ex_diff) and
+//     shift_am >= ex_diff; no carry at all once ex_diff >= 11
+// sameSign does not constrain any bin: the alignment shifter zero-fills the
+// two's complement of the small operand, so different-sign additions carry
+// like same-sign ones.
+inline bool fpadder_cov_bin_reachable(uint32_t key) {
+    uint32_t ex_diff = key >> 6, carry = (key >> 4) & 1, shift_am = key & 15;
+    if (shift_am > 10 || ex_diff == 31) return false;
+    if (ex_diff == 0) return true;
+    if (!carry) return shift_am == 0;
+    return ex_diff <= 10 && shift_am >= ex_diff;
+}
+
+struct FpadderCoverage {
+    uint64_t cross[FPADDER_COV_BINS];
+
+    FpadderCoverage() { clear(); }
+    void clear() { std::memset(cross, 0, sizeof(cross)); }
+
+    void sample(fp16_t num1, fp16_t num2) { cross[fpadder_cov_key(fpadder_rtl_eval(num1, num2))]++; }
+
+    void sample_batch(const fp16_t* a, const fp16_t* b, size_t n) {
+        uint16_t keys[4096];
+        for (size_t off = 0; off < n; off += 4096) {
+            size_t m = (n - off < 4096) ? n - off : 4096;
+            fpadder_cov_keys(a + off, b + off, keys, m);
+            for (size_t i = 0; i < m; ++i) cross[keys[i]]++;
+        }
+    }
+
+    void merge(const FpadderCoverage& o) {
+        for (int k = 0; k < FPADDER_COV_BINS; ++k) cross[k] += o.cross[k];
+    }
+
+    uint64_t total() const {
+        uint64_t t = 0;
+        for (int k = 0; k < FPADDER_COV_BINS; ++k) t += cross[k];
+        return t;
+    }
+
+    // Number of reachable bins of the full cross that have been hit.
+    void cross_hits(uint32_t& hit, uint32_t& reachable) const {
+        hit = reachable = 0;
+        for (uint32_t k = 0; k < FPADDER_COV_BINS; ++k) {
+            if (!fpadder_cov_bin_reachable(k)) continue;
+            reachable++;
+            if (cross[k]) hit++;
+        }
+    }
+
+    void report(std::ostream& os, int max_holes = 64) const;
+};
+
+inline void FpadderCoverage::report(std::ostream& os, int max_holes) const {
+    uint64_t ex[32] = {0}, sa[16] = {0}, sc[2][2] = {{0}}, exsc[32][2][2] = {{{0}}};
+    for (uint32_t k = 0; k < FPADDER_COV_BINS; ++k) {
+        uint32_t e = k >> 6, s = (k >> 5) & 1, c = (k >> 4) & 1, h = k & 15;
+        ex[e] += cross[k]; sa[h] += cross[k]; sc[s][c] += cross[k]; exsc[e][s][c] += cross[k];
+    }
+
+    std::ios saved(nullptr);
+    saved.copyfmt(os);
+    os << std::dec << std::setfill(' ');
+
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os << " fpadder.v Functional Coverage (" << total() << " vectors)\n";
+    os << "--------------------------------------------------------------------------------------------------\n";
+    int hit = 0;
+    for (int e = 0; e < 31; ++e) hit += ex[e] != 0;
+    os << "  ex_diff            : " << std::setw(3) << hit << " / 31 bins\n";
+    hit = 0;
+    for (int h = 0; h <= 10; ++h) hit += sa[h] != 0;
+    os << "  shift_am           : " << std::setw(3) << hit << " / 11 bins\n";
+    hit = 0;
+    for (int s = 0; s < 2; ++s) for (int c = 0; c < 2; ++c) hit += sc[s][c] != 0;
+    os << "  sameSign x carry   : " << std::setw(3) << hit << " / 4 bins\n";
+    hit = 0;
+    int reach = 0;
+    for (int e = 0; e < 31; ++e) for (int s = 0; s < 2; ++s) for (int c = 0; c < 2; ++c) {
+        bool r = false;
+        for (uint32_t h = 0; h <= 10; ++h) r |= fpadder_cov_bin_reachable(fpadder_cov_key(e, s, c, h));
+        if (!r) continue;
+        reach++;
+        hit += exsc[e][s][c] != 0;
+    }
+    os << "  ex_diff x sign x c : " << std::setw(3) << hit << " / " << reach << " bins\n";
+    uint32_t xh, xr;
+    cross_hits(xh, xr);
+    os << "  full cross         : " << std::setw(3) << xh << " / " << xr << " bins ("
+       << std::fixed << std::setprecision(2) << 100.0 * xh / xr << " %)\n";
+
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os << " Holes (ex_diff, sameSign, sum_carry, shift_am)\n";
+    os << "--------------------------------------------------------------------------------------------------\n";
+    int shown = 0, holes = 0;
+    for (uint32_t k = 0; k < FPADDER_COV_BINS; ++k) {
+        if (!fpadder_cov_bin_reachable(k) || cross[k]) continue;
+        holes++;
+        if (shown++ >= max_holes) continue;
+        os << "  ex_diff=" << std::setw(2) << (k >> 6) << "  sameSign=" << ((k >> 5) & 1)
+           << "  sum_carry=" << ((k >> 4) & 1) << "  shift_am=" << std::setw(2) << (k & 15) << "\n";
+    }
+    if (holes > max_holes) os << "  ... " << holes - max_holes << " more\n";
+    if (holes == 0) os << "  (none)\n";
+    os << "--------------------------------------------------------------------------------------------------\n";
+    os.copyfmt(saved);
+}
+
+#endif // FPADDER_COV_H
@@ -0,0 +1,166 @@
+#ifndef FPADDER_RTL_H
+#define FPADDER_RTL_H
+
+#include "fp16_common.h"
+
+// ----------------------------------------------------------------------------
+// RTL-Structural Model of Vivado/source_1/new/fpadder.v
+// ----------------------------------------------------------------------------
+// Signal-for-signal translation of the combinational datapath in front of
+// the result_r pipeline register. Widths follow the Verilog declarations
+// (5-bit exponents wrap, 11-bit sum + carry). Where the RTL differs from
+// fp16_add_bittrue (e.g. result forced to 0xFFFF on overflow, zeroSmall
+// never set), this model follows the RTL.
+struct FpadderSignals {
+    // Align
+    uint8_t  big_s, sml_s;
+    uint8_t  big_ex, sml_ex;   // 5 bit
+    uint8_t  ex_diff;          // 5 bit, 0..31
+    uint8_t  sameSign;
+    uint16_t big_float;        // 11 bit {big_h, big_f}
+    uint16_t sign_small_float; // 11 bit
+    uint16_t shifted_small_float;
+    uint16_t small_extension;  // 10 bit
+    // Add
+    uint8_t  sum_carry;
+    uint16_t sum;              // 11 bit
+    uint8_t  zeroSmall;
+    // Normalize
+    uint8_t  shift_am;         // 4 bit, 0..10
+    uint16_t sum_shifted;      // 10 bit
+    uint16_t sum_extension;    // 10 bit
+    uint8_t  neg_exp;
+    // Pack
+    uint8_t  res_exp;          // 5 bit
+    uint16_t res_frac;         // 10 bit
+    uint8_t  res_zero, res_overflow, res_nan, res_precisionLost;
+    uint16_t result;           // value latched into result_r
+};
+
+inline uint32_t rtl_mask(int bits) { return (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1); }
+
+inline FpadderSignals fpadder_rtl_eval(fp16_t num1, fp16_t num2) {
+    FpadderSignals s;
+
+    // Decode numbers
+    uint32_t s1 = (num1 >> 15) & 1, e1_raw = (num1 >> 10) & 0x1F, f1 = num1 & 0x3FF;
+    uint32_t s2 = (num2 >> 15) & 1, e2_raw = (num2 >> 10) & 0x1F, f2 = num2 & 0x3FF;
+
+    bool n1_is_inf = (e1_raw == 31) && f1 == 0;
+    bool n2_is_inf = (e2_raw == 31) && f2 == 0;
+    bool n1_is_nan = (e1_raw == 31) && f1 != 0;
+    bool n2_is_nan = (e2_raw == 31) && f2 != 0;
+    bool any_nan   = n1_is_nan || n2_is_nan;
+    bool any_inf   = n1_is_inf || n2_is_inf;
+
+    uint32_t h1 = e1_raw != 0;
+    uint32_t h2 = e2_raw != 0;
+
+    bool pick1_as_big = (e1_raw > e2_raw) || (e1_raw == e2_raw && f1 >= f2);
+
+    uint32_t big_s = pick1_as_big ? s1 : s2;
+    uint32_t big_e = pick1_as_big ? e1_raw : e2_raw;
+    uint32_t big_f = pick1_as_big ? f1 : f2;
+    uint32_t big_h = pick1_as_big ? h1 : h2;
+    uint32_t sml_s = pick1_as_big ? s2 : s1;
+    uint32_t sml_e = pick1_as_big ? e2_raw : e1_raw;
+    uint32_t sml_f = pick1_as_big ? f2 : f1;
+    uint32_t sml_h = pick1_as_big ? h2 : h1;
+
+    uint32_t big_ex  = (big_e + (big_e == 0)) & 0x1F;
+    uint32_t sml_ex  = (sml_e + (sml_e == 0)) & 0x1F;
+    uint32_t ex_diff = (big_ex - sml_ex) & 0x1F;
+
+    uint32_t big_float   = (big_h << 10) | big_f;
+    uint32_t small_float = (sml_h << 10) | sml_f;
+    uint32_t sameSign    = big_s == sml_s;
+
+    uint32_t sign_small_float = sameSign ? small_float : ((~small_float + 1) & 0x7FF);
+
+    // case (ex_diff): note 5'd1 places the lost bit at [9], 2..10 keep the
+    // lost bits right-aligned, default keeps sign_small_float[9:0].
+    uint32_t shifted_small_float, small_extension;
+    if (ex_diff == 0) {
+        shifted_small_float = sign_small_float; small_extension = 0;
+    } else if (ex_diff == 1) {
+        shifted_small_float = sign_small_float >> 1; small_extension = (sign_small_float & 1) << 9;
+    } else if (ex_diff <= 10) {
+        shifted_small_float = sign_small_float >> ex_diff;
+        small_extension = sign_small_float & rtl_mask(ex_diff);
+    } else {
+        shifted_small_float = 0; small_extension = sign_small_float & 0x3FF;
+    }
+
+    uint32_t full      = big_float + shifted_small_float;
+    uint32_t sum_carry = (full >> 11) & 1;
+    uint32_t sum       = full & 0x7FF;
+
+    uint32_t zeroSmall = (sml_ex == 0 && sml_f == 0);
+
+    // casex (sum): leading-zero count, default (sum < 2) -> 10
+    uint32_t shift_am = 10;
+    for (int k = 0; k < 10; ++k) {
+        if (sum & (0x400u >> k)) { shift_am = k; break; }
+    }
+
+    // sum_extension is assigned after it is read in the RTL always block;
+    // the settled combinational value is the one computed here first.
+    uint32_t sum_extension = (shift_am < 10) ? (small_extension & rtl_mask(10 - shift_am)) : 0;
+    uint32_t sum_shifted;
+    if (shift_am == 0) sum_shifted = sum & 0x3FF;
+    else if (shift_am < 10)
+        sum_shifted = (((sum & rtl_mask(10 - shift_am)) << shift_am) |
+                       (sum_extension >> (10 - shift_am))) & 0x3FF;
+    else sum_shifted = sum_extension;
+
+    uint32_t neg_exp = big_ex < shift_am;
+    uint32_t res_exp_same_s = (big_ex + ((!zeroSmall) & sum_carry & sameSign) - ((sum >> 10) == 0)) & 0x1F;
+    uint32_t res_exp_diff_s = (neg_exp || shift_am == 10) ? 0 : ((big_ex - shift_am) & 0x1F);
+
+    uint32_t res_exp  = sameSign ? res_exp_same_s : res_exp_diff_s;
+    uint32_t res_frac = zeroSmall ? big_f
+                      : (sameSign ? (sum_carry ? (sum >> 1) : (sum & 0x3FF))
+                                  : (neg_exp ? 0 : sum_shifted));
+    res_frac &= 0x3FF;
+
+    uint32_t res_zero     = ((num1 & 0x7FFF) == (num2 & 0x7FFF)) && (s1 != s2);
+    uint32_t res_overflow = (big_ex == 30 && sum_carry && sameSign) || any_inf;
+    uint32_t res_nan      = any_nan || (n1_is_inf && n2_is_inf && (s1 ^ s2));
+
+    uint32_t res_precisionLost = (shift_am < 10) ? ((sum_extension & rtl_mask(10 - shift_am)) != 0) : 0;
+
+    s.big_s = big_s; s.sml_s = sml_s;
+    s.big_ex = big_ex; s.sml_ex = sml_ex; s.ex_diff = ex_diff;
+    s.sameSign = sameSign;
+    s.big_float = big_float;
+    s.sign_small_float = sign_small_float;
+    s.shifted_small_float = shifted_small_float;
+    s.small_extension = small_extension;
+    s.sum_carry = sum_carry; s.sum = sum; s.zeroSmall = zeroSmall;
+    s.shift_am = shift_am; s.sum_shifted = sum_shifted; s.sum_extension = sum_extension;
+    s.neg_exp = neg_exp;
+    s.res_exp = res_exp; s.res_frac = res_frac;
+    s.res_zero = res_zero; s.res_overflow = res_overflow; s.res_nan = res_nan;
+    s.res_precisionLost = res_precisionLost;
+    s.result = (uint16_t)(((big_s << 15) | (res_exp << 10) | res_frac) | (res_overflow ? 0xFFFF : 0));
+    return s;
+}
+
+// Output-port view of the RTL (result, overflow, zero, NaN, precisionLost).
+inline BitTrueResult fpadder_rtl(fp16_t num1, fp16_t num2) {
+    FpadderSignals s = fpadder_rtl_eval(num1, num2);
+    BitTrueResult r = {s.result, s.res_overflow != 0, s.res_zero != 0, s.res_nan != 0,
+                       s.res_precisionLost != 0, false};
+    return r;
+}
+
+// Batch form with the fp16_add_batch signature.
+inline void fpadder_rtl_batch(const fp16_t* a, const fp16_t* b, fp16_t* res, uint8_t* flags, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        BitTrueResult r = fpadder_rtl(a[i], b[i]);
+        res[i] = r.res;
+        flags[i] = pack_flags(r);
+    }
+}
+
+#endif // FPADDER_RTL_H
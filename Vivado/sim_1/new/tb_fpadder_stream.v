@@ -0,0 +1,196 @@
+`timescale 1ns / 1ps
+
+// ----------------------------------------------------------------------------
+// File-driven regression for fpadder.v
+// ----------------------------------------------------------------------------
+// Streams stimulus and expected-result files written by
+// Reference/Using_CPP/fp16_vecgen into fpadder back to back (one vector per
+// clock) and checks every result and flag as valid_out returns. Files are
+// read sequentially with $fscanf / $fread, so vector sets of any size run
+// without loading them into memory.
+//
+// Plusargs:
+//   +STIM=<file>   stimulus file (default fpadder_0.stim.hex)
+//   +EXP=<file>    expected file (default fpadder_0.exp.hex)
+//   +BIN           files are binary (fp16_vecgen --format bin)
+//   +MAXERR=<n>    number of failures printed in detail (default 20)
+//
+// Generate a matching set with:
+//   fp16_vecgen --out fpadder --vectors 1000000 --model rtl
+module tb_fpadder_stream;
+  // Clock and reset signals
+  reg clk, rstn;
+
+  // DUT signals
+  reg [15:0] num1, num2;
+  reg valid_in;
+  wire [15:0] result;
+  wire valid_out, overflow, zero, NaN, precisionLost;
+
+  fpadder uut(
+    .clk(clk),
+    .rstn(rstn),
+    .valid_in(valid_in),
+    .num1(num1),
+    .num2(num2),
+    .valid_out(valid_out),
+    .result(result),
+    .overflow(overflow),
+    .zero(zero),
+    .NaN(NaN),
+    .precisionLost(precisionLost)
+  );
+
+  // Clock generation
+  initial begin
+    clk = 0;
+    forever #5 clk = ~clk; // 100MHz clock
+  end
+
+  // File handles and counters
+  reg [1023:0] stim_file, exp_file;
+  integer fd_stim, fd_exp, code;
+  integer max_err;
+  reg     bin_mode;
+  reg     stim_done;
+  reg [63:0] issued, checked, errors;
+
+  reg [31:0] word;
+  reg [15:0] exp_res;
+  reg [7:0]  exp_flags;
+  wire [3:0] got_flags = {precisionLost, NaN, zero, overflow};
+
+  // --------------------------------------------------------------------------
+  // Task: next_stim
+  // Description: Read the next (a, b) pair; sets stim_done at end of file.
+  // --------------------------------------------------------------------------
+  task next_stim;
+    begin
+      if (bin_mode) begin
+        code = $fread(word, fd_stim);
+        if (code == 4) begin
+          // Little-endian bytes a[7:0] a[15:8] b[7:0] b[15:8]
+          num1 = {word[23:16], word[31:24]};
+          num2 = {word[7:0], word[15:8]};
+        end else begin
+          stim_done = 1;
+        end
+      end else begin
+        code = $fscanf(fd_stim, "%h\n", word);
+        if (code == 1) begin
+          num1 = word[31:16];
+          num2 = word[15:0];
+        end else begin
+          stim_done = 1;
+        end
+      end
+    end
+  endtask
+
+  // --------------------------------------------------------------------------
+  // Task: next_exp
+  // Description: Read the next expected {flags, result} record.
+  // --------------------------------------------------------------------------
+  task next_exp;
+    begin
+      if (bin_mode) begin
+        code = $fread(word, fd_exp);
+        // Little-endian bytes res[7:0] res[15:8] flags 0
+        exp_res   = {word[23:16], word[31:24]};
+        exp_flags = word[15:8];
+        if (code != 4) code = 0;
+      end else begin
+        code = $fscanf(fd_exp, "%h\n", word);
+        exp_res   = word[15:0];
+        exp_flags = word[23:16];
+        if (code != 1) code = 0;
+      end
+    end
+  endtask
+
+  // --------------------------------------------------------------------------
+  // Main Test Sequence
+  // --------------------------------------------------------------------------
+  initial begin
+    if (!$value$plusargs("STIM=%s", stim_file)) stim_file = "fpadder_0.stim.hex";
+    if (!$value$plusargs("EXP=%s", exp_file))   exp_file  = "fpadder_0.exp.hex";
+    if (!$value$plusargs("MAXERR=%d", max_err)) max_err   = 20;
+    bin_mode = $test$plusargs("BIN");
+
+    if (bin_mode) begin
+      fd_stim = $fopen(stim_file, "rb");
+      fd_exp  = $fopen(exp_file, "rb");
+    end else begin
+      fd_stim = $fopen(stim_file, "r");
+      fd_exp  = $fopen(exp_file, "r");
+    end
+    if (fd_stim == 0 || fd_exp == 0) begin
+      $display("[FAIL] Cannot open %0s / %0s", stim_file, exp_file);
+      $finish;
+    end
+
+    // Initialize
+    rstn = 0;
+    valid_in = 0;
+    num1 = 0;
+    num2 = 0;
+    stim_done = 0;
+    issued = 0;
+    checked = 0;
+    errors = 0;
+
+    // Reset sequence
+    #50 rstn = 1;
+    #50;
+
+    $display("");
+    $display("================================================================");
+    $display(" Starting Simulation: tb_fpadder_stream (%0s)", stim_file);
+    $display("================================================================");
+
+    // Issue one vector per clock until the stimulus file ends
+    while (!stim_done) begin
+      @(negedge clk);
+      next_stim;
+      valid_in = !stim_done;
+      if (!stim_done) issued = issued + 1;
+    end
+    @(negedge clk);
+    valid_in = 0;
+
+    // Drain the pipeline
+    repeat (10) @(posedge clk);
+
+    $display("================================================================");
+    $display(" Vectors: %0d issued, %0d checked, %0d failed", issued, checked, errors);
+    if (checked != issued)
+      $display("[FAIL] %0d results missing", issued - checked);
+    else if (errors == 0)
+      $display("[PASS] All results match the reference");
+    $display("================================================================");
+    $fclose(fd_stim);
+    $fclose(fd_exp);
+    $finish;
+  end
+
+  // --------------------------------------------------------------------------
+  // Checker: compare every valid_out against the next expected record
+  // --------------------------------------------------------------------------
+  always @(posedge clk) begin
+    if (rstn && valid_out) begin
+      next_exp;
+      if (code == 0) begin
+        errors = errors + 1;
+        if (errors <= max_err)
+          $display("[FAIL] Vector %0d: expected file ended early", checked);
+      end else if (result !== exp_res || got_flags !== exp_flags[3:0]) begin
+        errors = errors + 1;
+        if (errors <= max_err)
+          $display("[FAIL] Vector %0d: result %h flags OF:%b Z:%b NaN:%b PL:%b (Expected: %h, flags %h)",
+                   checked, result, overflow, zero, NaN, precisionLost, exp_res, exp_flags);
+      end
+      checked = checked + 1;
+    end
+  end
+
+endmodule